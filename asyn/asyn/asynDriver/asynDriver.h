@@ -111,6 +111,37 @@ typedef struct interruptNode{
     void    *drvPvt;
 }interruptNode;
 
+/* Port statistics returned by asynManager->getPortStatistics.
+ * All times are in seconds.  Histogram bin i counts samples shorter than
+ * 2**i microseconds; the last bin also counts everything longer.
+ */
+#define ASYN_STATISTICS_BINS 24
+typedef struct asynHistogram {
+    unsigned long count;
+    double        sum;
+    double        max;
+    unsigned long bins[ASYN_STATISTICS_BINS];
+}asynHistogram;
+
+typedef struct asynPoolStatistics {
+    unsigned long allocated; /* objects allocated from the heap */
+    unsigned long free;      /* objects on the free list */
+    unsigned long gets;      /* objects handed out by the pool */
+    unsigned long contended; /* times the pool lock was already held */
+}asynPoolStatistics;
+
+typedef struct asynPortStatistics {
+    epicsTimeStamp startTime;    /* when the statistics were last reset */
+    double         elapsed;      /* seconds since startTime */
+    double         busyFraction; /* fraction of elapsed the port was locked */
+    asynHistogram  queueWait[asynQueuePriorityConnect + 1];
+    asynHistogram  service[asynQueuePriorityConnect + 1];
+    asynHistogram  lockHold;
+    /* The pools are never reset */
+    asynPoolStatistics userPool;          /* duplicateAsynUser */
+    asynPoolStatistics interruptNodePool; /* createInterruptNode */
+}asynPortStatistics;
+
 typedef struct asynManager {
     void      (*report)(FILE *fp,int details,const char*portName);
     asynUser  *(*createAsynUser)(userCallback process,userCallback timeout);
@@ -183,6 +214,11 @@ typedef struct asynManager {
     asynStatus (*setTimeStamp)(asynUser *pasynUser, const epicsTimeStamp *pTimeStamp);
 
     const char *(*strStatus)(asynStatus status);
+    /* Queue latency and port utilisation statistics */
+    asynStatus (*getPortStatistics)(asynUser *pasynUser,
+                                    asynPortStatistics *pstatistics);
+    asynStatus (*resetPortStatistics)(asynUser *pasynUser);
+    void       (*reportStatistics)(FILE *fp,int details,const char *portName);
 }asynManager;
 epicsShareExtern asynManager *pasynManager;
 
@@ -217,6 +253,7 @@ typedef struct  asynLockPortNotify {
 #define ASYN_TRACEIO_ASCII  0x0001
 #define ASYN_TRACEIO_ESCAPE 0x0002
 #define ASYN_TRACEIO_HEX    0x0004
+#define ASYN_TRACEIO_BINARY 0x0008 /* record into the port trace ring, see dumpTraceBuffer */
 
 /* traceInfo mask definitions*/
 #define ASYN_TRACEINFO_TIME 0x0001
@@ -272,6 +309,7 @@ typedef struct asynTrace {
     int        (*vprintIOSource)(asynUser *pasynUser,int reason,
                     const char *buffer, size_t len,const char *file, int line, const char *pformat, va_list pvar) EPICS_PRINTF_STYLE(7,0);
 #endif
+    asynStatus (*dumpTraceBuffer)(asynUser *pasynUser,FILE *fp,size_t maxRecords);
 }asynTrace;
 epicsShareExtern asynTrace *pasynTrace;
 
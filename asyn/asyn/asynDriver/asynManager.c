@@ -29,6 +29,7 @@
 #include <epicsTimer.h>
 #include <cantProceed.h>
 #include <epicsAssert.h>
+#include <epicsAtomic.h>
 
 #include <epicsExport.h>
 #include "asynDriver.h"
@@ -45,8 +46,14 @@
 #define DEFAULT_TRACE_TRUNCATE_SIZE 80
 #define DEFAULT_TRACE_BUFFER_SIZE 80
 #define DEFAULT_SECONDS_BETWEEN_PORT_CONNECT 20
+#define MIN_SECONDS_BETWEEN_PORT_CONNECT 0.5
 #define DEFAULT_AUTOCONNECT_TIMEOUT 0.5
 #define DEFAULT_QUEUE_LOCK_PORT_TIMEOUT 2.0
+#define NUMBER_USER_POOLS 8
+#define TRACE_RING_SIZE 262144
+#define TRACE_RING_ALIGN 8
+#define TRACE_RING_MESSAGE_SIZE 80
+#define POOL_SLAB_SIZE 8
 
 /* This is taken from dbDefs.h, which we don't want to include */
 /* Subtract member byte offset, returning pointer to parent object */
@@ -95,10 +102,47 @@ typedef struct memNode {
  */
 #define NODESIZE (((sizeof(memNode)+15)/16)*16)
 
+/*
+ * Free lists for asynUsers and interruptNodes. Each pool has its own lock.
+ * Objects are allocated POOL_SLAB_SIZE at a time and always return to the
+ * pool they were allocated from.
+ */
+typedef struct objectPool {
+    epicsMutexId  lock;
+    ELLLIST       freeList;
+    unsigned long allocated;
+    unsigned long gets;
+    unsigned long contended;
+}objectPool;
+
+/*
+ * Ring of binary trace records, used when traceIOMask has ASYN_TRACEIO_BINARY.
+ * Writers reserve space by atomically advancing next and never block.
+ * A record is valid if its position field equals its offset in the stream
+ * plus one, and it has not been overrun by later reservations.
+ */
+typedef struct traceRing {
+    size_t        size;   /*power of 2*/
+    size_t        next;   /*total bytes ever reserved*/
+    size_t        written;
+    char          *buffer;
+}traceRing;
+
+typedef struct traceRecord {
+    size_t         position; /*stream offset + 1, stored last*/
+    epicsTimeStamp time;
+    epicsUInt32    length;   /*total record length including this header*/
+    epicsInt32     addr;
+    epicsInt32     reason;   /*asynUser.reason*/
+    epicsInt32     traceType;/*ASYN_TRACEIO_DEVICE, ...*/
+    epicsUInt32    messageLength;
+    epicsUInt32    nBytes;
+}traceRecord;
+
 typedef struct asynBase {
     ELLLIST           asynPortList;
-    ELLLIST           asynUserFreeList;
-    ELLLIST           interruptNodeFree;
+    /* createAsynUser uses the pool selected by the calling thread */
+    objectPool        userPool[NUMBER_USER_POOLS];
     epicsTimerQueueId timerQueue;
     epicsMutexId      lock;
     epicsMutexId      lockTrace;
@@ -177,6 +221,8 @@ struct userPvt {
     exceptionUser *pexceptionUser;
     BOOL          freeAfterCallback;
     BOOL          isQueued;
+    epicsTimeStamp queueTime;  /*when queueRequest was called*/
+    objectPool    *ppool;      /*pool to return to by freeAsynUser*/
     asynUser      user;
 };
 
@@ -205,6 +251,8 @@ struct port {
     /* The following are for autoConnect*/
     asynUser      *pasynUser;
     double        secondsBetweenPortConnect;
+    double        secondsBeforeNextPortConnect;
+    unsigned int  connectJitterSeed;
     portConnectStatus previousConnectStatus;
     /* The following are for asynLockPortNotify */
     asynLockPortNotify *pasynLockPortNotify;
@@ -225,6 +273,16 @@ struct port {
     epicsTimeStamp timeStamp;
     timeStampCallback timeStampSource;
     void          *timeStampPvt;
+    /* The following are for port statistics */
+    epicsMutexId  statisticsLock;
+    asynPortStatistics statistics;
+    int           lockHoldDepth;  /*only changed while synchronousLock held*/
+    epicsTimeStamp lockHoldStart;
+    /* The following are for duplicateAsynUser and createInterruptNode */
+    objectPool    userPool;
+    objectPool    interruptNodePool;
+    /* The following is for ASYN_TRACEIO_BINARY */
+    traceRing     *ptraceRing;
 };
 
 typedef struct queueLockPortPvt {
@@ -262,6 +320,20 @@ static void queueTimeoutCallback(void *pvt);
 static BOOL autoConnectDevice(port *pport,device *pdevice);
 static void connectAttempt(dpCommon *pdpCommon);
 static void portThread(port *pport);
+/* functions for port statistics */
+static void statisticsAdd(port *pport,asynHistogram *phistogram,double seconds);
+static void synchronousLockAcquire(port *pport);
+static void synchronousLockRelease(port *pport);
+/* functions for object pools */
+static void poolInit(objectPool *ppool);
+static void poolLock(objectPool *ppool);
+static void poolStatistics(objectPool *ppool,asynPoolStatistics *pstatistics);
+static userPvt *userPoolGet(objectPool *ppool);
+static void userPoolPut(userPvt *puserPvt);
+/* functions for the binary trace ring */
+static traceRing *traceRingCreate(size_t size);
+static int traceRingWrite(traceRing *pring,asynUser *pasynUser,int reason,
+    const char *buffer,size_t nBytes,const char *pformat,va_list pvar);
 /* functions for portConnect */
 static void initPortConnect(port *ppport);
 static void portConnectTimerCallback(void *pvt);
@@ -333,6 +405,10 @@ static asynStatus updateTimeStamp(asynUser *pasynUser);
 static asynStatus getTimeStamp(asynUser *pasynUser, epicsTimeStamp *pTimeStamp);
 static asynStatus setTimeStamp(asynUser *pasynUser, const epicsTimeStamp *pTimeStamp);
 static const char *strStatus(asynStatus status);
+static asynStatus getPortStatistics(asynUser *pasynUser,
+    asynPortStatistics *pstatistics);
+static asynStatus resetPortStatistics(asynUser *pasynUser);
+static void reportStatistics(FILE *fp,int details,const char *portName);
 
 static asynManager manager = {
     report,
@@ -384,7 +460,10 @@ static asynManager manager = {
     updateTimeStamp,
     getTimeStamp,
     setTimeStamp,
-    strStatus
+    strStatus,
+    getPortStatistics,
+    resetPortStatistics,
+    reportStatistics
 };
 epicsShareDef asynManager *pasynManager = &manager;
 
@@ -417,6 +496,7 @@ static int        traceVprintIO(asynUser *pasynUser,int reason,
                       const char *buffer, size_t len,const char *pformat, va_list pvar);
 static int        traceVprintIOSource(asynUser *pasynUser,int reason,
                       const char *buffer, size_t len, const char *file, int line, const char *pformat, va_list pvar);
+static asynStatus dumpTraceBuffer(asynUser *pasynUser,FILE *fp,size_t maxRecords);
 static asynTrace asynTraceManager = {
     traceLock,
     traceUnlock,
@@ -437,7 +517,8 @@ static asynTrace asynTraceManager = {
     tracePrintIO,
     tracePrintIOSource,
     traceVprintIO,
-    traceVprintIOSource
+    traceVprintIOSource,
+    dumpTraceBuffer
 };
 epicsShareDef asynTrace *pasynTrace = &asynTraceManager;
 
@@ -490,8 +571,7 @@ static void asynInit(void)
     if(pasynBase) return;
     pasynBase = callocMustSucceed(1,sizeof(asynBase),"asynInit");
     ellInit(&pasynBase->asynPortList);
-    ellInit(&pasynBase->asynUserFreeList);
-    ellInit(&pasynBase->interruptNodeFree);
+    for(i=0; i<NUMBER_USER_POOLS; i++) poolInit(&pasynBase->userPool[i]);
     pasynBase->timerQueue = epicsTimerQueueAllocate(
         1,epicsThreadPriorityScanLow);
     pasynBase->lock = epicsMutexMustCreate();
@@ -686,9 +766,7 @@ static void queueTimeoutCallback(void *pvt)
         puserPvt->state = callbackIdle;
         if(puserPvt->freeAfterCallback) {
             puserPvt->freeAfterCallback = FALSE;
-            epicsMutexMustLock(pasynBase->lock);
-            ellAdd(&pasynBase->asynUserFreeList,&puserPvt->node);
-            epicsMutexUnlock(pasynBase->lock);
+            userPoolPut(puserPvt);
         }
     }
     epicsMutexUnlock(pport->asynManagerLock);
@@ -766,9 +844,9 @@ static void connectAttempt(dpCommon *pdpCommon)
     pasynUser->errorMessage[0] = '\0';
     /* When we were called we were not connected, but we could have connected since that test? */
     if (!pdpCommon->connected) {
-        epicsMutexMustLock(pport->synchronousLock);
+        synchronousLockAcquire(pport);
         status = pasynCommon->connect(drvPvt,pasynUser);
-        epicsMutexUnlock(pport->synchronousLock);
+        synchronousLockRelease(pport);
         if (status != asynSuccess) {
             reportConnectStatus(pport, portConnectDriver,
                 "%s %d autoConnect could not connect: %s\n", pport->portName, addr, pasynUser->errorMessage);
@@ -793,6 +871,7 @@ static void portThread(port *pport)
     asynUser *pasynUser;
     double   timeout;
     BOOL     callTimeoutUser = FALSE;
+    epicsTimeStamp startTime, endTime;
 
     taskwdInsert(epicsThreadGetIdSelf(),0,0);
     while(1) {
@@ -820,7 +899,7 @@ static void portThread(port *pport)
             timeout = puserPvt->timeout;
             epicsMutexUnlock(pport->asynManagerLock);
             if(puserPvt->timer && timeout>0.0) epicsTimerCancel(puserPvt->timer);
-            epicsMutexMustLock(pport->synchronousLock);
+            synchronousLockAcquire(pport);
             if(pport->pasynLockPortNotify) {
                 status = pport->pasynLockPortNotify->lock(
                    pport->lockPortNotifyPvt,pasynUser);
@@ -828,7 +907,15 @@ static void portThread(port *pport)
                         "%s queueCallback pasynLockPortNotify:lock error %s\n",
                          pport->portName,pasynUser->errorMessage);
             }
+            epicsTimeGetCurrent(&startTime);
+            statisticsAdd(pport,
+                &pport->statistics.queueWait[asynQueuePriorityConnect],
+                epicsTimeDiffInSeconds(&startTime,&puserPvt->queueTime));
             puserPvt->processUser(pasynUser);
+            epicsTimeGetCurrent(&endTime);
+            statisticsAdd(pport,
+                &pport->statistics.service[asynQueuePriorityConnect],
+                epicsTimeDiffInSeconds(&endTime,&startTime));
             if(pport->pasynLockPortNotify) {
                 status = pport->pasynLockPortNotify->unlock(
                    pport->lockPortNotifyPvt,pasynUser);
@@ -836,16 +923,14 @@ static void portThread(port *pport)
                         "%s queueCallback pasynLockPortNotify:lock error %s\n",
                          pport->portName,pasynUser->errorMessage);
             }
-            epicsMutexUnlock(pport->synchronousLock);
+            synchronousLockRelease(pport);
             epicsMutexMustLock(pport->asynManagerLock);
             if (puserPvt->state==callbackCanceled)
                 epicsEventSignal(puserPvt->callbackDone);
             puserPvt->state = callbackIdle;
             if(puserPvt->freeAfterCallback) {
                 puserPvt->freeAfterCallback = FALSE;
-                epicsMutexMustLock(pasynBase->lock);
-                ellAdd(&pasynBase->asynUserFreeList,&puserPvt->node);
-                epicsMutexUnlock(pasynBase->lock);
+                userPoolPut(puserPvt);
             }
         }
         if(!pport->dpc.connected) {
@@ -899,7 +984,7 @@ static void portThread(port *pport)
             timeout = puserPvt->timeout;
             epicsMutexUnlock(pport->asynManagerLock);
             if(puserPvt->timer && timeout>0.0) epicsTimerCancel(puserPvt->timer);
-            epicsMutexMustLock(pport->synchronousLock);
+            synchronousLockAcquire(pport);
             if(pport->pasynLockPortNotify) {
                 status = pport->pasynLockPortNotify->lock(
                    pport->lockPortNotifyPvt,pasynUser);
@@ -907,11 +992,17 @@ static void portThread(port *pport)
                         "%s queueCallback pasynLockPortNotify:lock error %s\n",
                          pport->portName,pasynUser->errorMessage);
             }
+            epicsTimeGetCurrent(&startTime);
+            statisticsAdd(pport,&pport->statistics.queueWait[i],
+                epicsTimeDiffInSeconds(&startTime,&puserPvt->queueTime));
             if(callTimeoutUser) {
                 puserPvt->timeoutUser(pasynUser);
             } else {
                 puserPvt->processUser(pasynUser);
             }
+            epicsTimeGetCurrent(&endTime);
+            statisticsAdd(pport,&pport->statistics.service[i],
+                epicsTimeDiffInSeconds(&endTime,&startTime));
             if(pport->pasynLockPortNotify) {
                 status = pport->pasynLockPortNotify->unlock(
                    pport->lockPortNotifyPvt,pasynUser);
@@ -919,7 +1010,7 @@ static void portThread(port *pport)
                         "%s queueCallback pasynLockPortNotify:lock error %s\n",
                          pport->portName,pasynUser->errorMessage);
             }
-            epicsMutexUnlock(pport->synchronousLock);
+            synchronousLockRelease(pport);
             epicsMutexMustLock(pport->asynManagerLock);
             if(puserPvt->blockPortCount>0)
                 pport->pblockProcessHolder = puserPvt;
@@ -930,9 +1021,7 @@ static void portThread(port *pport)
             puserPvt->state = callbackIdle;
             if(puserPvt->freeAfterCallback) {
                 puserPvt->freeAfterCallback = FALSE;
-                epicsMutexMustLock(pasynBase->lock);
-                ellAdd(&pasynBase->asynUserFreeList,&puserPvt->node);
-                epicsMutexUnlock(pasynBase->lock);
+                userPoolPut(puserPvt);
             }
             if(pport->queueStateChange) break;
         }
@@ -1160,30 +1249,11 @@ static void report(FILE *fp,int details,const char *portName)
     epicsEventDestroy(done);
 }
 
-static asynUser *createAsynUser(userCallback process, userCallback timeout)
+static asynUser *initAsynUser(userPvt *puserPvt,
+    userCallback process, userCallback timeout)
 {
-    userPvt  *puserPvt;
-    asynUser *pasynUser;
-    int      nbytes;
+    asynUser *pasynUser = userPvtToAsynUser(puserPvt);
 
-    if(!pasynBase) asynInit();
-    epicsMutexMustLock(pasynBase->lock);
-    puserPvt = (userPvt *)ellFirst(&pasynBase->asynUserFreeList);
-    if(!puserPvt) {
-        epicsMutexUnlock(pasynBase->lock);
-        nbytes = sizeof(userPvt) + ERROR_MESSAGE_SIZE + 1;
-        puserPvt = callocMustSucceed(1,nbytes,"asynCommon:registerDriver");
-        puserPvt->timer = epicsTimerQueueCreateTimer(
-            pasynBase->timerQueue,queueTimeoutCallback,puserPvt);
-        puserPvt->callbackDone = epicsEventMustCreate(epicsEventEmpty);
-        pasynUser = userPvtToAsynUser(puserPvt);
-        pasynUser->errorMessage = (char *)(puserPvt +1);
-        pasynUser->errorMessageSize = ERROR_MESSAGE_SIZE;
-    } else {
-        ellDelete(&pasynBase->asynUserFreeList,&puserPvt->node);
-        epicsMutexUnlock(pasynBase->lock);
-        pasynUser = userPvtToAsynUser(puserPvt);
-    }
     puserPvt->processUser = process;
     puserPvt->timeoutUser = timeout;
     puserPvt->timeout = 0.0;
@@ -1203,11 +1273,29 @@ static asynUser *createAsynUser(userCallback process, userCallback timeout)
     return pasynUser;
 }
 
+static asynUser *createAsynUser(userCallback process, userCallback timeout)
+{
+    size_t   thread = (size_t)epicsThreadGetIdSelf();
+    userPvt  *puserPvt;
+
+    if(!pasynBase) asynInit();
+    puserPvt = userPoolGet(
+        &pasynBase->userPool[(thread >> 4) % NUMBER_USER_POOLS]);
+    return initAsynUser(puserPvt,process,timeout);
+}
+
 static asynUser *duplicateAsynUser(asynUser *pasynUser,
    userCallback process, userCallback timeout)
 {
     userPvt *pold = asynUserToUserPvt(pasynUser);
-    userPvt *pnew = asynUserToUserPvt(createAsynUser(process,timeout));
+    userPvt *pnew;
+
+    if(!pold->pport) {
+        pnew = asynUserToUserPvt(createAsynUser(process,timeout));
+    } else {
+        pnew = userPoolGet(&pold->pport->userPool);
+        initAsynUser(pnew,process,timeout);
+    }
 
     pnew->pport = pold->pport;
     pnew->pdevice = pold->pdevice;
@@ -1232,13 +1320,13 @@ static asynStatus freeAsynUser(asynUser *pasynUser)
         status = disconnect(pasynUser);
         if(status!=asynSuccess) return asynError;
     }
-    epicsMutexMustLock(pasynBase->lock);
+    poolLock(puserPvt->ppool);
     if(puserPvt->state==callbackIdle) {
-        ellAdd(&pasynBase->asynUserFreeList,&puserPvt->node);
+        ellAdd(&puserPvt->ppool->freeList,&puserPvt->node);
     } else {
         puserPvt->freeAfterCallback = TRUE;
     }
-    epicsMutexUnlock(pasynBase->lock);
+    epicsMutexUnlock(puserPvt->ppool->lock);
     return asynSuccess;
 }
 
@@ -1519,6 +1607,7 @@ static asynStatus queueRequest(asynUser *pasynUser,
         device   *pdevice = puserPvt->pdevice;
         int      addr = (pdevice ? pdevice->addr : -1);
         dpCommon *pdpCommon;
+        epicsTimeStamp startTime, endTime;
 
         pdpCommon = findDpCommon(puserPvt);
         asynPrint(pasynUser,ASYN_TRACE_FLOW,"%s queueRequest synchronous\n",
@@ -1541,9 +1630,16 @@ static asynStatus queueRequest(asynUser *pasynUser,
             }
         }
         epicsMutexUnlock(pport->asynManagerLock);
-        epicsMutexMustLock(pport->synchronousLock);
+        epicsTimeGetCurrent(&puserPvt->queueTime);
+        synchronousLockAcquire(pport);
+        epicsTimeGetCurrent(&startTime);
+        statisticsAdd(pport,&pport->statistics.queueWait[priority],
+            epicsTimeDiffInSeconds(&startTime,&puserPvt->queueTime));
         puserPvt->processUser(pasynUser);
-        epicsMutexUnlock(pport->synchronousLock);
+        epicsTimeGetCurrent(&endTime);
+        statisticsAdd(pport,&pport->statistics.service[priority],
+            epicsTimeDiffInSeconds(&endTime,&startTime));
+        synchronousLockRelease(pport);
         return asynSuccess;
     }
     if(puserPvt->isQueued) {
@@ -1579,6 +1675,7 @@ static asynStatus queueRequest(asynUser *pasynUser,
     }
     pport->queueStateChange = TRUE;
     puserPvt->isQueued = TRUE;
+    epicsTimeGetCurrent(&puserPvt->queueTime);
     if(timeout<=0.0) {
         puserPvt->timeout = 0.0;
     } else {
@@ -1749,7 +1846,7 @@ static asynStatus lockPort(asynUser *pasynUser)
         return asynError;
     }
     asynPrint(pasynUser,ASYN_TRACE_FLOW,"%s lockPort\n", pport->portName);
-    epicsMutexMustLock(pport->synchronousLock);
+    synchronousLockAcquire(pport);
     if(pport->pasynLockPortNotify) {
         pport->pasynLockPortNotify->lock(
            pport->lockPortNotifyPvt,pasynUser);
@@ -1773,11 +1870,11 @@ static asynStatus unlockPort(asynUser *pasynUser)
         status = pport->pasynLockPortNotify->unlock(
            pport->lockPortNotifyPvt,pasynUser);
         if(status!=asynSuccess) {
-            epicsMutexUnlock(pport->synchronousLock);
+            synchronousLockRelease(pport);
             return status;
         }
     }
-    epicsMutexUnlock(pport->synchronousLock);
+    synchronousLockRelease(pport);
     return asynSuccess;
 }
 
@@ -1859,7 +1956,7 @@ static asynStatus queueLockPort(asynUser *pasynUser)
         plockPortPvt->queueLockPortCount++;
     } else {
         /* Synchronous driver */
-        epicsMutexMustLock(pport->synchronousLock);
+        synchronousLockAcquire(pport);
     }
     if(pport->pasynLockPortNotify) {
         status = pport->pasynLockPortNotify->lock(
@@ -1914,7 +2011,7 @@ static asynStatus queueUnlockPort(asynUser *pasynUser)
         plockPortPvt->queueLockPortCount--;
     } else {
         /* Synchronous driver */
-        epicsMutexUnlock(pport->synchronousLock);
+        synchronousLockRelease(pport);
     }
     return status;
 }
@@ -1984,6 +2081,10 @@ static asynStatus registerPort(const char *portName,
     pport->attributes = attributes;
     pport->asynManagerLock = epicsMutexMustCreate();
     pport->synchronousLock = epicsMutexMustCreate();
+    pport->statisticsLock = epicsMutexMustCreate();
+    poolInit(&pport->userPool);
+    poolInit(&pport->interruptNodePool);
+    epicsTimeGetCurrent(&pport->statistics.startTime);
     pport->queueLockPortId = epicsThreadPrivateCreate();
     pport->timeStampSource = defaultTimeStampSource;
     dpCommonInit(pport,0,autoConnect);
@@ -2007,6 +2108,7 @@ static asynStatus registerPort(const char *portName,
             epicsEventDestroy(pport->notifyPortThread);
             freeAsynUser(pport->pasynUser);
             dpCommonFree(&pport->dpc);
+            epicsMutexDestroy(pport->statisticsLock);
             epicsMutexDestroy(pport->synchronousLock);
             epicsMutexDestroy(pport->asynManagerLock);
             free(pport);
@@ -2099,6 +2201,7 @@ static asynStatus exceptionDisconnect(asynUser *pasynUser)
     }
     pdpCommon->connected = FALSE;
     if(!pport->dpc.connected && pport->dpc.autoConnect) {
+        pport->secondsBeforeNextPortConnect = MIN_SECONDS_BETWEEN_PORT_CONNECT;
         epicsTimerStartDelay(pport->connectTimer,.01);
     }
     epicsTimeGetCurrent(&pdpCommon->lastConnectDisconnect);
@@ -2321,25 +2424,33 @@ static asynStatus getInterruptPvt(asynUser *pasynUser,
 static interruptNode *createInterruptNode(void *pasynPvt)
 {
     interruptBase    *pinterruptBase = (interruptBase *)pasynPvt;
+    objectPool       *ppool = &pinterruptBase->pport->interruptNodePool;
     interruptNode    *pinterruptNode;
     interruptNodePvt *pinterruptNodePvt;
 
-    epicsMutexMustLock(pasynBase->lock);
-    pinterruptNode = (interruptNode *)ellFirst(&pasynBase->interruptNodeFree);
-    if(pinterruptNode) {
-        pinterruptNodePvt = interruptNodeToPvt(pinterruptNode);
-        ellDelete(&pasynBase->interruptNodeFree,&pinterruptNode->node);
-        epicsMutexUnlock(pasynBase->lock);
-        pinterruptNodePvt->isOnList = 0;
-        pinterruptNodePvt->isOnAddRemoveList = 0;
-        memset(&pinterruptNodePvt->nodePublic,0,sizeof(interruptNode));
-    } else {
-        epicsMutexUnlock(pasynBase->lock);
+    poolLock(ppool);
+    pinterruptNode = (interruptNode *)ellFirst(&ppool->freeList);
+    if(!pinterruptNode) {
+        int i;
+
         pinterruptNodePvt = (interruptNodePvt *)
-            callocMustSucceed(1,sizeof(interruptNodePvt),
+            callocMustSucceed(POOL_SLAB_SIZE,sizeof(interruptNodePvt),
                 "asynManager:createInterruptNode");
-        pinterruptNodePvt->callbackDone = epicsEventMustCreate(epicsEventEmpty);
-    }
+        for(i=0; i<POOL_SLAB_SIZE; i++) {
+            pinterruptNodePvt[i].callbackDone =
+                epicsEventMustCreate(epicsEventEmpty);
+            ellAdd(&ppool->freeList,&pinterruptNodePvt[i].nodePublic.node);
+        }
+        ppool->allocated += POOL_SLAB_SIZE;
+        pinterruptNode = (interruptNode *)ellFirst(&ppool->freeList);
+    }
+    ellDelete(&ppool->freeList,&pinterruptNode->node);
+    ppool->gets++;
+    epicsMutexUnlock(ppool->lock);
+    pinterruptNodePvt = interruptNodeToPvt(pinterruptNode);
+    pinterruptNodePvt->isOnList = 0;
+    pinterruptNodePvt->isOnAddRemoveList = 0;
+    memset(&pinterruptNodePvt->nodePublic,0,sizeof(interruptNode));
     pinterruptNodePvt->pinterruptBase = pinterruptBase;
     return(&pinterruptNodePvt->nodePublic);
 }
@@ -2358,9 +2469,9 @@ static asynStatus freeInterruptNode(asynUser *pasynUser,interruptNode *pinterrup
         return asynError;
     }
     epicsMutexUnlock(pport->asynManagerLock);
-    epicsMutexMustLock(pasynBase->lock);
-    ellAdd(&pasynBase->interruptNodeFree,&pinterruptNode->node);
-    epicsMutexUnlock(pasynBase->lock);
+    poolLock(&pport->interruptNodePool);
+    ellAdd(&pport->interruptNodePool.freeList,&pinterruptNode->node);
+    epicsMutexUnlock(pport->interruptNodePool.lock);
     return asynSuccess;
 }
 
@@ -2640,6 +2751,11 @@ static asynStatus setTraceIOMask(asynUser *pasynUser,int mask)
                 "asynManager:setTraceIOMask -- not connected to port.");
             return asynError;
         }
+        if((mask&ASYN_TRACEIO_BINARY) && !pport->ptraceRing) {
+            epicsMutexMustLock(pasynBase->lockTrace);
+            if(!pport->ptraceRing) pport->ptraceRing = traceRingCreate(TRACE_RING_SIZE);
+            epicsMutexUnlock(pasynBase->lockTrace);
+        }
         if(pdevice) {
             pdevice->dpc.trace.traceIOMask = mask;
             announceExceptionOccurred(pport, pdevice, asynExceptionTraceIOMask);
@@ -2944,6 +3060,12 @@ static int traceVprintIOSource(asynUser *pasynUser,int reason,
     traceIOMask = ptracePvt->traceIOMask;
     traceTruncateSize = ptracePvt->traceTruncateSize;
     if(!(reason&traceMask)) return 0;
+    if((traceIOMask&ASYN_TRACEIO_BINARY) && puserPvt->pport
+    && puserPvt->pport->ptraceRing) {
+        nBytes = (len<traceTruncateSize) ? len : traceTruncateSize;
+        return traceRingWrite(puserPvt->pport->ptraceRing,pasynUser,reason,
+            buffer,nBytes,pformat,pvar);
+    }
     epicsMutexMustLock(pasynBase->lockTrace);
     fp = getTraceFile(pasynUser);
     if (ptracePvt->traceInfoMask & ASYN_TRACEINFO_TIME) nout += (int)printTime(fp);
@@ -3012,6 +3134,193 @@ static int traceVprintIOSource(asynUser *pasynUser,int reason,
     return nout;
 }
 
+/*
+ * functions for the binary trace ring
+ */
+static traceRing *traceRingCreate(size_t size)
+{
+    traceRing *pring = callocMustSucceed(1,sizeof(traceRing),
+        "asynManager:traceRingCreate");
+
+    pring->size = size;
+    pring->buffer = callocMustSucceed(size,sizeof(char),
+        "asynManager:traceRingCreate");
+    return pring;
+}
+
+static void traceRingCopyIn(traceRing *pring,size_t position,
+    const void *source,size_t nBytes)
+{
+    size_t offset = position & (pring->size - 1);
+    size_t first = pring->size - offset;
+
+    if(first > nBytes) first = nBytes;
+    memcpy(pring->buffer + offset,source,first);
+    if(nBytes > first) memcpy(pring->buffer,(const char *)source + first,nBytes - first);
+}
+
+static void traceRingCopyOut(traceRing *pring,size_t position,
+    void *dest,size_t nBytes)
+{
+    size_t offset = position & (pring->size - 1);
+    size_t first = pring->size - offset;
+
+    if(first > nBytes) first = nBytes;
+    memcpy(dest,pring->buffer + offset,first);
+    if(nBytes > first) memcpy((char *)dest + first,pring->buffer,nBytes - first);
+}
+
+static int traceRingWrite(traceRing *pring,asynUser *pasynUser,int reason,
+    const char *buffer,size_t nBytes,const char *pformat,va_list pvar)
+{
+    traceRecord record;
+    char        message[TRACE_RING_MESSAGE_SIZE];
+    size_t      position,length,marker;
+    int         n,addr = -1;
+
+    n = epicsVsnprintf(message,sizeof(message),pformat,pvar);
+    if(n < 0) n = 0;
+    if(n >= (int)sizeof(message)) n = sizeof(message) - 1;
+    length = sizeof(traceRecord) + n + nBytes;
+    length = (length + TRACE_RING_ALIGN - 1) & ~(size_t)(TRACE_RING_ALIGN - 1);
+    if(length > pring->size/4) {
+        nBytes = pring->size/4 - sizeof(traceRecord) - n - TRACE_RING_ALIGN;
+        length = (sizeof(traceRecord) + n + nBytes + TRACE_RING_ALIGN - 1)
+                 & ~(size_t)(TRACE_RING_ALIGN - 1);
+    }
+    getAddr(pasynUser,&addr);
+    record.position = 0;
+    epicsTimeGetCurrent(&record.time);
+    record.length = (epicsUInt32)length;
+    record.addr = addr;
+    record.reason = pasynUser->reason;
+    record.traceType = reason;
+    record.messageLength = (epicsUInt32)n;
+    record.nBytes = (epicsUInt32)nBytes;
+    position = epicsAtomicAddSizeT(&pring->next,length) - length;
+    traceRingCopyIn(pring,position,&record,sizeof(record));
+    traceRingCopyIn(pring,position + sizeof(record),message,n);
+    traceRingCopyIn(pring,position + sizeof(record) + n,buffer,nBytes);
+    epicsAtomicWriteMemoryBarrier();
+    marker = position + 1;
+    traceRingCopyIn(pring,position,&marker,sizeof(marker));
+    epicsAtomicIncrSizeT(&pring->written);
+    return (int)length;
+}
+
+static const char *traceTypeName(int traceType)
+{
+    switch(traceType) {
+    case ASYN_TRACEIO_DEVICE: return "device";
+    case ASYN_TRACEIO_FILTER: return "filter";
+    case ASYN_TRACEIO_DRIVER: return "driver";
+    default:                  return "other";
+    }
+}
+
+/* Walk the ring from the oldest surviving byte. Records start on
+ * TRACE_RING_ALIGN boundaries, so after an overrun the walk resynchronizes
+ * by probing each aligned offset for a valid position marker.
+ * If fp is NULL only the number of valid records is returned.
+ */
+static size_t traceRingScan(traceRing *pring,port *pport,FILE *fp,
+    size_t skip,int traceIOMask,char *data)
+{
+    size_t end = epicsAtomicGetSizeT(&pring->next);
+    size_t position = (end > pring->size) ? end - pring->size : 0;
+    size_t nRecords = 0;
+
+    while(position + sizeof(traceRecord) <= end) {
+        traceRecord record;
+        size_t      nData;
+
+        traceRingCopyOut(pring,position,&record,sizeof(record));
+        epicsAtomicReadMemoryBarrier();
+        if(record.position != position + 1
+        || record.length < sizeof(traceRecord)
+        || record.length > pring->size/4
+        || (record.length % TRACE_RING_ALIGN) != 0
+        || record.messageLength >= TRACE_RING_MESSAGE_SIZE
+        || sizeof(traceRecord) + record.messageLength + record.nBytes > record.length) {
+            position += TRACE_RING_ALIGN;
+            continue;
+        }
+        nData = record.messageLength + record.nBytes;
+        if(fp) traceRingCopyOut(pring,position + sizeof(record),data,nData);
+        epicsAtomicReadMemoryBarrier();
+        /* Discard the record if writers reserved over it while copying */
+        if(epicsAtomicGetSizeT(&pring->next) - position > pring->size) {
+            position += TRACE_RING_ALIGN;
+            continue;
+        }
+        if(fp && nRecords >= skip) {
+            char timeText[40];
+
+            timeText[0] = 0;
+            epicsTimeToStrftime(timeText,sizeof(timeText),
+                "%Y/%m/%d %H:%M:%S.%06f",&record.time);
+            fprintf(fp,"%s [%s,%d,%d] %s ",timeText,pport->portName,
+                record.addr,record.reason,traceTypeName(record.traceType));
+            epicsStrPrintEscaped(fp,data,record.messageLength);
+            fprintf(fp,"%u bytes\n",record.nBytes);
+            if(record.nBytes > 0) {
+                char   *pbytes = data + record.messageLength;
+                size_t i;
+
+                if(traceIOMask&ASYN_TRACEIO_HEX) {
+                    for(i=0; i<record.nBytes; i++) {
+                        fprintf(fp,"%2.2x%s",(unsigned char)pbytes[i],
+                            ((i%20==19) || (i+1==record.nBytes)) ? "\n" : " ");
+                    }
+                } else {
+                    epicsStrPrintEscaped(fp,pbytes,record.nBytes);
+                    fprintf(fp,"\n");
+                }
+            }
+        }
+        nRecords++;
+        position += record.length;
+    }
+    return nRecords;
+}
+
+static asynStatus dumpTraceBuffer(asynUser *pasynUser,FILE *fp,size_t maxRecords)
+{
+    userPvt   *puserPvt = asynUserToUserPvt(pasynUser);
+    port      *pport = puserPvt->pport;
+    traceRing *pring;
+    size_t    nRecords,nWritten,skip;
+    char      *data;
+
+    if(!pport) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+            "asynManager:dumpTraceBuffer -- not connected to port.");
+        return asynError;
+    }
+    pring = pport->ptraceRing;
+    if(!pring) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+            "asynManager:dumpTraceBuffer -- port %s has no trace buffer,"
+            " set ASYN_TRACEIO_BINARY first.",pport->portName);
+        return asynError;
+    }
+    if(!fp) fp = stdout;
+    data = callocMustSucceed(pring->size/4,sizeof(char),
+        "asynManager:dumpTraceBuffer");
+    nRecords = traceRingScan(pring,pport,NULL,0,0,NULL);
+    nWritten = epicsAtomicGetSizeT(&pring->written);
+    skip = (maxRecords>0 && nRecords>maxRecords) ? nRecords - maxRecords : 0;
+    fprintf(fp,"%s trace buffer: %lu records written, %lu overwritten, %lu bytes,"
+        " showing %lu\n",pport->portName,(unsigned long)nWritten,
+        (unsigned long)(nWritten>nRecords ? nWritten - nRecords : 0),
+        (unsigned long)epicsAtomicGetSizeT(&pring->next),
+        (unsigned long)(nRecords - skip));
+    traceRingScan(pring,pport,fp,skip,findTracePvt(puserPvt)->traceIOMask,data);
+    fflush(fp);
+    free(data);
+    return asynSuccess;
+}
+
 /*
  * User-readable status code
  */
@@ -3026,6 +3335,296 @@ static const char *strStatus(asynStatus status)
     }
 }
 
+/*
+ * functions for object pools
+ */
+static void poolInit(objectPool *ppool)
+{
+    ppool->lock = epicsMutexMustCreate();
+    ellInit(&ppool->freeList);
+}
+
+static void poolLock(objectPool *ppool)
+{
+    if(epicsMutexTryLock(ppool->lock)!=epicsMutexLockOK) {
+        epicsMutexMustLock(ppool->lock);
+        ppool->contended++;
+    }
+}
+
+static void poolStatistics(objectPool *ppool,asynPoolStatistics *pstatistics)
+{
+    epicsMutexMustLock(ppool->lock);
+    pstatistics->allocated = ppool->allocated;
+    pstatistics->free = ellCount(&ppool->freeList);
+    pstatistics->gets = ppool->gets;
+    pstatistics->contended = ppool->contended;
+    epicsMutexUnlock(ppool->lock);
+}
+
+static userPvt *userPoolGet(objectPool *ppool)
+{
+    userPvt *puserPvt;
+
+    poolLock(ppool);
+    puserPvt = (userPvt *)ellFirst(&ppool->freeList);
+    if(!puserPvt) {
+        /* userPvt is followed by the errorMessage buffer */
+        size_t stride = ((sizeof(userPvt) + ERROR_MESSAGE_SIZE + 1 + 15)/16)*16;
+        char   *pslab = callocMustSucceed(POOL_SLAB_SIZE,stride,
+                            "asynManager:createAsynUser");
+        int    i;
+
+        for(i=0; i<POOL_SLAB_SIZE; i++) {
+            asynUser *pasynUser;
+
+            puserPvt = (userPvt *)(pslab + i*stride);
+            puserPvt->timer = epicsTimerQueueCreateTimer(
+                pasynBase->timerQueue,queueTimeoutCallback,puserPvt);
+            puserPvt->callbackDone = epicsEventMustCreate(epicsEventEmpty);
+            puserPvt->ppool = ppool;
+            pasynUser = userPvtToAsynUser(puserPvt);
+            pasynUser->errorMessage = (char *)(puserPvt +1);
+            pasynUser->errorMessageSize = ERROR_MESSAGE_SIZE;
+            ellAdd(&ppool->freeList,&puserPvt->node);
+        }
+        ppool->allocated += POOL_SLAB_SIZE;
+        puserPvt = (userPvt *)ellFirst(&ppool->freeList);
+    }
+    ellDelete(&ppool->freeList,&puserPvt->node);
+    ppool->gets++;
+    epicsMutexUnlock(ppool->lock);
+    return puserPvt;
+}
+
+static void userPoolPut(userPvt *puserPvt)
+{
+    objectPool *ppool = puserPvt->ppool;
+
+    poolLock(ppool);
+    ellAdd(&ppool->freeList,&puserPvt->node);
+    epicsMutexUnlock(ppool->lock);
+}
+
+/*
+ * functions for port statistics
+ */
+static const char *priorityName[NUMBER_QUEUE_PRIORITIES] = {
+    "low","medium","high","connect"
+};
+
+static void histogramAdd(asynHistogram *phistogram,double seconds)
+{
+    double usec;
+    int    bin = 0;
+
+    if(seconds<0.0) seconds = 0.0;
+    usec = seconds*1e6;
+    while(bin<ASYN_STATISTICS_BINS-1 && usec>=(double)(1UL<<bin)) bin++;
+    phistogram->bins[bin]++;
+    phistogram->count++;
+    phistogram->sum += seconds;
+    if(seconds>phistogram->max) phistogram->max = seconds;
+}
+
+static void histogramMerge(asynHistogram *pto,const asynHistogram *pfrom)
+{
+    int bin;
+
+    for(bin=0; bin<ASYN_STATISTICS_BINS; bin++)
+        pto->bins[bin] += pfrom->bins[bin];
+    pto->count += pfrom->count;
+    pto->sum += pfrom->sum;
+    if(pfrom->max>pto->max) pto->max = pfrom->max;
+}
+
+static void statisticsAdd(port *pport,asynHistogram *phistogram,double seconds)
+{
+    epicsMutexMustLock(pport->statisticsLock);
+    histogramAdd(phistogram,seconds);
+    epicsMutexUnlock(pport->statisticsLock);
+}
+
+/* synchronousLock is recursive so only the outermost lock/unlock is timed */
+static void synchronousLockAcquire(port *pport)
+{
+    epicsMutexMustLock(pport->synchronousLock);
+    if(pport->lockHoldDepth++ == 0)
+        epicsTimeGetCurrent(&pport->lockHoldStart);
+}
+
+static void synchronousLockRelease(port *pport)
+{
+    if(pport->lockHoldDepth>0 && --pport->lockHoldDepth==0) {
+        epicsTimeStamp now;
+
+        epicsTimeGetCurrent(&now);
+        statisticsAdd(pport,&pport->statistics.lockHold,
+            epicsTimeDiffInSeconds(&now,&pport->lockHoldStart));
+    }
+    epicsMutexUnlock(pport->synchronousLock);
+}
+
+static void getStatistics(port *pport,asynPortStatistics *pstatistics)
+{
+    epicsTimeStamp now;
+
+    epicsMutexMustLock(pport->statisticsLock);
+    *pstatistics = pport->statistics;
+    epicsMutexUnlock(pport->statisticsLock);
+    poolStatistics(&pport->userPool,&pstatistics->userPool);
+    poolStatistics(&pport->interruptNodePool,&pstatistics->interruptNodePool);
+    epicsTimeGetCurrent(&now);
+    pstatistics->elapsed = epicsTimeDiffInSeconds(&now,&pstatistics->startTime);
+    pstatistics->busyFraction = (pstatistics->elapsed>0.0)
+        ? pstatistics->lockHold.sum/pstatistics->elapsed : 0.0;
+    if(pstatistics->busyFraction>1.0) pstatistics->busyFraction = 1.0;
+}
+
+static asynStatus getPortStatistics(asynUser *pasynUser,
+    asynPortStatistics *pstatistics)
+{
+    userPvt  *puserPvt = asynUserToUserPvt(pasynUser);
+    port     *pport = puserPvt->pport;
+
+    if(!pport) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+            "asynManager:getPortStatistics not connected");
+        return asynError;
+    }
+    getStatistics(pport,pstatistics);
+    return asynSuccess;
+}
+
+static asynStatus resetPortStatistics(asynUser *pasynUser)
+{
+    userPvt  *puserPvt = asynUserToUserPvt(pasynUser);
+    port     *pport = puserPvt->pport;
+
+    if(!pport) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+            "asynManager:resetPortStatistics not connected");
+        return asynError;
+    }
+    epicsMutexMustLock(pport->statisticsLock);
+    memset(&pport->statistics,0,sizeof(pport->statistics));
+    epicsTimeGetCurrent(&pport->statistics.startTime);
+    epicsMutexUnlock(pport->statisticsLock);
+    return asynSuccess;
+}
+
+static void reportHistogramBins(FILE *fp,const asynHistogram *phistogram)
+{
+    int bin;
+    int nout = 0;
+
+    for(bin=0; bin<ASYN_STATISTICS_BINS; bin++) {
+        double usec;
+
+        if(phistogram->bins[bin]==0) continue;
+        if(nout%6==0) fprintf(fp,"%s        ",(nout ? "\n" : ""));
+        usec = (double)(1UL<<((bin<ASYN_STATISTICS_BINS-1) ? bin : bin-1));
+        fprintf(fp,"%s",(bin<ASYN_STATISTICS_BINS-1) ? "<" : ">=");
+        if(usec<1e3) fprintf(fp,"%.0fus",usec);
+        else if(usec<1e6) fprintf(fp,"%.3gms",usec/1e3);
+        else fprintf(fp,"%.3gs",usec/1e6);
+        fprintf(fp,":%lu ",phistogram->bins[bin]);
+        nout++;
+    }
+    if(nout) fprintf(fp,"\n");
+}
+
+static void reportHistogram(FILE *fp,int details,const char *title,
+    const asynHistogram *phistogram)
+{
+    if(phistogram->count==0) return;
+    fprintf(fp,"    %-18s count %lu mean %.3g max %.3g\n",
+        title,phistogram->count,
+        phistogram->sum/phistogram->count,phistogram->max);
+    if(details>=2) reportHistogramBins(fp,phistogram);
+}
+
+static void reportPool(FILE *fp,const char *title,
+    asynPoolStatistics *pstatistics)
+{
+    fprintf(fp,"    %s allocated %lu free %lu gets %lu contended %lu\n",
+        title,pstatistics->allocated,pstatistics->free,
+        pstatistics->gets,pstatistics->contended);
+}
+
+static void reportPortStatistics(FILE *fp,int details,port *pport)
+{
+    asynPortStatistics statistics;
+    asynHistogram queueWait,service;
+    char title[40];
+    int i;
+
+    getStatistics(pport,&statistics);
+    memset(&queueWait,0,sizeof(queueWait));
+    memset(&service,0,sizeof(service));
+    for(i=asynQueuePriorityLow; i<=asynQueuePriorityHigh; i++) {
+        histogramMerge(&queueWait,&statistics.queueWait[i]);
+        histogramMerge(&service,&statistics.service[i]);
+    }
+    fprintf(fp,"%s busy %.1f%% over %.3g seconds requests %lu\n",
+        pport->portName,statistics.busyFraction*100.0,statistics.elapsed,
+        service.count);
+    if(details<1) {
+        if(service.count>0)
+            fprintf(fp,"    queueWait mean %.3g max %.3g "
+                "service mean %.3g max %.3g\n",
+                queueWait.sum/queueWait.count,queueWait.max,
+                service.sum/service.count,service.max);
+        return;
+    }
+    for(i=asynQueuePriorityLow; i<=asynQueuePriorityConnect; i++) {
+        sprintf(title,"queueWait %s",priorityName[i]);
+        reportHistogram(fp,details,title,&statistics.queueWait[i]);
+        sprintf(title,"service %s",priorityName[i]);
+        reportHistogram(fp,details,title,&statistics.service[i]);
+    }
+    reportHistogram(fp,details,"lockHold",&statistics.lockHold);
+    reportPool(fp,"userPool",&statistics.userPool);
+    reportPool(fp,"interruptNodePool",&statistics.interruptNodePool);
+}
+
+static void reportStatistics(FILE *fp,int details,const char *portName)
+{
+    port *pport;
+    asynPoolStatistics userPool,shard;
+    int i;
+
+    if(!pasynBase) asynInit();
+    if(portName) {
+        pport = locatePort(portName);
+        if(!pport) {
+            fprintf(fp,"asynManager:reportStatistics port %s not found\n",
+                portName);
+            return;
+        }
+        reportPortStatistics(fp,details,pport);
+        return;
+    }
+    epicsMutexMustLock(pasynBase->lock);
+    pport = (port *)ellFirst(&pasynBase->asynPortList);
+    while(pport) {
+        reportPortStatistics(fp,details,pport);
+        pport = (port *)ellNext(&pport->node);
+    }
+    epicsMutexUnlock(pasynBase->lock);
+    if(details<1) return;
+    memset(&userPool,0,sizeof(userPool));
+    for(i=0; i<NUMBER_USER_POOLS; i++) {
+        poolStatistics(&pasynBase->userPool[i],&shard);
+        userPool.allocated += shard.allocated;
+        userPool.free += shard.free;
+        userPool.gets += shard.gets;
+        userPool.contended += shard.contended;
+    }
+    fprintf(fp,"asynManager createAsynUser pools %d\n",NUMBER_USER_POOLS);
+    reportPool(fp,"userPool",&userPool);
+}
+
 /*
  * functions for portConnect
  */
@@ -3057,6 +3656,8 @@ static void initPortConnect(port *pport)
         pasynBase->connectPortTimerQueue,
         portConnectTimerCallback, pport);
     pport->secondsBetweenPortConnect = DEFAULT_SECONDS_BETWEEN_PORT_CONNECT;
+    pport->secondsBeforeNextPortConnect = MIN_SECONDS_BETWEEN_PORT_CONNECT;
+    pport->connectJitterSeed = (unsigned int)(size_t)pport;
 }
 
 static void portConnectTimerCallback(void *pvt)
@@ -3088,7 +3689,17 @@ static void portConnectProcessCallback(asynUser *pasynUser)
     status = pasynManager->isConnected(pasynUser, &isConnected);
     if (!isConnected) status = pasynCommon->connect(drvPvt,pasynUser);
     if(status!=asynSuccess) {
-        epicsTimerStartDelay(pport->connectTimer,pport->secondsBetweenPortConnect);
+        /* Back off exponentially up to secondsBetweenPortConnect.  The delay is
+         * spread by +-25% so that ports which lost a shared network at the
+         * same time do not all retry together. */
+        double delay = pport->secondsBeforeNextPortConnect;
+
+        pport->connectJitterSeed = pport->connectJitterSeed*1103515245u + 12345u;
+        delay *= 0.75 + 0.5*((pport->connectJitterSeed >> 16) & 0x7fff)/32768.0;
+        epicsTimerStartDelay(pport->connectTimer,delay);
+        pport->secondsBeforeNextPortConnect *= 2;
+        if (pport->secondsBeforeNextPortConnect > pport->secondsBetweenPortConnect)
+            pport->secondsBeforeNextPortConnect = pport->secondsBetweenPortConnect;
     }
 }
 static void waitConnectExceptionHandler(asynUser *pasynUser, asynException exception)
@@ -220,3 +220,309 @@ asynParamClient* asynPortClient::getParamClient(std::string paramName, int addr)
 {
     return (*paramMaps_[addr])[paramName];
 }
+
+
+/** Constructor for asynPortClientBatch class
+  * \param[in] client  The asynPortClient whose parameters the batch operates on
+  * \param[in] timeout The timeout for the queued request and for each driver call
+*/
+asynPortClientBatch::asynPortClientBatch(asynPortClient &client, double timeout)
+    : client_(client), pasynUser_(NULL), pCallback_(NULL), userPvt_(NULL),
+      queued_(false), done_(false), finished_(true), status_(asynSuccess)
+{
+    asynStatus status;
+
+    pasynUser_ = pasynManager->createAsynUser(processCallback, timeoutCallback);
+    pasynUser_->userPvt = this;
+    pasynUser_->timeout = timeout;
+    status = pasynManager->connectDevice(pasynUser_, client.getPortName(), -1);
+    if (status) {
+        std::string msg = std::string("connectDevice failed:").append(pasynUser_->errorMessage);
+        pasynManager->freeAsynUser(pasynUser_);
+        throw std::runtime_error(msg);
+    }
+    doneEvent_ = epicsEventMustCreate(epicsEventEmpty);
+    lock_ = epicsMutexMustCreate();
+}
+
+/** Destructor for asynPortClientBatch class
+  * Cancels the request if it is still queued and frees all allocated resources
+*/
+asynPortClientBatch::~asynPortClientBatch()
+{
+    int wasQueued;
+    bool pending;
+
+    epicsMutexMustLock(lock_);
+    pending = queued_ && !done_;
+    epicsMutexUnlock(lock_);
+    if (pending) {
+        pasynManager->cancelRequest(pasynUser_, &wasQueued);
+        if (wasQueued) {
+            epicsMutexMustLock(lock_);
+            finished_ = true;
+            epicsMutexUnlock(lock_);
+        }
+    }
+    /* The port thread may still be in complete() */
+    epicsMutexMustLock(lock_);
+    while (!finished_) {
+        epicsMutexUnlock(lock_);
+        epicsEventMustWait(doneEvent_);
+        epicsMutexMustLock(lock_);
+    }
+    epicsMutexUnlock(lock_);
+    pasynManager->disconnect(pasynUser_);
+    pasynManager->freeAsynUser(pasynUser_);
+    epicsEventDestroy(doneEvent_);
+    epicsMutexDestroy(lock_);
+}
+
+int asynPortClientBatch::addOp(batchOpType type, std::string paramName, int addr, const char *interfaceType)
+{
+    asynParamClient *pClient = client_.getParamClient(paramName, addr);
+    batchOp op;
+
+    if (!pClient) {
+        throw std::runtime_error(std::string("asynPortClientBatch unknown paramName: ").append(paramName));
+    }
+    if (strcmp(pClient->getAsynInterfaceType(), interfaceType) != 0) {
+        throw std::runtime_error(std::string("asynPortClientBatch incorrect interface ").append(pClient->getAsynInterfaceType()));
+    }
+    op.type = type;
+    op.pClient = pClient;
+    op.int32Value = 0;
+    op.float64Value = 0.;
+    op.pDest = NULL;
+    op.bufferLen = 0;
+    op.status = asynSuccess;
+    ops_.push_back(op);
+    return (int)ops_.size() - 1;
+}
+
+/** Adds a read of an asynInt32 parameter; value is set when the batch runs
+  * \return The index of the operation, for getStatus(index) */
+int asynPortClientBatch::read(std::string paramName, epicsInt32 *value, int addr)
+{
+    int index = addOp(batchReadInt32, paramName, addr, asynInt32Type);
+    ops_[index].pDest = value;
+    return index;
+}
+
+/** Adds a write of an asynInt32 parameter
+  * \return The index of the operation, for getStatus(index) */
+int asynPortClientBatch::write(std::string paramName, epicsInt32 value, int addr)
+{
+    int index = addOp(batchWriteInt32, paramName, addr, asynInt32Type);
+    ops_[index].int32Value = value;
+    return index;
+}
+
+/** Adds a read of an asynFloat64 parameter; value is set when the batch runs
+  * \return The index of the operation, for getStatus(index) */
+int asynPortClientBatch::read(std::string paramName, epicsFloat64 *value, int addr)
+{
+    int index = addOp(batchReadFloat64, paramName, addr, asynFloat64Type);
+    ops_[index].pDest = value;
+    return index;
+}
+
+/** Adds a write of an asynFloat64 parameter
+  * \return The index of the operation, for getStatus(index) */
+int asynPortClientBatch::write(std::string paramName, epicsFloat64 value, int addr)
+{
+    int index = addOp(batchWriteFloat64, paramName, addr, asynFloat64Type);
+    ops_[index].float64Value = value;
+    return index;
+}
+
+/** Adds a read of an asynOctet parameter; value is set and nil terminated when the batch runs
+  * \return The index of the operation, for getStatus(index) */
+int asynPortClientBatch::read(std::string paramName, char *value, size_t bufferLen, int addr)
+{
+    int index = addOp(batchReadOctet, paramName, addr, asynOctetType);
+    ops_[index].pDest = value;
+    ops_[index].bufferLen = bufferLen;
+    return index;
+}
+
+/** Adds a write of an asynOctet parameter; the string is copied
+  * \return The index of the operation, for getStatus(index) */
+int asynPortClientBatch::write(std::string paramName, const char *value, int addr)
+{
+    int index = addOp(batchWriteOctet, paramName, addr, asynOctetType);
+    ops_[index].octetValue = value;
+    return index;
+}
+
+/** Removes all operations so that the batch can be reused */
+void asynPortClientBatch::clear()
+{
+    ops_.clear();
+}
+
+size_t asynPortClientBatch::size()
+{
+    return ops_.size();
+}
+
+/** Queues a request that performs all operations, in the order they were added
+  * \param[in] pCallback  Optional function called in the port thread when the batch is complete
+  * \param[in] userPvt    The user-defined pointer passed to pCallback
+  * \param[in] priority   The asynManager queue priority
+*/
+asynStatus asynPortClientBatch::queue(asynBatchCallback pCallback, void *userPvt, asynQueuePriority priority)
+{
+    asynStatus status;
+
+    epicsMutexMustLock(lock_);
+    if (queued_ && !done_) {
+        epicsMutexUnlock(lock_);
+        return asynError;
+    }
+    pCallback_ = pCallback;
+    userPvt_ = userPvt;
+    done_ = false;
+    queued_ = true;
+    finished_ = false;
+    epicsMutexUnlock(lock_);
+    status_ = asynSuccess;
+    epicsEventTryWait(doneEvent_);
+    status = pasynManager->queueRequest(pasynUser_, priority, pasynUser_->timeout);
+    if (status) {
+        for (size_t i=0; i<ops_.size(); i++) ops_[i].status = status;
+        status_ = status;
+        epicsMutexMustLock(lock_);
+        done_ = true;
+        queued_ = false;
+        finished_ = true;
+        epicsMutexUnlock(lock_);
+    }
+    return status;
+}
+
+/** Waits for a queued batch to complete
+  * \param[in] timeout  Seconds to wait; <0 waits until the batch is complete
+  * \return The status of the first operation that failed, or asynTimeout if the
+  *         batch did not complete in time */
+asynStatus asynPortClientBatch::wait(double timeout)
+{
+    bool pending;
+
+    epicsMutexMustLock(lock_);
+    pending = !finished_;
+    epicsMutexUnlock(lock_);
+    if (!pending) return status_;
+    if (timeout < 0) {
+        epicsEventMustWait(doneEvent_);
+    } else if (epicsEventWaitWithTimeout(doneEvent_, timeout) != epicsEventWaitOK) {
+        return asynTimeout;
+    }
+    return status_;
+}
+
+/** Returns true when the batch is not queued and its callback, if any, has returned */
+bool asynPortClientBatch::isDone()
+{
+    bool done;
+
+    epicsMutexMustLock(lock_);
+    done = finished_;
+    epicsMutexUnlock(lock_);
+    return done;
+}
+
+/** Returns the status of the first operation that failed, or asynSuccess */
+asynStatus asynPortClientBatch::getStatus()
+{
+    return status_;
+}
+
+/** Returns the status of one operation
+  * \param[in] index  The value returned when the operation was added */
+asynStatus asynPortClientBatch::getStatus(int index)
+{
+    if (index < 0 || index >= (int)ops_.size()) return asynError;
+    return ops_[index].status;
+}
+
+void asynPortClientBatch::processCallback(asynUser *pasynUser)
+{
+    asynPortClientBatch *pBatch = (asynPortClientBatch *)pasynUser->userPvt;
+    std::vector<batchOp> &ops = pBatch->ops_;
+
+    /* The port is locked, so the driver methods are called directly */
+    for (size_t i=0; i<ops.size(); i++) {
+        batchOp &op = ops[i];
+        asynInterface *pasynInterface = op.pClient->getAsynInterface();
+        asynUser *pasynUserParam = op.pClient->getAsynUser();
+        void *drvPvt = pasynInterface->drvPvt;
+        size_t nActual;
+        int eomReason;
+
+        pasynUserParam->timeout = pasynUser->timeout;
+        switch (op.type) {
+          case batchReadInt32:
+            op.status = ((asynInt32 *)pasynInterface->pinterface)->read(
+                drvPvt, pasynUserParam, (epicsInt32 *)op.pDest);
+            break;
+          case batchWriteInt32:
+            op.status = ((asynInt32 *)pasynInterface->pinterface)->write(
+                drvPvt, pasynUserParam, op.int32Value);
+            break;
+          case batchReadFloat64:
+            op.status = ((asynFloat64 *)pasynInterface->pinterface)->read(
+                drvPvt, pasynUserParam, (epicsFloat64 *)op.pDest);
+            break;
+          case batchWriteFloat64:
+            op.status = ((asynFloat64 *)pasynInterface->pinterface)->write(
+                drvPvt, pasynUserParam, op.float64Value);
+            break;
+          case batchReadOctet:
+            if (op.bufferLen == 0) {
+                op.status = asynError;
+                break;
+            }
+            op.status = ((asynOctet *)pasynInterface->pinterface)->read(
+                drvPvt, pasynUserParam, (char *)op.pDest, op.bufferLen-1, &nActual, &eomReason);
+            ((char *)op.pDest)[op.status == asynSuccess ? nActual : 0] = 0;
+            break;
+          case batchWriteOctet:
+            op.status = ((asynOctet *)pasynInterface->pinterface)->write(
+                drvPvt, pasynUserParam, op.octetValue.c_str(), op.octetValue.size(), &nActual);
+            break;
+        }
+        if (op.status != asynSuccess && pBatch->status_ == asynSuccess) pBatch->status_ = op.status;
+    }
+    pBatch->complete();
+}
+
+void asynPortClientBatch::timeoutCallback(asynUser *pasynUser)
+{
+    asynPortClientBatch *pBatch = (asynPortClientBatch *)pasynUser->userPvt;
+
+    for (size_t i=0; i<pBatch->ops_.size(); i++) pBatch->ops_[i].status = asynTimeout;
+    pBatch->status_ = asynTimeout;
+    pBatch->complete();
+}
+
+/* The batch is done before the callback runs, so that the callback may queue it again.
+ * Once finished_ is set and the lock released the batch may be destroyed. */
+void asynPortClientBatch::complete()
+{
+    asynBatchCallback pCallback;
+    void *userPvt;
+
+    epicsMutexMustLock(lock_);
+    done_ = true;
+    pCallback = pCallback_;
+    userPvt = userPvt_;
+    epicsMutexUnlock(lock_);
+    if (pCallback) pCallback(this, userPvt);
+    epicsMutexMustLock(lock_);
+    if (done_) {
+        finished_ = true;
+        epicsEventSignal(doneEvent_);
+    }
+    epicsMutexUnlock(lock_);
+}
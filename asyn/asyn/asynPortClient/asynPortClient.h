@@ -4,9 +4,13 @@
 #include <stdexcept>
 #include <string>
 #include <map>
+#include <vector>
 #include <string.h>
 
 #include <epicsString.h>
+#include <epicsEvent.h>
+#include <epicsMutex.h>
+#include <epicsMessageQueue.h>
 
 #include <asynDriver.h>
 #include <asynInt32.h>
@@ -15,6 +19,7 @@
 #include <asynUInt32DigitalSyncIO.h>
 #include <asynFloat64.h>
 #include <asynFloat64SyncIO.h>
+#include <asynInt64.h>
 #include <asynOctet.h>
 #include <asynOctetSyncIO.h>
 #include <asynInt8Array.h>
@@ -56,6 +61,16 @@ public:
     {
         return asynInterfaceType_;
     }
+    /** Returns the asynUser connected to the parameter, with reason set by drvUser->create */
+    asynUser *getAsynUser()
+    {
+        return pasynUser_;
+    }
+    /** Returns the asynInterface found for asynInterfaceType */
+    asynInterface *getAsynInterface()
+    {
+        return pasynInterface_;
+    }
 protected:
     asynUser *pasynUser_;
     asynUser *pasynUserSyncIO_;
@@ -782,6 +797,105 @@ private:
     asynCommon *pInterface_;
 };
 
+/** Interrupt callback and interface types used by asynSubscription<T> */
+template <typename T> struct asynSubscriptionTraits;
+template <> struct asynSubscriptionTraits<epicsInt32> {
+    typedef asynInt32 interfaceType;
+    typedef interruptCallbackInt32 callbackType;
+    static const char *typeName() { return asynInt32Type; }
+};
+template <> struct asynSubscriptionTraits<epicsInt64> {
+    typedef asynInt64 interfaceType;
+    typedef interruptCallbackInt64 callbackType;
+    static const char *typeName() { return asynInt64Type; }
+};
+template <> struct asynSubscriptionTraits<epicsFloat64> {
+    typedef asynFloat64 interfaceType;
+    typedef interruptCallbackFloat64 callbackType;
+    static const char *typeName() { return asynFloat64Type; }
+};
+
+/** One value delivered to an asynSubscription */
+template <typename T> struct asynSubscriptionValue {
+    T value;
+    epicsTimeStamp timeStamp;
+    int auxStatus;
+    int alarmStatus;
+    int alarmSeverity;
+};
+
+/** Typed stream of the values a driver passes to interrupt callbacks for one parameter.
+  * The values are queued by the callback, which never blocks the driver, and the client
+  * takes them with get() from its own thread. If the client does not keep up the newest
+  * values are discarded and counted by getOverflows().
+  * T can be epicsInt32, epicsInt64 or epicsFloat64. */
+template <typename T>
+class asynSubscription : public asynParamClient {
+public:
+    /** Constructor for asynSubscription class
+      * \param[in] portName   The name of the asyn port to connect to
+      * \param[in] addr       The address on the asyn port to connect to
+      * \param[in] drvInfo    The drvInfo string to identify which property of the port is being connected to
+      * \param[in] queueSize  The maximum number of values waiting for get()
+    */
+    asynSubscription(const char *portName, int addr, const char *drvInfo, unsigned int queueSize=100)
+    : asynParamClient(portName, addr, asynSubscriptionTraits<T>::typeName(), drvInfo, DEFAULT_TIMEOUT),
+      overflows_(0) {
+        pInterface_ = (typename asynSubscriptionTraits<T>::interfaceType *)pasynInterface_->pinterface;
+        queue_ = epicsMessageQueueCreate(queueSize, sizeof(asynSubscriptionValue<T>));
+        if (!queue_)
+            throw std::runtime_error(std::string("asynSubscription epicsMessageQueueCreate failed"));
+        if (pInterface_->registerInterruptUser(pasynInterface_->drvPvt, pasynUser_,
+                                               callback, this, &interruptPvt_)) {
+            epicsMessageQueueDestroy(queue_);
+            throw std::runtime_error(std::string("asynSubscription registerInterruptUser failed:").append(pasynUser_->errorMessage));
+        }
+    };
+    /** Destructor for asynSubscription class.  Cancels the callbacks, frees resources. */
+    virtual ~asynSubscription() {
+        pInterface_->cancelInterruptUser(pasynInterface_->drvPvt, pasynUser_, interruptPvt_);
+        epicsMessageQueueDestroy(queue_);
+    };
+    /** Takes the oldest value from the stream
+      * \param[out] pValue   The value with its time stamp and alarm status
+      * \param[in]  timeout  Seconds to wait for a value; <0 waits forever, 0 does not wait
+      * \return asynSuccess, or asynTimeout if no value arrived */
+    asynStatus get(asynSubscriptionValue<T> *pValue, double timeout=DEFAULT_TIMEOUT) {
+        int n;
+        if (timeout < 0)
+            n = epicsMessageQueueReceive(queue_, pValue, sizeof(*pValue));
+        else if (timeout == 0)
+            n = epicsMessageQueueTryReceive(queue_, pValue, sizeof(*pValue));
+        else
+            n = epicsMessageQueueReceiveWithTimeout(queue_, pValue, sizeof(*pValue), timeout);
+        return (n == (int)sizeof(*pValue)) ? asynSuccess : asynTimeout;
+    };
+    /** Returns the number of values waiting for get() */
+    int getPending() {
+        return epicsMessageQueuePending(queue_);
+    };
+    /** Returns the number of values discarded because the stream was full */
+    unsigned long getOverflows() {
+        return overflows_;
+    };
+private:
+    static void callback(void *userPvt, asynUser *pasynUser, T value) {
+        asynSubscription<T> *pThis = (asynSubscription<T> *)userPvt;
+        asynSubscriptionValue<T> v;
+        v.value = value;
+        v.timeStamp = pasynUser->timestamp;
+        v.auxStatus = pasynUser->auxStatus;
+        v.alarmStatus = pasynUser->alarmStatus;
+        v.alarmSeverity = pasynUser->alarmSeverity;
+        if (epicsMessageQueueTrySend(pThis->queue_, &v, sizeof(v)))
+            pThis->overflows_++;
+    };
+    typename asynSubscriptionTraits<T>::interfaceType *pInterface_;
+    epicsMessageQueueId queue_;
+    unsigned long overflows_;
+};
+
+
 typedef std::map<std::string, asynParamClient*> paramMap_t;
 
 class epicsShareClass asynPortClient {
@@ -797,10 +911,76 @@ public:
     asynStatus read(std::string paramName, char *value, size_t bufferLen, int addr=0);
 
     asynParamClient* getParamClient(std::string paramName, int addr=0);
+    /** Returns the name of the port this client is connected to */
+    const char *getPortName() {
+        return pPort_->portName;
+    }
 
 private:
     asynPortDriver *pPort_;
     paramMap_t** paramMaps_;
 };
 
+class asynPortClientBatch;
+/** Called in the port thread when all operations in an asynPortClientBatch are complete */
+typedef void (*asynBatchCallback)(asynPortClientBatch *pBatch, void *userPvt);
+
+/** A list of reads and writes on parameters of one asynPortClient that is executed
+  * in a single queued request, i.e. with one port lock and without blocking the caller.
+  * The values of reads are stored when the request runs. The caller either passes a
+  * callback to queue() or calls wait(); the batch acts as the future for its operations.
+  * A batch must not be modified, queued again or destroyed while it is queued, nor
+  * destroyed from its own callback. It is done when its callback runs, so the callback
+  * may queue it again. */
+class epicsShareClass asynPortClientBatch {
+public:
+    asynPortClientBatch(asynPortClient &client, double timeout=DEFAULT_TIMEOUT);
+    virtual ~asynPortClientBatch();
+    int read(std::string paramName, epicsInt32 *value, int addr=0);
+    int write(std::string paramName, epicsInt32 value, int addr=0);
+    int read(std::string paramName, epicsFloat64 *value, int addr=0);
+    int write(std::string paramName, epicsFloat64 value, int addr=0);
+    int read(std::string paramName, char *value, size_t bufferLen, int addr=0);
+    int write(std::string paramName, const char *value, int addr=0);
+    void clear();
+    size_t size();
+    asynStatus queue(asynBatchCallback pCallback=0, void *userPvt=0,
+                     asynQueuePriority priority=asynQueuePriorityMedium);
+    asynStatus wait(double timeout=-1.0);
+    bool isDone();
+    asynStatus getStatus();
+    asynStatus getStatus(int index);
+
+private:
+    enum batchOpType {
+        batchReadInt32, batchWriteInt32, batchReadFloat64, batchWriteFloat64,
+        batchReadOctet, batchWriteOctet
+    };
+    struct batchOp {
+        batchOpType type;
+        asynParamClient *pClient;
+        epicsInt32 int32Value;
+        epicsFloat64 float64Value;
+        std::string octetValue;
+        void *pDest;
+        size_t bufferLen;
+        asynStatus status;
+    };
+    int addOp(batchOpType type, std::string paramName, int addr, const char *interfaceType);
+    static void processCallback(asynUser *pasynUser);
+    static void timeoutCallback(asynUser *pasynUser);
+    void complete();
+    asynPortClient &client_;
+    asynUser *pasynUser_;
+    std::vector<batchOp> ops_;
+    asynBatchCallback pCallback_;
+    void *userPvt_;
+    epicsEventId doneEvent_;
+    epicsMutexId lock_;     /* guards queued_, done_ and finished_ */
+    bool queued_;
+    bool done_;
+    bool finished_;         /* complete() will not touch the batch again */
+    asynStatus status_;
+};
+
 #endif
@@ -19,7 +19,10 @@
 #include <epicsString.h>
 #include <epicsMutex.h>
 #include <epicsThread.h>
+#include <epicsTimer.h>
+#include <epicsMath.h>
 #include <cantProceed.h>
+#include <iocsh.h>
 /* NOTE: interruptAccept is define in dbAccess.h if using EPICS IOC, else set it to 1 */
 #ifdef EPICS_LIBCOM_ONLY
     static int interruptAccept=1;
@@ -36,9 +39,28 @@
 #include "ParamValWrongType.h"
 #include "ParamValNotDefined.h"
 #include "asynPortDriver.h"
+#include <epicsExport.h>
 
 static const char *driverName = "asynPortDriver";
 
+/** Callback policy and publication history for a single parameter.
+  * A policy with minInterval=0 and deadband=0 (the default) does a callback every time
+  * callParamCallbacks() is called after the parameter has changed. */
+struct paramCallbackPolicy {
+    double minInterval;         /**< Minimum time between callbacks in seconds */
+    double deadband;            /**< Change in a numeric value needed to do a callback */
+    bool published;             /**< True once a callback has been done with this policy */
+    epicsTimeStamp lastTime;    /**< Time of the last callback */
+    double lastValue;           /**< Numeric value passed in the last callback */
+    asynStatus lastStatus;      /**< Status passed in the last callback */
+    int lastAlarmStatus;        /**< Alarm status passed in the last callback */
+    int lastAlarmSeverity;      /**< Alarm severity passed in the last callback */
+    paramCallbackPolicy(double minIntervalIn=0., double deadbandIn=0.)
+        : minInterval(minIntervalIn), deadband(deadbandIn), published(false),
+          lastValue(0.), lastStatus(asynSuccess), lastAlarmStatus(0), lastAlarmSeverity(0)
+    { lastTime.secPastEpoch = 0; lastTime.nsec = 0; }
+};
+
 /** Class to support parameter library (also called parameter list);
   * set and get values indexed by parameter number (pasynUser->reason)
   * and do asyn callbacks when parameters change.
@@ -76,10 +98,15 @@ public:
     asynStatus getAlarmStatus(int index, int *alarmStatus);
     asynStatus setAlarmSeverity(int index, int alarmSeverity);
     asynStatus getAlarmSeverity(int index, int *alarmSeverity);
+    asynStatus setCallbackPolicy(int index, double minInterval, double deadband);
+    asynStatus getCallbackPolicy(int index, double *minInterval, double *deadband);
+    void flushDeferredCallbacks();
     void report(FILE *fp, int details);
 
 private:
     asynStatus setFlag(int index);
+    bool callbackDue(int index, const epicsTimeStamp& now, double *holdoff);
+    void callbackDone(int index, const epicsTimeStamp& now);
     asynStatus int32Callback(int command, int addr);
     asynStatus int64Callback(int command, int addr);
     asynStatus uint32Callback(int command, int addr, epicsUInt32 interruptMask);
@@ -90,17 +117,32 @@ private:
     asynPortDriver *pasynPortDriver;
     std::vector<unsigned> flags;
     std::vector<paramVal*> vals;
+    std::vector<paramCallbackPolicy> policies;
+    paramCallbackPolicy defaultPolicy;
+    epicsTimerQueueId timerQueue;
+    epicsTimerId flushTimer;
+    int flushAddr;
 };
 
+static void flushTimerCallback(void *drvPvt)
+{
+    paramList *pList = (paramList *)drvPvt;
+    pList->flushDeferredCallbacks();
+}
+
 /** Constructor for paramList class.
   * \param[in] pPort Pointer to asynPortDriver port for this paramList. */
 paramList::paramList(asynPortDriver *pPort)
-    : pasynPortDriver(pPort)
+    : pasynPortDriver(pPort), timerQueue(0), flushTimer(0), flushAddr(0)
 {}
 
 /** Destructor for paramList class; frees resources allocated in constructor */
 paramList::~paramList()
 {
+    if (this->flushTimer) {
+        epicsTimerQueueDestroyTimer(this->timerQueue, this->flushTimer);
+        epicsTimerQueueRelease(this->timerQueue);
+    }
     for (size_t i = 0; i < this->vals.size(); i++)
         delete this->vals[i];
 }
@@ -134,6 +176,7 @@ asynStatus paramList::createParam(const char *name, asynParamType type, int *ind
     std::auto_ptr<paramVal> param(new paramVal(name, type));
 
     vals.push_back(param.get());
+    policies.push_back(defaultPolicy);
     flags.reserve(vals.size());
     param.release();
     *index = (int)vals.size()-1;
@@ -826,26 +869,158 @@ asynStatus paramList::octetCallback(int command, int addr)
     return asynSuccess;
 }
 
+/** Sets the callback policy for a parameter in the parameter library.
+  * \param[in] index The parameter number; -1 sets the policy for all parameters in the list
+  * and makes it the default for parameters created later.
+  * \param[in] minInterval Minimum time in seconds between callbacks for this parameter.
+  * Changes that occur faster than this are coalesced, and the latest value is passed
+  * to the callback when the interval expires. 0 disables rate limiting.
+  * \param[in] deadband Minimum change in value of a numeric (Int32, Int64 or Float64) parameter
+  * since the last callback before a new callback is done. Changes of status or alarm
+  * always do a callback. 0 disables the deadband.
+  * \return Returns asynParamBadIndex if the index is not valid */
+asynStatus paramList::setCallbackPolicy(int index, double minInterval, double deadband)
+{
+    if (minInterval < 0.) minInterval = 0.;
+    if (deadband < 0.) deadband = 0.;
+    if (index == -1) {
+        this->defaultPolicy = paramCallbackPolicy(minInterval, deadband);
+        for (size_t i = 0; i < this->policies.size(); i++)
+            this->policies[i] = this->defaultPolicy;
+        return asynSuccess;
+    }
+    if (index < 0 || (size_t)index >= this->vals.size()) return asynParamBadIndex;
+    this->policies[index] = paramCallbackPolicy(minInterval, deadband);
+    return asynSuccess;
+}
+
+/** Returns the callback policy for a parameter in the parameter library.
+  * \param[in] index The parameter number; -1 returns the default policy for the list.
+  * \param[out] minInterval Minimum time in seconds between callbacks.
+  * \param[out] deadband Minimum change in value before a callback is done.
+  * \return Returns asynParamBadIndex if the index is not valid */
+asynStatus paramList::getCallbackPolicy(int index, double *minInterval, double *deadband)
+{
+    const paramCallbackPolicy *pPolicy = &this->defaultPolicy;
+
+    if (index != -1) {
+        if (index < 0 || (size_t)index >= this->vals.size()) return asynParamBadIndex;
+        pPolicy = &this->policies[index];
+    }
+    *minInterval = pPolicy->minInterval;
+    *deadband = pPolicy->deadband;
+    return asynSuccess;
+}
+
+/** Decides whether a changed parameter should do its callbacks now.
+  * \param[in] index The parameter number
+  * \param[in] now The current time
+  * \param[out] holdoff If the callback is deferred by the minimum interval, the time in seconds
+  * until it is due.  0 if the change is suppressed by the deadband or the callback is due now.
+  * \return Returns true if the callbacks should be done now. */
+bool paramList::callbackDue(int index, const epicsTimeStamp& now, double *holdoff)
+{
+    paramCallbackPolicy& policy = this->policies[index];
+    paramVal *param = this->vals[index];
+
+    *holdoff = 0.;
+    if (!policy.published) return true;
+    if (policy.minInterval > 0.) {
+        double elapsed = epicsTimeDiffInSeconds(&now, &policy.lastTime);
+        if (elapsed >= 0. && elapsed < policy.minInterval) {
+            *holdoff = policy.minInterval - elapsed;
+            return false;
+        }
+    }
+    if (policy.deadband <= 0.) return true;
+    if ((param->getStatus() != policy.lastStatus) ||
+        (param->getAlarmStatus() != policy.lastAlarmStatus) ||
+        (param->getAlarmSeverity() != policy.lastAlarmSeverity)) return true;
+    switch (param->type) {
+        case asynParamInt32:
+            return fabs(param->getInteger() - policy.lastValue) > policy.deadband;
+        case asynParamInt64:
+            return fabs((double)param->getInteger64() - policy.lastValue) > policy.deadband;
+        case asynParamFloat64:
+            /* NaN never compares greater so check it explicitly */
+            if (isnan(param->getDouble()) != isnan(policy.lastValue)) return true;
+            return fabs(param->getDouble() - policy.lastValue) > policy.deadband;
+        default:
+            return true;
+    }
+}
+
+/** Records the state of a parameter after its callbacks have been done */
+void paramList::callbackDone(int index, const epicsTimeStamp& now)
+{
+    paramCallbackPolicy& policy = this->policies[index];
+    paramVal *param = this->vals[index];
+
+    if ((policy.minInterval <= 0.) && (policy.deadband <= 0.)) return;
+    policy.published = true;
+    policy.lastTime = now;
+    policy.lastStatus = param->getStatus();
+    policy.lastAlarmStatus = param->getAlarmStatus();
+    policy.lastAlarmSeverity = param->getAlarmSeverity();
+    switch (param->type) {
+        case asynParamInt32:
+            policy.lastValue = param->getInteger();
+            break;
+        case asynParamInt64:
+            policy.lastValue = (double)param->getInteger64();
+            break;
+        case asynParamFloat64:
+            policy.lastValue = param->getDouble();
+            break;
+        default:
+            break;
+    }
+}
+
+/** Does the callbacks that were deferred by a minimum interval policy.
+  * Called from the flush timer when the earliest deferred callback is due. */
+void paramList::flushDeferredCallbacks()
+{
+    this->pasynPortDriver->lock();
+    callCallbacks(this->flushAddr);
+    this->pasynPortDriver->unlock();
+}
+
 /** Calls the registered asyn callback functions for all clients for any parameters that have changed
   * since the last time this function was called.
   * \param[in] addr A client will be called if addr matches the asyn address registered for that client.
   *
   * Don't do anything if interruptAccept=0.
   * There is a thread that will do all callbacks once when interruptAccept goes to 1.
+  *
+  * Parameters with a callback policy (see setCallbackPolicy) whose minimum interval has not
+  * expired stay flagged and are done later with their latest value, either by the next call
+  * to this function or by a timer.  Changes within the deadband are discarded.
   */
 asynStatus paramList::callCallbacks(int addr)
 {
     int index;
     asynStatus status = asynSuccess;
+    std::vector<unsigned> deferred;
+    double holdoff, flushDelay = -1.;
+    epicsTimeStamp now;
 
     if (!interruptAccept) return asynSuccess;
 
+    epicsTimeGetCurrent(&now);
     try {
         for (size_t i = 0; i < this->flags.size(); i++)
         {
             index = this->flags[i];
             paramVal *param(getParameter(index));
             if (!param->isDefined()) continue;
+            if (!callbackDue(index, now, &holdoff)) {
+                if (holdoff > 0.) {
+                    deferred.push_back((unsigned)index);
+                    if (flushDelay < 0. || holdoff < flushDelay) flushDelay = holdoff;
+                }
+                continue;
+            }
             switch(param->type) {
                 case asynParamInt32:
                     status = int32Callback(index, addr);
@@ -866,12 +1041,21 @@ asynStatus paramList::callCallbacks(int addr)
                 default:
                     break;
             }
+            callbackDone(index, now);
         }
     }
     catch (ParamListInvalidIndex&) {
         return asynParamBadIndex;
     }
-    flags.clear();
+    flags.swap(deferred);
+    if (flushDelay > 0.) {
+        if (!this->flushTimer) {
+            this->timerQueue = epicsTimerQueueAllocate(1, epicsThreadPriorityMedium);
+            this->flushTimer = epicsTimerQueueCreateTimer(this->timerQueue, flushTimerCallback, this);
+        }
+        this->flushAddr = addr;
+        epicsTimerStartDelay(this->flushTimer, flushDelay);
+    }
     return status;
 }
 
@@ -891,6 +1075,10 @@ void paramList::report(FILE *fp, int details)
     for (int i=0; i<(int)this->vals.size(); i++)
     {
         this->vals[i]->report(i, fp, details);
+        if ((this->policies[i].minInterval > 0.) || (this->policies[i].deadband > 0.)) {
+            fprintf(fp, "  Callback policy: minInterval=%g deadband=%g\n",
+                    this->policies[i].minInterval, this->policies[i].deadband);
+        }
     }
 }
 
@@ -1691,6 +1879,48 @@ asynStatus asynPortDriver::callParamCallbacks(int list, int addr)
     return this->params[list]->callCallbacks(addr);
 }
 
+/** Sets the callback policy for a parameter in parameter list 0.
+  * See setParamCallbackPolicy(int list, int index, double minInterval, double deadband) */
+asynStatus asynPortDriver::setParamCallbackPolicy(int index, double minInterval, double deadband)
+{
+    return this->setParamCallbackPolicy(0, index, minInterval, deadband);
+}
+
+/** Sets the callback policy for a parameter in a specific parameter list.
+  * Calls paramList::setCallbackPolicy(index, minInterval, deadband).
+  * The policy limits how often callParamCallbacks() does callbacks for this parameter:
+  * changes occurring faster than minInterval are coalesced into one callback with the latest value,
+  * and changes of numeric parameters smaller than deadband are not passed to clients.
+  * \param[in] list The parameter list number.  Must be < maxAddr passed to asynPortDriver::asynPortDriver.
+  * \param[in] index The parameter number; -1 applies the policy to all parameters in the list
+  * \param[in] minInterval Minimum time in seconds between callbacks; 0 for no limit
+  * \param[in] deadband Minimum change in value before a callback is done; 0 for any change */
+asynStatus asynPortDriver::setParamCallbackPolicy(int list, int index, double minInterval, double deadband)
+{
+    asynStatus status;
+    static const char *functionName = "setParamCallbackPolicy";
+
+    status = this->params[list]->setCallbackPolicy(index, minInterval, deadband);
+    if (status) reportSetParamErrors(status, index, list, functionName);
+    return status;
+}
+
+/** Returns the callback policy for a parameter in a specific parameter list.
+  * Calls paramList::getCallbackPolicy(index, minInterval, deadband).
+  * \param[in] list The parameter list number.  Must be < maxAddr passed to asynPortDriver::asynPortDriver.
+  * \param[in] index The parameter number; -1 returns the default policy for the list
+  * \param[out] minInterval Minimum time in seconds between callbacks
+  * \param[out] deadband Minimum change in value before a callback is done */
+asynStatus asynPortDriver::getParamCallbackPolicy(int list, int index, double *minInterval, double *deadband)
+{
+    asynStatus status;
+    static const char *functionName = "getParamCallbackPolicy";
+
+    status = this->params[list]->getCallbackPolicy(index, minInterval, deadband);
+    if (status) reportGetParamErrors(status, index, list, functionName);
+    return status;
+}
+
 /** Calls paramList::report(fp, details) for each parameter list that the driver supports.
   * \param[in] fp The file pointer on which report information will be written
   * \param[in] details The level of report detail desired; always report details on address 0; >=2 report all addresses */
@@ -3818,11 +4048,12 @@ asynStatus asynPortDriver::createParams()
 asynPortDriver::~asynPortDriver()
 {
     delete cbThread;
-    epicsMutexDestroy(this->mutexId);
 
+    /* Delete the parameter lists first, their flush timers may still take the lock */
     for (int addr=0; addr<this->maxAddr; addr++) {
         delete this->params[addr];
     }
+    epicsMutexDestroy(this->mutexId);
 
     pasynManager->freeAsynUser(this->pasynUserSelf);
     free(this->inputEosOctet);
@@ -3848,3 +4079,71 @@ void* findAsynPortDriver(const char *portName)
 }
 
 
+
+/** Sets the callback policy of one or all parameters of an asynPortDriver port.
+  * Intended to be called from the IOC shell so that any driver derived from asynPortDriver
+  * can be rate limited without code changes.
+  * \param[in] portName The name of the asyn port
+  * \param[in] addr The parameter list; -1 for all lists
+  * \param[in] paramName The name of the parameter; NULL, "" or "*" for all parameters
+  * \param[in] minInterval Minimum time in seconds between callbacks
+  * \param[in] deadband Minimum change in value before a callback is done */
+int asynSetParamCallbackPolicy(const char *portName, int addr, const char *paramName,
+                               double minInterval, double deadband)
+{
+    asynPortDriver *pPort;
+    int list, firstList, lastList, index;
+    int allParams = (!paramName || (strlen(paramName) == 0) || (strcmp(paramName, "*") == 0));
+    int status = 0;
+
+    pPort = (asynPortDriver *)findAsynPortDriver(portName);
+    if (!pPort) {
+        printf("asynSetParamCallbackPolicy: cannot find asynPortDriver port %s\n", portName);
+        return -1;
+    }
+    if (addr >= pPort->maxAddr) {
+        printf("asynSetParamCallbackPolicy: addr %d must be < maxAddr=%d\n", addr, pPort->maxAddr);
+        return -1;
+    }
+    firstList = (addr < 0) ? 0 : addr;
+    lastList = (addr < 0) ? pPort->maxAddr-1 : addr;
+    pPort->lock();
+    for (list=firstList; list<=lastList; list++) {
+        if (allParams) {
+            index = -1;
+        } else if (pPort->findParam(list, paramName, &index) != asynSuccess) {
+            printf("asynSetParamCallbackPolicy: port %s list %d has no parameter %s\n",
+                   portName, list, paramName);
+            status = -1;
+            continue;
+        }
+        if (pPort->setParamCallbackPolicy(list, index, minInterval, deadband)) status = -1;
+    }
+    pPort->unlock();
+    return status;
+}
+
+static const iocshArg asynSetParamCallbackPolicyArg0 = {"portName", iocshArgString};
+static const iocshArg asynSetParamCallbackPolicyArg1 = {"addr (-1 for all)", iocshArgInt};
+static const iocshArg asynSetParamCallbackPolicyArg2 = {"paramName (* for all)", iocshArgString};
+static const iocshArg asynSetParamCallbackPolicyArg3 = {"minInterval (s)", iocshArgDouble};
+static const iocshArg asynSetParamCallbackPolicyArg4 = {"deadband", iocshArgDouble};
+static const iocshArg * const asynSetParamCallbackPolicyArgs[] = {
+    &asynSetParamCallbackPolicyArg0, &asynSetParamCallbackPolicyArg1, &asynSetParamCallbackPolicyArg2,
+    &asynSetParamCallbackPolicyArg3, &asynSetParamCallbackPolicyArg4};
+static const iocshFuncDef asynSetParamCallbackPolicyDef =
+    {"asynSetParamCallbackPolicy", 5, asynSetParamCallbackPolicyArgs};
+static void asynSetParamCallbackPolicyCall(const iocshArgBuf *args)
+{
+    asynSetParamCallbackPolicy(args[0].sval, args[1].ival, args[2].sval, args[3].dval, args[4].dval);
+}
+
+static void asynPortDriverRegister(void)
+{
+    static int firstTime = 1;
+    if (firstTime) {
+        firstTime = 0;
+        iocshRegister(&asynSetParamCallbackPolicyDef, asynSetParamCallbackPolicyCall);
+    }
+}
+epicsExportRegistrar(asynPortDriverRegister);
@@ -16,6 +16,8 @@
 class paramList;
 
 epicsShareFunc void* findAsynPortDriver(const char *portName);
+epicsShareFunc int asynSetParamCallbackPolicy(const char *portName, int addr, const char *paramName,
+                                              double minInterval, double deadband);
 typedef void (*userTimeStampFunction)(void *userPvt, epicsTimeStamp *pTimeStamp);
 
 #ifdef __cplusplus
@@ -191,6 +193,9 @@ public:
     virtual asynStatus callParamCallbacks();
     virtual asynStatus callParamCallbacks(          int addr);
     virtual asynStatus callParamCallbacks(int list, int addr);
+    virtual asynStatus setParamCallbackPolicy(          int index, double minInterval, double deadband);
+    virtual asynStatus setParamCallbackPolicy(int list, int index, double minInterval, double deadband);
+    virtual asynStatus getParamCallbackPolicy(int list, int index, double *minInterval, double *deadband);
     virtual asynStatus updateTimeStamp();
     virtual asynStatus updateTimeStamp(epicsTimeStamp *pTimeStamp);
     virtual asynStatus getTimeStamp(epicsTimeStamp *pTimeStamp);
@@ -0,0 +1,142 @@
+/*************************************************************************\
+* asynDriver is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <string>
+
+#include <string.h>
+
+#include <epicsStdio.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <epicsUnitTest.h>
+#include <testMain.h>
+
+#include <asynPortDriver.h>
+#include <asynOctet.h>
+#include <asynOctetSyncIO.h>
+#include <asynShellCommands.h>
+#include <asynInterposeWriteCombine.h>
+
+namespace {
+
+/* Keeps what is written to it, and fails writes on request */
+class octetSink : public asynPortDriver {
+public:
+    octetSink(const char *portName)
+        : asynPortDriver(portName, 1, asynOctetMask|asynDrvUserMask, 0,
+                         ASYN_CANBLOCK, 1, 0, 0),
+          writes(0), fail(false) {}
+    virtual asynStatus writeOctet(asynUser *pasynUser, const char *value,
+                                  size_t maxChars, size_t *nActual)
+    {
+        writes++;
+        if (fail) {
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                          "write failed");
+            *nActual = 0;
+            return asynError;
+        }
+        received.append(value, maxChars);
+        *nActual = maxChars;
+        return asynSuccess;
+    }
+    std::string received;
+    int writes;
+    bool fail;
+};
+
+octetSink *sink;
+
+/* Waits up to 1 second for the sink to have seen n writes */
+bool waitWrites(int n)
+{
+    for (int i = 0; i < 100; i++) {
+        sink->lock();
+        int writes = sink->writes;
+        sink->unlock();
+        if (writes >= n) return writes == n;
+        epicsThreadSleep(0.01);
+    }
+    return false;
+}
+
+std::string received()
+{
+    sink->lock();
+    std::string value(sink->received);
+    sink->received.clear();
+    sink->unlock();
+    return value;
+}
+
+void setFail(bool fail)
+{
+    sink->lock();
+    sink->fail = fail;
+    sink->unlock();
+}
+
+} // namespace
+
+MAIN(asynInterposeWriteCombineTest)
+{
+    asynUser *pasynUser;
+    asynInterface *pasynInterface;
+    asynOctet *pasynOctet;
+    size_t n;
+    asynStatus status;
+
+    testPlan(15);
+    sink = new octetSink("sink");
+    testOk1(asynInterposeWriteCombine("sink", 0, 0, 0) == 0);
+    pasynOctetSyncIO->connect("sink", 0, &pasynUser, NULL);
+
+    testDiag("Writes reaching the port before the flush are combined");
+    pasynInterface = pasynManager->findInterface(pasynUser, asynOctetType, 1);
+    pasynOctet = (asynOctet *)pasynInterface->pinterface;
+    pasynManager->lockPort(pasynUser);
+    pasynOctet->write(pasynInterface->drvPvt, pasynUser, "a", 1, &n);
+    pasynOctet->write(pasynInterface->drvPvt, pasynUser, "b", 1, &n);
+    pasynOctet->write(pasynInterface->drvPvt, pasynUser, "c", 1, &n);
+    testOk(sink->writes == 0, "Nothing written while the port is busy");
+    pasynManager->unlockPort(pasynUser);
+    testOk(waitWrites(1), "One driver write");
+    testOk1(received() == "abc");
+
+    testDiag("An idle port is not kept waiting");
+    testOk1(pasynOctetSyncIO->write(pasynUser, "d", 1, 1.0, &n) == asynSuccess);
+    testOk(waitWrites(2), "Written without a window");
+    testOk1(received() == "d");
+
+    testDiag("A failed buffered write is reported by the next write");
+    setFail(true);
+    testOk1(pasynOctetSyncIO->write(pasynUser, "e", 1, 1.0, &n) == asynSuccess);
+    waitWrites(3);
+    setFail(false);
+    status = pasynOctetSyncIO->write(pasynUser, "f", 1, 1.0, &n);
+    testOk(status == asynError, "Next write failed: %s", pasynUser->errorMessage);
+    testOk1(pasynOctetSyncIO->write(pasynUser, "g", 1, 1.0, &n) == asynSuccess);
+    waitWrites(4);
+    testOk(received() == "g", "The failed write was not buffered");
+
+    testDiag("... or by the next flush");
+    setFail(true);
+    pasynOctetSyncIO->write(pasynUser, "h", 1, 1.0, &n);
+    waitWrites(5);
+    setFail(false);
+    testOk1(pasynOctetSyncIO->flush(pasynUser) == asynError);
+    testOk1(pasynOctetSyncIO->flush(pasynUser) == asynSuccess);
+
+    testDiag("A window holds writes to combine them");
+    asynSetOption("sink", 0, "combineWindow", "0.2");
+    pasynOctetSyncIO->write(pasynUser, "i", 1, 1.0, &n);
+    epicsThreadSleep(0.05);
+    pasynOctetSyncIO->write(pasynUser, "j", 1, 1.0, &n);
+    testOk(waitWrites(6), "One driver write");
+    testOk1(received() == "ij");
+
+    pasynOctetSyncIO->disconnect(pasynUser);
+    return testDone();
+}
@@ -8,6 +8,7 @@
 
 #include <string.h>
 
+#include <epicsEvent.h>
 #include <epicsGuard.h>
 #include <epicsThread.h>
 #include <epicsUnitTest.h>
@@ -165,14 +166,329 @@ void testA()
     }
 }
 
+epicsFloat64 lastfloat64;
+size_t float64count;
+
+void float64cb(void *userPvt, asynUser *pasynUser,
+                                         epicsFloat64 data)
+{
+    testDiag("float64cb() called with %g", data);
+    float64count++;
+    lastfloat64 = data;
+}
+
+asynPortDriver *portB;
+
+void testCallbackPolicy()
+{
+    portB = new asynPortDriver("portB", 0,
+                               asynDrvUserMask|asynFloat64Mask,
+                               asynFloat64Mask, 0, 0, 0,
+                               epicsThreadGetStackSize(epicsThreadStackSmall));
+
+    int idx=-1;
+    double minInterval, deadband;
+
+    testDiag("Parameter callback policy");
+
+    testOk1(portB->createParam(0, "float64", asynParamFloat64, &idx)==asynSuccess);
+    testOk1(portB->getParamCallbackPolicy(0, idx, &minInterval, &deadband)==asynSuccess);
+    testOk1(minInterval==0. && deadband==0.);
+    testOk1(portB->setParamCallbackPolicy(0, idx+1, 0., 1.)==asynParamBadIndex);
+
+    asynFloat64Client client("portB", -1, "float64");
+    testOk1(client.registerInterruptUser(&float64cb)==asynSuccess);
+
+    testDiag("Deadband");
+    testOk1(portB->setParamCallbackPolicy(0, idx, 0., 1.)==asynSuccess);
+    {
+        Guard G(*portB);
+        portB->setDoubleParam(0, idx, 1.0);
+        portB->callParamCallbacks();
+        testOk1(float64count==1 && lastfloat64==1.0);
+        portB->setDoubleParam(0, idx, 1.5);
+        portB->callParamCallbacks();
+        testOk1(float64count==1 && lastfloat64==1.0);
+        portB->setDoubleParam(0, idx, 2.5);
+        portB->callParamCallbacks();
+        testOk1(float64count==2 && lastfloat64==2.5);
+        // Change of status is always passed on
+        portB->setDoubleParam(0, idx, 2.6);
+        portB->setParamAlarmSeverity(0, idx, 2);
+        portB->callParamCallbacks();
+        testOk1(float64count==3 && lastfloat64==2.6);
+    }
+
+    testDiag("Minimum interval with coalescing");
+    testOk1(portB->setParamCallbackPolicy(0, -1, 0.2, 0.)==asynSuccess);
+    testOk1(portB->getParamCallbackPolicy(0, idx, &minInterval, &deadband)==asynSuccess);
+    testOk1(minInterval==0.2 && deadband==0.);
+    {
+        Guard G(*portB);
+        portB->setDoubleParam(0, idx, 10.0);
+        portB->callParamCallbacks();
+        testOk1(float64count==4 && lastfloat64==10.0);
+        portB->setDoubleParam(0, idx, 11.0);
+        portB->callParamCallbacks();
+        portB->setDoubleParam(0, idx, 12.0);
+        portB->callParamCallbacks();
+        testOk1(float64count==4 && lastfloat64==10.0);
+    }
+    // The deferred callback is done by the flush timer with the latest value
+    epicsThreadSleep(0.5);
+    {
+        Guard G(*portB);
+        testOk1(float64count==5 && lastfloat64==12.0);
+    }
+}
+
+void statisticsProcess(asynUser *pasynUser)
+{
+    epicsThreadSleep(0.01);
+}
+
+void testPortStatistics()
+{
+    asynUser *pasynUser = pasynManager->createAsynUser(statisticsProcess, 0);
+    asynPortStatistics stats;
+    unsigned long binCount = 0;
+
+    testDiag("testPortStatistics()");
+    testOk1(pasynManager->getPortStatistics(pasynUser, &stats)==asynError);
+    testOk1(pasynManager->connectDevice(pasynUser, "portA", -1)==asynSuccess);
+    testOk1(pasynManager->resetPortStatistics(pasynUser)==asynSuccess);
+    testOk1(pasynManager->getPortStatistics(pasynUser, &stats)==asynSuccess);
+    testOk1(stats.lockHold.count==0 && stats.busyFraction==0.);
+
+    // Nested lockPort is counted as one lock hold
+    pasynManager->lockPort(pasynUser);
+    pasynManager->lockPort(pasynUser);
+    epicsThreadSleep(0.01);
+    pasynManager->unlockPort(pasynUser);
+    pasynManager->unlockPort(pasynUser);
+    testOk1(pasynManager->getPortStatistics(pasynUser, &stats)==asynSuccess);
+    testOk1(stats.lockHold.count==1 && stats.lockHold.max>=0.005);
+    testOk1(stats.busyFraction>0. && stats.busyFraction<=1.);
+
+    // portA is synchronous so the callback is called by queueRequest.
+    // portA is not connected, so use the connect priority.
+    testOk1(pasynManager->queueRequest(pasynUser, asynQueuePriorityConnect, 0.)==asynSuccess);
+    testOk1(pasynManager->getPortStatistics(pasynUser, &stats)==asynSuccess);
+    testOk1(stats.service[asynQueuePriorityConnect].count==1);
+    testOk1(stats.service[asynQueuePriorityConnect].max>=0.005);
+    testOk1(stats.queueWait[asynQueuePriorityConnect].count==1);
+    testOk1(stats.lockHold.count==2);
+    for (int i=0; i<ASYN_STATISTICS_BINS; i++)
+        binCount += stats.lockHold.bins[i];
+    testOk1(binCount==stats.lockHold.count);
+
+    pasynManager->freeAsynUser(pasynUser);
+}
+
+void testObjectPools()
+{
+    asynUser *pasynUser = pasynManager->createAsynUser(0, 0);
+    asynUser *pcopy;
+    asynPortStatistics before, after;
+
+    testDiag("testObjectPools()");
+    testOk1(pasynManager->connectDevice(pasynUser, "portA", 0)==asynSuccess);
+
+    // A copy of a connected asynUser comes from the port's pool
+    pcopy = pasynManager->duplicateAsynUser(pasynUser, 0, 0);
+    testOk1(pcopy->errorMessage!=0 && pcopy->errorMessageSize>0);
+    testOk1(pasynManager->getPortStatistics(pasynUser, &before)==asynSuccess);
+    testOk1(before.userPool.gets>=1);
+    testOk1(before.userPool.allocated>=before.userPool.free+1);
+
+    // ... and goes back to it when freed
+    testOk1(pasynManager->freeAsynUser(pcopy)==asynSuccess);
+    testOk1(pasynManager->getPortStatistics(pasynUser, &after)==asynSuccess);
+    testOk1(after.userPool.free==before.userPool.free+1);
+
+    pasynManager->freeAsynUser(pasynUser);
+}
+
+void testTraceBuffer()
+{
+    asynUser *pasynUser = pasynManager->createAsynUser(0, 0);
+    char line[256];
+    bool foundMessage = false, foundData = false;
+    int nRecords = 0;
+    FILE *fp;
+
+    testDiag("testTraceBuffer()");
+    testOk1(pasynManager->connectDevice(pasynUser, "portA", 0)==asynSuccess);
+    testOk1(pasynTrace->dumpTraceBuffer(pasynUser, stdout, 0)==asynError);
+    pasynTrace->setTraceMask(pasynUser, ASYN_TRACE_ERROR|ASYN_TRACEIO_DRIVER);
+    testOk1(pasynTrace->setTraceIOMask(pasynUser, ASYN_TRACEIO_BINARY)==asynSuccess);
+    for (int i=0; i<10; i++)
+        asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, "hello\r\n", 7, "write %d ", i);
+    pasynTrace->setTraceIOMask(pasynUser, 0);
+    pasynTrace->setTraceMask(pasynUser, ASYN_TRACE_ERROR);
+
+    // Only the most recent records are shown
+    fp = tmpfile();
+    testOk1(fp!=0);
+    testOk1(pasynTrace->dumpTraceBuffer(pasynUser, fp, 3)==asynSuccess);
+    rewind(fp);
+    while (fgets(line, sizeof(line), fp)) {
+        if (strstr(line, "[portA,-1,0] driver")) nRecords++;
+        if (strstr(line, "write 9 7 bytes")) foundMessage = true;
+        if (strcmp(line, "hello\\r\\n\n")==0) foundData = true;
+    }
+    fclose(fp);
+    testOk(nRecords==3, "nRecords=%d", nRecords);
+    testOk1(foundMessage);
+    testOk1(foundData);
+
+    // Many more records than the ring holds overwrite the oldest ones
+    pasynTrace->setTraceMask(pasynUser, ASYN_TRACE_ERROR|ASYN_TRACEIO_DRIVER);
+    pasynTrace->setTraceIOMask(pasynUser, ASYN_TRACEIO_BINARY);
+    for (int i=0; i<10000; i++)
+        asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, "hello\r\n", 7, "wrap %d ", i);
+    pasynTrace->setTraceIOMask(pasynUser, 0);
+    pasynTrace->setTraceMask(pasynUser, ASYN_TRACE_ERROR);
+    fp = tmpfile();
+    testOk1(pasynTrace->dumpTraceBuffer(pasynUser, fp, 0)==asynSuccess);
+    rewind(fp);
+    unsigned long written = 0, overwritten = 0, showing = 0;
+    int first = -1, last = -1, wrap;
+    bool inOrder = true;
+    if (fgets(line, sizeof(line), fp))
+        sscanf(line, "portA trace buffer: %lu records written, %lu overwritten, %*u bytes,"
+               " showing %lu", &written, &overwritten, &showing);
+    while (fgets(line, sizeof(line), fp)) {
+        const char *p = strstr(line, "driver wrap ");
+        if (!p || sscanf(p, "driver wrap %d", &wrap)!=1) continue;
+        if (first<0) first = wrap;
+        else if (wrap!=last+1) inOrder = false;
+        last = wrap;
+    }
+    fclose(fp);
+    testOk(written==10010 && overwritten>10 && showing==written-overwritten,
+           "written=%lu overwritten=%lu showing=%lu", written, overwritten, showing);
+    testOk(inOrder && last==9999 && first==(int)overwritten-10,
+           "Records %d to %d survived", first, last);
+
+    pasynManager->freeAsynUser(pasynUser);
+}
+
+size_t batchcount;
+
+void batchcb(asynPortClientBatch *pBatch, void *userPvt)
+{
+    batchcount++;
+    testDiag("batchcb() called with status %d", (int)pBatch->getStatus());
+}
+
+size_t requeuecount;
+bool requeueok = true;
+
+// Queues the batch once more from its callback
+void requeuecb(asynPortClientBatch *pBatch, void *userPvt)
+{
+    requeueok = requeueok && !pBatch->isDone();
+    if (++requeuecount < 2)
+        requeueok = requeueok && pBatch->queue(requeuecb)==asynSuccess;
+}
+
+epicsEventId slowstarted;
+bool slowfinished;
+
+// Still running when the test deletes the batch
+void slowcb(asynPortClientBatch *pBatch, void *userPvt)
+{
+    epicsEventMustTrigger(slowstarted);
+    epicsThreadSleep(0.2);
+    slowfinished = true;
+}
+
+asynPortDriver *portC;
+
+void testClientBatch()
+{
+    int idx;
+    epicsInt32 ival = 0;
+    epicsFloat64 dval = 0.;
+    char str[20] = "";
+
+    testDiag("testClientBatch()");
+    portC = new asynPortDriver("portC", 1,
+                               asynDrvUserMask|asynInt32Mask|asynFloat64Mask|asynOctetMask,
+                               asynInt32Mask|asynFloat64Mask|asynOctetMask, ASYN_CANBLOCK, 1, 0, 0);
+    portC->createParam("i", asynParamInt32, &idx);
+    portC->createParam("d", asynParamFloat64, &idx);
+    portC->createParam("s", asynParamOctet, &idx);
+
+    asynPortClient client("portC");
+    asynPortClientBatch batch(client);
+
+    // All operations run in one request in the port thread
+    batch.write("i", 7);
+    batch.write("d", 2.5);
+    batch.write("s", "abc");
+    batch.read("i", &ival);
+    batch.read("d", &dval);
+    testOk1(batch.read("s", str, sizeof(str))==5);
+    testOk1(batch.queue()==asynSuccess);
+    testOk1(batch.wait(5.0)==asynSuccess);
+    testOk1(batch.isDone());
+    testOk1(ival==7 && dval==2.5 && strcmp(str, "abc")==0);
+
+    batch.clear();
+    batch.write("i", 8);
+    testOk1(batch.queue(batchcb)==asynSuccess);
+    testOk1(batch.wait(5.0)==asynSuccess);
+    testOk1(batchcount==1);
+
+    // The batch is done when its callback runs, so it can be queued again
+    testOk1(batch.queue(requeuecb)==asynSuccess);
+    testOk1(batch.wait(5.0)==asynSuccess);
+    testOk(requeuecount==2 && requeueok, "requeuecount=%d", (int)requeuecount);
+
+    // Deleting a batch waits for a callback in progress
+    asynPortClientBatch *pBatch = new asynPortClientBatch(client);
+    pBatch->write("i", 8);
+    slowstarted = epicsEventMustCreate(epicsEventEmpty);
+    pBatch->queue(slowcb);
+    epicsEventMustWait(slowstarted);
+    delete pBatch;
+    testOk(slowfinished, "Callback finished before the batch was deleted");
+    epicsEventDestroy(slowstarted);
+
+    {
+        asynSubscription<epicsInt32> sub("portC", 0, "i", 2);
+        asynSubscriptionValue<epicsInt32> value;
+
+        testOk1(sub.get(&value, 0)==asynTimeout);
+        batch.clear();
+        batch.write("i", 9);
+        batch.write("i", 10);
+        batch.write("i", 11);
+        batch.queue();
+        batch.wait(5.0);
+        // The stream holds 2 values, so the third callback overflows
+        testOk1(sub.getPending()==2);
+        testOk1(sub.get(&value, 1.0)==asynSuccess && value.value==9);
+        testOk1(sub.get(&value, 1.0)==asynSuccess && value.value==10);
+        testOk1(sub.getOverflows()==1);
+    }
+}
+
 } // namespace
 
 MAIN(asynPortDriverTest)
 {
-    testPlan(54);
+    testPlan(121);
     interruptAccept=1;
     try {
         testA();
+        testCallbackPolicy();
+        testPortStatistics();
+        testObjectPools();
+        testTraceBuffer();
+        testClientBatch();
     } catch(std::exception& e) {
         testAbort("Unhandled C++ exception: %s", e.what());
     }
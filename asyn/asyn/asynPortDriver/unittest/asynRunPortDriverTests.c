@@ -17,12 +17,14 @@
 #include <epicsUnitTest.h>
 
 int asynPortDriverTest(void);
+int asynInterposeWriteCombineTest(void);
 
 void asynRunPortDriverTests(void)
 {
     testHarness();
 
     runTest(asynPortDriverTest);
+    runTest(asynInterposeWriteCombineTest);
 
     /*
      * Report now in case epicsExitTest dies
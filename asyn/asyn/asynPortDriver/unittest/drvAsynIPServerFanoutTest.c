@@ -0,0 +1,176 @@
+/*************************************************************************\
+* asynDriver is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Connects loopback clients to drvAsynIPServerFanout ports and checks
+ * what each full-queue policy does to a client that stops reading.
+ */
+
+#include <string.h>
+
+#include <osiSock.h>
+#include <epicsThread.h>
+#include <epicsUnitTest.h>
+#include <testMain.h>
+
+#include <asynDriver.h>
+#include <asynOctetSyncIO.h>
+#include <drvAsynIPServerPort.h>
+
+#define BASE_PORT   49731
+#define QUEUE_SIZE  4096
+/* Much more than a stalled client's socket buffers and queue can hold */
+#define N_WRITES    2048
+
+static char message[QUEUE_SIZE];
+
+/* A stalled client gets a small receive buffer, so that its queue fills sooner */
+static SOCKET connectClient(unsigned short port, int stalled)
+{
+    struct sockaddr_in addr;
+    struct timeval timeout = {1, 0};
+    int rcvBuf = 4096;
+    SOCKET fd;
+
+    fd = epicsSocketCreate(AF_INET, SOCK_STREAM, 0);
+    if (fd == INVALID_SOCKET)
+        testAbort("Can't create socket");
+    if (stalled)
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, (const void *)&rcvBuf, sizeof(rcvBuf));
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, (const void *)&timeout, sizeof(timeout));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        testAbort("Can't connect to port %u", port);
+    /* Give the event loop time to accept */
+    epicsThreadSleep(0.2);
+    return fd;
+}
+
+/* Reads until nothing arrives for a second; *eof is set if the server closed */
+static size_t drain(SOCKET fd, int *eof)
+{
+    char buffer[QUEUE_SIZE];
+    size_t total = 0;
+    int n;
+
+    *eof = 0;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+        total += n;
+    if (n == 0) *eof = 1;
+    return total;
+}
+
+/* Writes until a write fails, at most N_WRITES times */
+static asynStatus flood(asynUser *pasynUser, int *nWritten)
+{
+    asynStatus status = asynSuccess;
+    size_t nActual;
+
+    for (*nWritten = 0; *nWritten < N_WRITES; (*nWritten)++) {
+        status = pasynOctetSyncIO->write(pasynUser, message, sizeof(message), 0.5, &nActual);
+        if (status != asynSuccess) break;
+    }
+    return status;
+}
+
+static void testDrop(void)
+{
+    asynUser *pasynUser;
+    SOCKET fd[3];
+    char buffer[16];
+    size_t nActual, nRead;
+    int nWritten, eof;
+    asynStatus status;
+
+    testDiag("Drop policy, and clients coming and going");
+    testOk1(drvAsynIPServerFanoutConfigure("fanDrop", "localhost:49731", 2,
+        QUEUE_SIZE, "drop", 0, 0) == 0);
+    pasynOctetSyncIO->connect("fanDrop", 0, &pasynUser, NULL);
+    fd[0] = connectClient(BASE_PORT, 0);
+    fd[1] = connectClient(BASE_PORT, 1);
+
+    testOk1(pasynOctetSyncIO->write(pasynUser, "hello", 5, 1.0, &nActual) == asynSuccess);
+    testOk1(recv(fd[0], buffer, sizeof(buffer), 0) == 5 && memcmp(buffer, "hello", 5) == 0);
+    testOk1(recv(fd[1], buffer, sizeof(buffer), 0) == 5 && memcmp(buffer, "hello", 5) == 0);
+
+    fd[2] = connectClient(BASE_PORT, 0);
+    testOk(recv(fd[2], buffer, sizeof(buffer), 0) == 0, "Third client refused");
+    epicsSocketDestroy(fd[2]);
+
+    epicsSocketDestroy(fd[0]);
+    epicsThreadSleep(0.2);
+    fd[2] = connectClient(BASE_PORT, 0);
+    testOk1(pasynOctetSyncIO->write(pasynUser, "again", 5, 1.0, &nActual) == asynSuccess);
+    testOk(recv(fd[2], buffer, sizeof(buffer), 0) == 5 && memcmp(buffer, "again", 5) == 0,
+        "Client that took a closed client's place");
+    drain(fd[1], &eof);
+    epicsSocketDestroy(fd[2]);
+
+    status = flood(pasynUser, &nWritten);
+    testOk(status == asynSuccess, "%d writes while a client is stalled", nWritten);
+    nRead = drain(fd[1], &eof);
+    testOk(nRead < (size_t)nWritten * QUEUE_SIZE && nRead % QUEUE_SIZE == 0 && !eof,
+        "Stalled client lost whole messages, read %lu bytes", (unsigned long)nRead);
+    testOk1(pasynOctetSyncIO->write(pasynUser, "more", 4, 1.0, &nActual) == asynSuccess);
+    testOk(recv(fd[1], buffer, sizeof(buffer), 0) == 4, "Caught up client is sent to");
+    epicsSocketDestroy(fd[1]);
+    pasynOctetSyncIO->disconnect(pasynUser);
+}
+
+static void testDisconnect(void)
+{
+    asynUser *pasynUser;
+    SOCKET fd;
+    int nWritten, eof;
+    asynStatus status;
+
+    testDiag("Disconnect policy");
+    testOk1(drvAsynIPServerFanoutConfigure("fanDisconnect", "localhost:49732", 2,
+        QUEUE_SIZE, "disconnect", 0, 0) == 0);
+    pasynOctetSyncIO->connect("fanDisconnect", 0, &pasynUser, NULL);
+    fd = connectClient(BASE_PORT + 1, 1);
+    status = flood(pasynUser, &nWritten);
+    testOk(status == asynSuccess, "%d writes while a client is stalled", nWritten);
+    drain(fd, &eof);
+    testOk(eof, "Stalled client was disconnected");
+    epicsSocketDestroy(fd);
+    pasynOctetSyncIO->disconnect(pasynUser);
+}
+
+static void testBlock(void)
+{
+    asynUser *pasynUser;
+    SOCKET fd;
+    size_t nActual;
+    int nWritten, eof;
+    asynStatus status;
+
+    testDiag("Block policy");
+    testOk1(drvAsynIPServerFanoutConfigure("fanBlock", "localhost:49733", 2,
+        QUEUE_SIZE, "block", 0, 0) == 0);
+    pasynOctetSyncIO->connect("fanBlock", 0, &pasynUser, NULL);
+    fd = connectClient(BASE_PORT + 2, 1);
+    status = flood(pasynUser, &nWritten);
+    testOk(status == asynTimeout, "Write timed out after %d writes", nWritten);
+    testOk(drain(fd, &eof) == (size_t)nWritten * QUEUE_SIZE && !eof,
+        "Stalled client got every message written");
+    testOk1(pasynOctetSyncIO->write(pasynUser, message, sizeof(message), 1.0,
+        &nActual) == asynSuccess);
+    epicsSocketDestroy(fd);
+    pasynOctetSyncIO->disconnect(pasynUser);
+}
+
+MAIN(drvAsynIPServerFanoutTest)
+{
+    testPlan(18);
+    memset(message, 'x', sizeof(message));
+    testDrop();
+    testDisconnect();
+    testBlock();
+    return testDone();
+}
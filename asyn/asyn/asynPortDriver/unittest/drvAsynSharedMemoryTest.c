@@ -0,0 +1,130 @@
+/*************************************************************************\
+* asynDriver is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Loops frames through a drvAsynSharedMemory port and the client end
+ * of its segment, both in this process.
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <epicsUnitTest.h>
+#include <testMain.h>
+
+#include <asynDriver.h>
+#include <asynOctet.h>
+#include <asynOctetSyncIO.h>
+#include <asynInt32ArraySyncIO.h>
+#include <drvAsynSharedMemory.h>
+
+#define PORT "shmTest"
+#define SHM_NAME "/asynShmTest"
+
+/* Overwrites both rings, which follow the first page of the segment */
+static void scribble(void)
+{
+    struct stat st;
+    char *pseg;
+    int fd;
+
+    fd = shm_open(SHM_NAME, O_RDWR, 0);
+    if (fd < 0 || fstat(fd, &st) < 0)
+        testAbort("Can't open %s", SHM_NAME);
+    pseg = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pseg == MAP_FAILED)
+        testAbort("Can't map %s", SHM_NAME);
+    memset(pseg + 4096, 0xff, st.st_size - 4096);
+    munmap(pseg, st.st_size);
+}
+
+MAIN(drvAsynSharedMemoryTest)
+{
+    drvAsynShmClient *pclient;
+    drvAsynShmFrameType type;
+    asynUser *pasynUser;
+    epicsInt32 out[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    epicsInt32 in[8];
+    epicsFloat64 dvalue = 1.5;
+    char buffer[16];
+    size_t nIn;
+    int eomReason;
+    asynStatus status;
+
+    testPlan(19);
+
+    /* start with no frames left over from an earlier run */
+    shm_unlink(SHM_NAME);
+    testOk1(drvAsynSharedMemoryConfigure(PORT, SHM_NAME, 4096, 0, 0, 0) == 0);
+    pclient = drvAsynShmClientOpen(SHM_NAME);
+    testOk(pclient != NULL, "Client attached");
+    if (!pclient)
+        testAbort("Can't attach to %s", SHM_NAME);
+
+    testDiag("IOC to client");
+    testOk1(pasynInt32ArraySyncIO->writeOnce(PORT, 0, out, 4, 1.0, NULL) == asynSuccess);
+    memset(in, 0, sizeof(in));
+    status = drvAsynShmClientRead(pclient, &type, in, sizeof(in), &nIn, 1.0);
+    testOk(status == asynSuccess && type == drvAsynShmInt32Array &&
+        nIn == 4 * sizeof(epicsInt32), "Client read %d bytes", (int)nIn);
+    testOk1(memcmp(in, out, 4 * sizeof(epicsInt32)) == 0);
+
+    testOk1(pasynOctetSyncIO->writeOnce(PORT, 0, "hello world", 11, 1.0,
+        &nIn, NULL) == asynSuccess);
+    status = drvAsynShmClientRead(pclient, &type, buffer, 5, &nIn, 1.0);
+    testOk(status == asynOverflow && nIn == 5 && memcmp(buffer, "hello", 5) == 0,
+        "Client buffer too small, status %d", (int)status);
+    testOk1(drvAsynShmClientRead(pclient, &type, buffer, sizeof(buffer), &nIn,
+        0.1) == asynTimeout);
+
+    testDiag("Client to IOC");
+    testOk1(drvAsynShmClientWrite(pclient, drvAsynShmOctet, "abc", 3, 1.0) == asynSuccess);
+    memset(buffer, 0, sizeof(buffer));
+    status = pasynOctetSyncIO->readOnce(PORT, 0, buffer, sizeof(buffer), 1.0,
+        &nIn, &eomReason, NULL);
+    testOk(status == asynSuccess && nIn == 3 && strcmp(buffer, "abc") == 0 &&
+        eomReason == ASYN_EOM_END, "IOC read '%s'", buffer);
+
+    testOk1(drvAsynShmClientWrite(pclient, drvAsynShmInt32Array, out,
+        sizeof(out), 1.0) == asynSuccess);
+    pasynInt32ArraySyncIO->connect(PORT, 0, &pasynUser, NULL);
+    memset(in, 0, sizeof(in));
+    status = pasynInt32ArraySyncIO->read(pasynUser, in, 4, &nIn, 1.0);
+    testOk(status == asynOverflow && nIn == 4, "8 elements into 4, status %d",
+        (int)status);
+    testOk(memcmp(in, out, 4 * sizeof(epicsInt32)) == 0 &&
+        pasynUser->errorMessage[0] != '\0', "%s", pasynUser->errorMessage);
+    status = pasynInt32ArraySyncIO->read(pasynUser, in, 4, &nIn, 0.1);
+    testOk(status == asynTimeout, "Truncated frame was consumed");
+
+    testOk1(drvAsynShmClientWrite(pclient, drvAsynShmFloat64Array, &dvalue,
+        sizeof(dvalue), 1.0) == asynSuccess);
+    status = pasynInt32ArraySyncIO->read(pasynUser, in, 8, &nIn, 1.0);
+    testOk(status == asynError, "Frame of another type discarded, %s",
+        pasynUser->errorMessage);
+    pasynInt32ArraySyncIO->disconnect(pasynUser);
+
+    testDiag("A frame header with an impossible length");
+    drvAsynShmClientWrite(pclient, drvAsynShmOctet, "abc", 3, 1.0);
+    scribble();
+    status = pasynOctetSyncIO->readOnce(PORT, 0, buffer, sizeof(buffer), 0.1,
+        &nIn, &eomReason, NULL);
+    testOk(status == asynTimeout && nIn == 0, "Corrupt frame discarded, status %d",
+        (int)status);
+    testOk1(drvAsynShmClientWrite(pclient, drvAsynShmOctet, "xyz", 3, 1.0) == asynSuccess);
+    memset(buffer, 0, sizeof(buffer));
+    status = pasynOctetSyncIO->readOnce(PORT, 0, buffer, sizeof(buffer), 1.0,
+        &nIn, &eomReason, NULL);
+    testOk(status == asynSuccess && strcmp(buffer, "xyz") == 0,
+        "Next frame read '%s'", buffer);
+
+    drvAsynShmClientClose(pclient);
+    shm_unlink(SHM_NAME);
+    return testDone();
+}
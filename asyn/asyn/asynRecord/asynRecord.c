@@ -91,6 +91,7 @@ static long get_precision(const struct dbAddr * paddr, long *precision);
 static long getIoIntInfo(int cmd, dbCommon *pr, IOSCANPVT *iopvt);
 static void monitor(asynRecord * pasynRec);
 static void monitorStatus(asynRecord * pasynRec);
+static void portStatistics(asynRecord * pasynRec);
 static asynStatus connectDevice(asynRecord * pasynRec);
 static asynStatus registerInterrupts(asynRecord * pasynRec);
 static asynStatus cancelInterrupts(asynRecord * pasynRec);
@@ -200,6 +201,12 @@ typedef struct oldValues {  /* Used in monitor() and monitorStatus() */
     epicsEnum16 tinb3;      /* Trace Info thread */
     char tfil[40];          /* Trace IO file */
     FILE *traceFd;          /* Trace file descriptor */
+    double qwtm;            /* Mean queue wait */
+    double qwtx;            /* Max queue wait */
+    double svtm;            /* Mean service time */
+    double svtx;            /* Max service time */
+    double lktm;            /* Mean lock hold */
+    double busy;            /* Port busy percentage */
     epicsEnum16 auct;       /* Autoconnect */
     epicsEnum16 cnct;       /* Connect/Disconnect */
     epicsEnum16 enbl;       /* Enable/Disable */
@@ -998,6 +1005,16 @@ static long get_precision(const struct dbAddr * paddr, long *precision)
         *precision = 4;
         return (0);
     }
+    if(fieldIndex == asynRecordBUSY) {
+        *precision = 1;
+        return (0);
+    }
+    if((fieldIndex == asynRecordQWTM) || (fieldIndex == asynRecordQWTX) ||
+       (fieldIndex == asynRecordSVTM) || (fieldIndex == asynRecordSVTX) ||
+       (fieldIndex == asynRecordLKTM)) {
+        *precision = 6;
+        return (0);
+    }
     recGblGetPrec(paddr, precision);
     return (0);
 }
@@ -1027,6 +1044,43 @@ static void monitor(asynRecord * pasynRec)
     POST_IF_NEW(i32inp);
     POST_IF_NEW(ui32inp);
     POST_IF_NEW(f64inp);
+    portStatistics(pasynRec);
+    POST_IF_NEW(qwtm);
+    POST_IF_NEW(qwtx);
+    POST_IF_NEW(svtm);
+    POST_IF_NEW(svtx);
+    POST_IF_NEW(lktm);
+    POST_IF_NEW(busy);
+}
+
+static void portStatistics(asynRecord * pasynRec)
+{
+    /* Summarise the port statistics over the I/O queue priorities */
+    asynRecPvt *pasynRecPvt = pasynRec->dpvt;
+    asynPortStatistics statistics;
+    unsigned long nWait = 0, nService = 0;
+    double sumWait = 0., sumService = 0.;
+    int i;
+
+    if(pasynManager->getPortStatistics(pasynRecPvt->pasynUser, &statistics)
+       != asynSuccess) return;
+    pasynRec->qwtx = 0.;
+    pasynRec->svtx = 0.;
+    for(i = asynQueuePriorityLow; i <= asynQueuePriorityHigh; i++) {
+        nWait += statistics.queueWait[i].count;
+        sumWait += statistics.queueWait[i].sum;
+        if(statistics.queueWait[i].max > pasynRec->qwtx)
+            pasynRec->qwtx = statistics.queueWait[i].max;
+        nService += statistics.service[i].count;
+        sumService += statistics.service[i].sum;
+        if(statistics.service[i].max > pasynRec->svtx)
+            pasynRec->svtx = statistics.service[i].max;
+    }
+    pasynRec->qwtm = nWait ? sumWait/nWait : 0.;
+    pasynRec->svtm = nService ? sumService/nService : 0.;
+    pasynRec->lktm = statistics.lockHold.count ?
+        statistics.lockHold.sum/statistics.lockHold.count : 0.;
+    pasynRec->busy = 100. * statistics.busyFraction;
 }
 
 static void monitorStatus(asynRecord * pasynRec)
@@ -16,19 +16,23 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 
 #include <alarm.h>
 #include <recGbl.h>
 #include <dbAccess.h>
 #include <callback.h>
 #include <dbDefs.h>
+#include <dbStaticLib.h>
 #include <link.h>
 #include <errlog.h>
 #include <epicsMutex.h>
+#include <epicsString.h>
 #include <cantProceed.h>
 #include <dbCommon.h>
 #include <dbScan.h>
 #include <waveformRecord.h>
+#include <aiRecord.h>
 #include <recSup.h>
 #include <devSup.h>
 #include <menuFtype.h>
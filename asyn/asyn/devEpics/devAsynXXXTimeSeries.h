@@ -16,6 +16,27 @@
 */ \
  \
  \
+/* Reductions applied to each block of asyn:TS_DECIMATE callback values */ \
+typedef enum { tsReduceFirst, tsReduceMean, tsReduceMin, tsReduceMax, \
+               tsReduceRms, tsReduceHistogram } tsReduceType; \
+static const char *tsReduceNames[] = {"FIRST", "MEAN", "MIN", "MAX", "RMS", "HIST"}; \
+ \
+/* Statistics available to the companion ai device support */ \
+typedef enum { tsStatCount, tsStatMean, tsStatMin, tsStatMax, tsStatRms, \
+               tsStatSigma } tsStatType; \
+static const char *tsStatNames[] = {"COUNT", "MEAN", "MIN", "MAX", "RMS", "SIGMA"}; \
+ \
+/* Running sums, updated once per value; used both for the whole acquisition */ \
+/* and for the block being decimated */ \
+typedef struct tsAccumulator { \
+    epicsUInt32     count; \
+    double          first; \
+    double          sum; \
+    double          sumSq; \
+    double          min; \
+    double          max; \
+} tsAccumulator; \
+ \
 typedef struct devAsynWfPvt{ \
     dbCommon        *pr; \
     asynUser        *pasynUser; \
@@ -30,12 +51,28 @@ typedef struct devAsynWfPvt{ \
     epicsMutexId    lock; \
     int             addr; \
     asynStatus      status; \
+    /* The following are for streaming reductions */ \
+    tsReduceType    reduce; \
+    epicsUInt32     decimate; \
+    double          histLow; \
+    double          histWidth; \
+    tsAccumulator   block; \
+    tsAccumulator   stats; \
+    IOSCANPVT       statsScan; \
 } devAsynWfPvt; \
  \
+typedef struct devAsynStatPvt{ \
+    dbCommon        *pwf; \
+    tsStatType      stat; \
+} devAsynStatPvt; \
+ \
 static long initRecord(dbCommon *pr); \
 static long process(dbCommon *pr); \
-static void interruptCallback(void *drvPvt, asynUser *pasynUser,  \
+static void interruptCallback(void *drvPvt, asynUser *pasynUser, \
                 EPICS_TYPE value); \
+static long initStatRecord(dbCommon *pr); \
+static long getStatIoIntInfo(int cmd, dbCommon *pr, IOSCANPVT *iopvt); \
+static long processStat(dbCommon *pr); \
  \
 typedef struct analogDset { /* analog  dset */ \
     long        number; \
@@ -49,11 +86,104 @@ typedef struct analogDset { /* analog  dset */ \
  \
 analogDset DSET = \
     {6, 0, 0, initRecord,    0, process, 0}; \
+analogDset DSET##Stat = \
+    {6, 0, 0, initStatRecord, getStatIoIntInfo, processStat, 0}; \
  \
 epicsExportAddress(dset, DSET); \
-\
+epicsExportAddress(dset, DSET##Stat); \
+ \
 static char *driverName = DRIVER_NAME; \
  \
+static void accumulatorReset(tsAccumulator *pacc) \
+{ \
+    memset(pacc, 0, sizeof(*pacc)); \
+} \
+ \
+static void accumulatorAdd(tsAccumulator *pacc, double value) \
+{ \
+    if (pacc->count == 0) { \
+        pacc->first = value; \
+        pacc->min = value; \
+        pacc->max = value; \
+    } \
+    else { \
+        if (value < pacc->min) pacc->min = value; \
+        if (value > pacc->max) pacc->max = value; \
+    } \
+    pacc->sum += value; \
+    pacc->sumSq += value*value; \
+    pacc->count++; \
+} \
+ \
+static double accumulatorReduce(tsAccumulator *pacc, tsReduceType reduce) \
+{ \
+    switch (reduce) { \
+      case tsReduceMean: return pacc->sum/pacc->count; \
+      case tsReduceMin:  return pacc->min; \
+      case tsReduceMax:  return pacc->max; \
+      case tsReduceRms:  return sqrt(pacc->sumSq/pacc->count); \
+      default:           return pacc->first; \
+    } \
+} \
+ \
+static long initReduction(dbCommon *pr) \
+{ \
+    waveformRecord *pwf = (waveformRecord *)pr; \
+    devAsynWfPvt *pPvt = (devAsynWfPvt *)pr->dpvt; \
+    DBENTRY *pdbentry = dbAllocEntry(pdbbase); \
+    const char *infoString; \
+    double histHigh = 0.; \
+    long status = 0; \
+    int i; \
+ \
+    pPvt->reduce = tsReduceFirst; \
+    pPvt->decimate = 1; \
+    if (dbFindRecord(pdbentry, pr->name)) { \
+        errlogPrintf("%s::initReduction, %s error finding record\n", \
+                     driverName, pr->name); \
+        status = -1; \
+        goto done; \
+    } \
+    infoString = dbGetInfo(pdbentry, "asyn:TS_DECIMATE"); \
+    if (infoString && atoi(infoString) > 1) pPvt->decimate = atoi(infoString); \
+    infoString = dbGetInfo(pdbentry, "asyn:TS_REDUCE"); \
+    if (infoString) { \
+        for (i=0; i<(int)(sizeof(tsReduceNames)/sizeof(tsReduceNames[0])); i++) { \
+            if (epicsStrCaseCmp(infoString, tsReduceNames[i]) == 0) break; \
+        } \
+        if (i == sizeof(tsReduceNames)/sizeof(tsReduceNames[0])) { \
+            errlogPrintf("%s::initReduction, %s unknown asyn:TS_REDUCE \"%s\"\n", \
+                         driverName, pr->name, infoString); \
+            status = -1; \
+            goto done; \
+        } \
+        pPvt->reduce = (tsReduceType)i; \
+    } \
+    if (pPvt->reduce == tsReduceHistogram) { \
+        infoString = dbGetInfo(pdbentry, "asyn:TS_HIST_LOW"); \
+        if (infoString) pPvt->histLow = atof(infoString); \
+        infoString = dbGetInfo(pdbentry, "asyn:TS_HIST_HIGH"); \
+        if (infoString) histHigh = atof(infoString); \
+        if (histHigh <= pPvt->histLow) { \
+            errlogPrintf("%s::initReduction, %s asyn:TS_HIST_HIGH must be greater than asyn:TS_HIST_LOW\n", \
+                         driverName, pr->name); \
+            status = -1; \
+            goto done; \
+        } \
+        pPvt->histWidth = (histHigh - pPvt->histLow)/pwf->nelm; \
+        /* A histogram is complete after asyn:TS_DECIMATE values */ \
+        if (pPvt->decimate < 2) { \
+            errlogPrintf("%s::initReduction, %s asyn:TS_DECIMATE must give the values in each histogram\n", \
+                         driverName, pr->name); \
+            status = -1; \
+            goto done; \
+        } \
+    } \
+done: \
+    dbFreeEntry(pdbentry); \
+    return status; \
+} \
+ \
 static long initRecord(dbCommon *pr) \
 { \
     waveformRecord *pwf = (waveformRecord *)pr; \
@@ -66,6 +196,7 @@ static long initRecord(dbCommon *pr) \
     pr->dpvt = pPvt; \
     pPvt->pr = pr; \
     pPvt->lock = epicsMutexCreate(); \
+    scanIoInit(&pPvt->statsScan); \
     pasynUser = pasynManager->createAsynUser(0, 0); \
     pasynUser->userPvt = pPvt; \
     pPvt->pasynUser = pasynUser; \
@@ -75,6 +206,7 @@ static long initRecord(dbCommon *pr) \
                      driverName, pr->name); \
         goto bad; \
     } \
+    if (initReduction(pr)) goto bad; \
     /* Parse the link to get addr and port */ \
     status = pasynEpicsUtils->parseLink(pasynUser, (DBLINK *)&pwf->inp, \
                 &pPvt->portName, &pPvt->addr, &pPvt->userParam); \
@@ -121,6 +253,8 @@ bad: \
 } \
  \
  \
+ \
+ \
 static long process(dbCommon *pr) \
 { \
     devAsynWfPvt *pPvt = (devAsynWfPvt *)pr->dpvt; \
@@ -139,6 +273,8 @@ static long process(dbCommon *pr) \
         pPvt->nord = 0; \
         busy = 1; \
         memset(pwf->bptr, 0, pwf->nelm*sizeof(EPICS_TYPE)); \
+        accumulatorReset(&pPvt->block); \
+        accumulatorReset(&pPvt->stats); \
         break; \
       case 2: \
         busy = 0; \
@@ -165,7 +301,7 @@ static long process(dbCommon *pr) \
                 pr->name, driverName, pPvt->pasynUser->errorMessage); \
         } \
       } \
-      else {\
+      else { \
         status = pPvt->pInterface->cancelInterruptUser( \
            pPvt->ifacePvt, pPvt->pasynUser, pPvt->registrarPvt); \
         if(status!=asynSuccess) { \
@@ -185,8 +321,10 @@ static long process(dbCommon *pr) \
     } \
     epicsMutexUnlock(pPvt->lock); \
     pPvt->status = asynSuccess; \
+    /* Let the statistics records pick up the new values */ \
+    scanIoRequest(pPvt->statsScan); \
     return 0; \
-}  \
+} \
  \
 static void interruptCallback(void *drvPvt, asynUser *pasynUser, EPICS_TYPE value) \
 { \
@@ -198,11 +336,35 @@ static void interruptCallback(void *drvPvt, asynUser *pasynUser, EPICS_TYPE valu
     asynPrint(pPvt->pasynUser, ASYN_TRACEIO_DEVICE, \
         "%s %s::interruptCallback, value=%f, nord=%d\n", \
         pwf->name, driverName, (double)value, pPvt->nord); \
-    /* If we are not acquiring then nothing to do */  \
+    /* If we are not acquiring then nothing to do */ \
     if (pPvt->busy) { \
-      if (pPvt->nord < pwf->nelm) { \
-        pData[pPvt->nord] = value; \
-        pPvt->nord++; \
+      if (pPvt->reduce == tsReduceHistogram) { \
+        double bin = floor(((double)value - pPvt->histLow)/pPvt->histWidth); \
+        accumulatorAdd(&pPvt->stats, (double)value); \
+        if ((bin >= 0.) && (bin < pwf->nelm)) pData[(epicsUInt32)bin]++; \
+        pPvt->nord = pwf->nelm; \
+        /* block counts the values since the last complete histogram */ \
+        accumulatorAdd(&pPvt->block, (double)value); \
+        if (pPvt->block.count >= pPvt->decimate) { \
+          accumulatorReset(&pPvt->block); \
+          pPvt->busy = 0; \
+          callbackRequestProcessCallback(&pPvt->callback,pwf->prio,pwf); \
+        } \
+      } \
+      else if (pPvt->nord < pwf->nelm) { \
+        accumulatorAdd(&pPvt->stats, (double)value); \
+        if (pPvt->decimate == 1 && pPvt->reduce != tsReduceRms) { \
+          pData[pPvt->nord] = value; \
+          pPvt->nord++; \
+        } \
+        else { \
+          accumulatorAdd(&pPvt->block, (double)value); \
+          if (pPvt->block.count >= pPvt->decimate) { \
+            pData[pPvt->nord] = (EPICS_TYPE)accumulatorReduce(&pPvt->block, pPvt->reduce); \
+            pPvt->nord++; \
+            accumulatorReset(&pPvt->block); \
+          } \
+        } \
       } \
       else { \
         pPvt->busy = 0; \
@@ -213,4 +375,92 @@ static void interruptCallback(void *drvPvt, asynUser *pasynUser, EPICS_TYPE valu
     if (pPvt->status == asynSuccess) pPvt->status = pasynUser->auxStatus; \
     epicsMutexUnlock(pPvt->lock); \
 } \
+ \
+/* The ai statistics records have INP "@waveformName STAT" */ \
+static long initStatRecord(dbCommon *pr) \
+{ \
+    aiRecord *pai = (aiRecord *)pr; \
+    devAsynStatPvt *pPvt; \
+    DBADDR addr; \
+    char recordName[PVNAME_STRINGSZ]; \
+    char statName[20]; \
+    int i; \
+ \
+    pPvt = callocMustSucceed(1, sizeof(*pPvt), "devAsynXXXTimeSeries::initStatRecord"); \
+    pr->dpvt = pPvt; \
+    if ((pai->inp.type != INST_IO) || \
+        (sscanf(pai->inp.value.instio.string, "%60s %19s", recordName, statName) != 2)) { \
+        errlogPrintf("%s::initStatRecord, %s INP must be \"@record STAT\"\n", \
+                     driverName, pr->name); \
+        goto bad; \
+    } \
+    for (i=0; i<(int)(sizeof(tsStatNames)/sizeof(tsStatNames[0])); i++) { \
+        if (epicsStrCaseCmp(statName, tsStatNames[i]) == 0) break; \
+    } \
+    if (i == sizeof(tsStatNames)/sizeof(tsStatNames[0])) { \
+        errlogPrintf("%s::initStatRecord, %s unknown statistic %s\n", \
+                     driverName, pr->name, statName); \
+        goto bad; \
+    } \
+    pPvt->stat = (tsStatType)i; \
+    if (dbNameToAddr(recordName, &addr) || \
+        (addr.precord->dset != (struct dset *)&DSET)) { \
+        errlogPrintf("%s::initStatRecord, %s %s is not a %s waveform record\n", \
+                     driverName, pr->name, recordName, #DSET); \
+        goto bad; \
+    } \
+    pPvt->pwf = addr.precord; \
+    return 0; \
+bad: \
+   pr->pact=1; \
+   return -1; \
+} \
+ \
+static long getStatIoIntInfo(int cmd, dbCommon *pr, IOSCANPVT *iopvt) \
+{ \
+    devAsynStatPvt *pPvt = (devAsynStatPvt *)pr->dpvt; \
+    devAsynWfPvt *pwfPvt; \
+ \
+    if (!pPvt->pwf || !pPvt->pwf->dpvt) return -1; \
+    pwfPvt = (devAsynWfPvt *)pPvt->pwf->dpvt; \
+    *iopvt = pwfPvt->statsScan; \
+    return 0; \
+} \
+ \
+static long processStat(dbCommon *pr) \
+{ \
+    aiRecord *pai = (aiRecord *)pr; \
+    devAsynStatPvt *pPvt = (devAsynStatPvt *)pr->dpvt; \
+    devAsynWfPvt *pwfPvt = (devAsynWfPvt *)pPvt->pwf->dpvt; \
+    tsAccumulator stats; \
+    double mean; \
+ \
+    if (!pwfPvt) { \
+        recGblSetSevr(pr, UDF_ALARM, INVALID_ALARM); \
+        return 2; \
+    } \
+    epicsMutexLock(pwfPvt->lock); \
+    stats = pwfPvt->stats; \
+    epicsMutexUnlock(pwfPvt->lock); \
+    if (pPvt->stat == tsStatCount) { \
+        pai->val = stats.count; \
+    } \
+    else if (stats.count == 0) { \
+        recGblSetSevr(pr, UDF_ALARM, INVALID_ALARM); \
+        return 2; \
+    } \
+    else { \
+        mean = stats.sum/stats.count; \
+        switch (pPvt->stat) { \
+          case tsStatMean:  pai->val = mean; break; \
+          case tsStatMin:   pai->val = stats.min; break; \
+          case tsStatMax:   pai->val = stats.max; break; \
+          case tsStatRms:   pai->val = sqrt(stats.sumSq/stats.count); break; \
+          case tsStatSigma: pai->val = sqrt(fabs(stats.sumSq/stats.count - mean*mean)); break; \
+          default: break; \
+        } \
+    } \
+    pai->udf = 0; \
+    return 2; \
+} \
 
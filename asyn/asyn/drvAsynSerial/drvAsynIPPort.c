@@ -46,6 +46,7 @@
 #include <iocsh.h>
 #include <epicsAssert.h>
 #include <epicsExit.h>
+#include <epicsMutex.h>
 #include <epicsStdio.h>
 #include <epicsString.h>
 #include <epicsThread.h>
@@ -96,9 +97,32 @@
 /* This delay is how long to wait in seconds after a send fails with errno ==
  * EAGAIN or EINTR before trying again */
 #define SEND_RETRY_DELAY 0.01
+/* Default time to wait for a TCP connection to be established */
+#define DEFAULT_CONNECT_TIMEOUT 5.0
+/* Default time that a host name lookup is reused by all ports */
+#define DEFAULT_HOST_CACHE_TIMEOUT 60.0
 
 #define ISCOM_UNKNOWN (-1)
 
+/*
+ * Host name lookups are shared by all ports.  hostToIPAddr is serialized
+ * by a global lock in libCom, so without the cache a farm of ports to
+ * hosts with a slow name server would reconnect one lookup at a time.
+ */
+typedef struct hostCacheEntry {
+    ELLNODE        node;
+    char           *hostName;
+    epicsMutexId   lookupLock;  /* Only one lookup of a host at a time */
+    int            valid;
+    struct in_addr addr;
+    unsigned long  generation;  /* Incremented by every successful lookup */
+    epicsTimeStamp lookupTime;
+} hostCacheEntry;
+
+static ELLLIST      hostCacheList;
+static epicsMutexId hostCacheLock;
+static double       hostCacheTimeout = DEFAULT_HOST_CACHE_TIMEOUT;
+
 /*
  * This structure holds the hardware-specific information for a single
  * asyn link.  There is one for each IP socket.
@@ -112,6 +136,9 @@ typedef struct {
     int                flags;
     int                isCom;
     int                disconnectOnReadTimeout;
+    double             connectTimeout;
+    hostCacheEntry     *phostCache;
+    unsigned long      hostGeneration;  /* of the cached address in farAddr */
     SOCKET             fd;
     unsigned long      nRead;
     unsigned long      nWritten;
@@ -199,6 +226,135 @@ static int setNonBlock(SOCKET fd, int nonBlockFlag)
     return 0;
 }
 
+/*
+ * Look up a host through the shared cache
+ */
+static hostCacheEntry *hostCacheFind(const char *hostName)
+{
+    hostCacheEntry *pentry;
+
+    epicsMutexMustLock(hostCacheLock);
+    for (pentry = (hostCacheEntry *)ellFirst(&hostCacheList); pentry;
+         pentry = (hostCacheEntry *)ellNext(&pentry->node)) {
+        if (epicsStrCaseCmp(pentry->hostName, hostName) == 0) break;
+    }
+    if (!pentry) {
+        pentry = callocMustSucceed(1, sizeof(*pentry), "drvAsynIPPort:hostCacheFind");
+        pentry->hostName = epicsStrDup(hostName);
+        pentry->lookupLock = epicsMutexMustCreate();
+        ellAdd(&hostCacheList, &pentry->node);
+    }
+    epicsMutexUnlock(hostCacheLock);
+    return pentry;
+}
+
+static int hostCacheLookup(ttyController_t *tty, struct in_addr *paddr)
+{
+    hostCacheEntry *pentry;
+    epicsTimeStamp now;
+    int status = 0;
+
+    if (!tty->phostCache) tty->phostCache = hostCacheFind(tty->IPHostName);
+    pentry = tty->phostCache;
+    epicsMutexMustLock(pentry->lookupLock);
+    epicsTimeGetCurrent(&now);
+    if (!pentry->valid || (hostCacheTimeout <= 0)
+     || (epicsTimeDiffInSeconds(&now, &pentry->lookupTime) > hostCacheTimeout)) {
+        if (hostToIPAddr(pentry->hostName, &pentry->addr) < 0) {
+            pentry->valid = 0;
+            status = -1;
+        } else {
+            pentry->valid = 1;
+            pentry->generation++;
+            pentry->lookupTime = now;
+        }
+    }
+    if (status == 0) {
+        *paddr = pentry->addr;
+        tty->hostGeneration = pentry->generation;
+    }
+    epicsMutexUnlock(pentry->lookupLock);
+    return status;
+}
+
+/*
+ * Called when a connection to a looked up address fails, in case the device
+ * has DHCP'd itself a new number.  Only the first port to fail with an address
+ * discards it, so the other ports of the same host do not repeat the lookup.
+ */
+static void hostCacheInvalidate(ttyController_t *tty)
+{
+    hostCacheEntry *pentry = tty->phostCache;
+
+    if (!pentry) return;
+    epicsMutexMustLock(pentry->lookupLock);
+    if (pentry->generation == tty->hostGeneration) pentry->valid = 0;
+    epicsMutexUnlock(pentry->lookupLock);
+}
+
+/*
+ * Connect a socket, waiting at most connectTimeout for a TCP connection
+ */
+static int connectSocket(ttyController_t *tty, SOCKET fd, asynUser *pasynUser)
+{
+#ifdef USE_POLL
+    struct pollfd pollfd;
+    int error;
+    osiSocklen_t len = sizeof(error);
+    int timeout;
+
+    if (setNonBlock(fd, 1) < 0) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                               "Can't set %s O_NONBLOCK option: %s",
+                                       tty->IPDeviceName, strerror(SOCKERRNO));
+        return -1;
+    }
+    if (connect(fd, &tty->farAddr.oa.sa, (int)tty->farAddrSize) == 0)
+        return 0;
+    error = SOCKERRNO;
+    if ((error != SOCK_EINPROGRESS) && (error != SOCK_EWOULDBLOCK)) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                      "Can't connect to %s: %s",
+                      tty->IPDeviceName, strerror(error));
+        return -1;
+    }
+    timeout = (tty->connectTimeout > 0) ? (int)(tty->connectTimeout * 1000.0) : -1;
+    pollfd.fd = fd;
+    pollfd.events = POLLOUT;
+    pollfd.revents = 0;
+    error = poll(&pollfd, 1, timeout);
+    if (error == 0) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                      "Can't connect to %s: timeout after %g seconds",
+                      tty->IPDeviceName, tty->connectTimeout);
+        return -1;
+    }
+    if (error < 0) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                      "Can't connect to %s: poll failed: %s",
+                      tty->IPDeviceName, strerror(SOCKERRNO));
+        return -1;
+    }
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, (void *)&error, &len) < 0)
+        error = SOCKERRNO;
+    if (error) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                      "Can't connect to %s: %s",
+                      tty->IPDeviceName, strerror(error));
+        return -1;
+    }
+    return 0;
+#else
+    if (connect(fd, &tty->farAddr.oa.sa, (int)tty->farAddrSize) < 0) {
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                      "Can't connect to %s: %s",
+                      tty->IPDeviceName, strerror(SOCKERRNO));
+        return -1;
+    }
+    return 0;
+#endif
+}
+
 /*
  * Close a connection
  */
@@ -235,6 +391,16 @@ asynCommonReport(void *drvPvt, FILE *fp, int details)
         fprintf(fp, "                    fd: %d\n", (int)tty->fd);
         fprintf(fp, "    Characters written: %lu\n", tty->nWritten);
         fprintf(fp, "       Characters read: %lu\n", tty->nRead);
+        fprintf(fp, "       Connect timeout: %g\n", tty->connectTimeout);
+        if (tty->phostCache && tty->phostCache->valid) {
+            char addr[40];
+            epicsTimeStamp now;
+
+            ipAddrToDottedIP(&tty->farAddr.oa.ia, addr, sizeof addr);
+            epicsTimeGetCurrent(&now);
+            fprintf(fp, "      Host address: %s, looked up %.0f seconds ago\n", addr,
+                    epicsTimeDiffInSeconds(&now, &tty->phostCache->lookupTime));
+        }
     }
 }
 
@@ -294,6 +460,7 @@ static int parseHostInfo(ttyController_t *tty, const char* hostInfo)
         free(tty->IPHostName);
         tty->IPHostName = NULL;
     }
+    tty->phostCache = NULL;
     tty->IPDeviceName = epicsStrDup(hostInfo);
 
     /*
@@ -482,7 +649,7 @@ connectIt(void *drvPvt, asynUser *pasynUser)
          * has just appeared in a DNS database.
          */
         if (tty->flags & FLAG_NEED_LOOKUP) {
-            if(hostToIPAddr(tty->IPHostName, &tty->farAddr.oa.ia.sin_addr) < 0) {
+            if(hostCacheLookup(tty, &tty->farAddr.oa.ia.sin_addr) < 0) {
                 epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
                                             "Unknown host \"%s\"", tty->IPHostName);
                 epicsSocketDestroy(fd);
@@ -511,13 +678,12 @@ connectIt(void *drvPvt, asynUser *pasynUser)
          * problem is just that the device has DHCP'd itself an new number.
          */
         if (tty->socketType != SOCK_DGRAM) {
-            if (connect(fd, &tty->farAddr.oa.sa, (int)tty->farAddrSize) < 0) {
-                epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
-                              "Can't connect to %s: %s",
-                              tty->IPDeviceName, strerror(SOCKERRNO));
+            if (connectSocket(tty, fd, pasynUser) < 0) {
                 epicsSocketDestroy(fd);
-                if (tty->flags & FLAG_DONE_LOOKUP)
+                if (tty->flags & FLAG_DONE_LOOKUP) {
                     tty->flags |=  FLAG_NEED_LOOKUP;
+                    hostCacheInvalidate(tty);
+                }
                 return asynError;
             }
         }
@@ -899,6 +1065,9 @@ getOption(void *drvPvt, asynUser *pasynUser,
     else if (epicsStrCaseCmp(key, "hostInfo") == 0) {
         l = epicsSnprintf(val, valSize, "%s", tty->IPDeviceName);
     }
+    else if (epicsStrCaseCmp(key, "connectTimeout") == 0) {
+        l = epicsSnprintf(val, valSize, "%g", tty->connectTimeout);
+    }
     else {
         epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
                                                 "Unsupported key \"%s\"", key);
@@ -938,6 +1107,15 @@ setOption(void *drvPvt, asynUser *pasynUser, const char *key, const char *val)
         int status = parseHostInfo(tty, val);
         if (status) return asynError;
     }
+    else if (epicsStrCaseCmp(key, "connectTimeout") == 0) {
+        double timeout;
+        if (sscanf(val, "%lf", &timeout) != 1) {
+            epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                                                    "Invalid connectTimeout value.");
+            return asynError;
+        }
+        tty->connectTimeout = timeout;
+    }
     else if (epicsStrCaseCmp(key, "") != 0) {
         epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
                                                 "Unsupported key \"%s\"", key);
@@ -993,6 +1171,7 @@ drvAsynIPPortConfigure(const char *portName,
             printf("drvAsynIPPortConfigure: osiSockAttach failed\n");
             return -1;
         }
+        hostCacheLock = epicsMutexMustCreate();
     }
 
     /*
@@ -1005,6 +1184,7 @@ drvAsynIPPortConfigure(const char *portName,
     tty->portName = epicsStrDup(portName);
     tty->fd = INVALID_SOCKET;
     tty->isCom =  ISCOM_UNKNOWN;
+    tty->connectTimeout = DEFAULT_CONNECT_TIMEOUT;
 
     /*
      * Create socket from hostInfo
@@ -1099,6 +1279,16 @@ static void drvAsynIPPortConfigureCallFunc(const iocshArgBuf *args)
                            args[3].ival, args[4].ival);
 }
 
+static const iocshArg drvAsynIPHostCacheTimeoutArg0 = { "seconds",iocshArgDouble};
+static const iocshArg *drvAsynIPHostCacheTimeoutArgs[] = {
+    &drvAsynIPHostCacheTimeoutArg0};
+static const iocshFuncDef drvAsynIPHostCacheTimeoutFuncDef =
+                      {"drvAsynIPHostCacheTimeout",1,drvAsynIPHostCacheTimeoutArgs};
+static void drvAsynIPHostCacheTimeoutCallFunc(const iocshArgBuf *args)
+{
+    hostCacheTimeout = args[0].dval;
+}
+
 /*
  * This routine is called before multitasking has started, so there's
  * no race condition in the test/set of firstTime.
@@ -1109,6 +1299,7 @@ drvAsynIPPortRegisterCommands(void)
     static int firstTime = 1;
     if (firstTime) {
         iocshRegister(&drvAsynIPPortConfigureFuncDef,drvAsynIPPortConfigureCallFunc);
+        iocshRegister(&drvAsynIPHostCacheTimeoutFuncDef,drvAsynIPHostCacheTimeoutCallFunc);
         firstTime = 0;
     }
 }
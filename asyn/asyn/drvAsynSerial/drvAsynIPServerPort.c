@@ -26,6 +26,8 @@
 #include <iocsh.h>
 #include <epicsExit.h>
 #include <epicsAssert.h>
+#include <epicsEvent.h>
+#include <epicsMutex.h>
 #include <epicsStdio.h>
 #include <epicsString.h>
 #include <epicsThread.h>
@@ -42,6 +44,23 @@
 #include "drvAsynIPServerPort.h"
 #include "drvAsynIPPort.h"
 
+/* The fan-out server needs poll() */
+#if !defined(__rtems__) && !defined(vxWorks)
+# if defined(_WIN32)
+#  if defined(POLLIN)
+#   define poll(fd,nfd,t) WSAPoll(fd,nfd,t)
+#   define USE_FANOUT
+#  endif
+# else
+#  include <poll.h>
+#  define USE_FANOUT
+# endif
+#endif
+
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
 /* This structure holds the information for an IP port created by the listener */
 typedef struct {
     char               *portName;
@@ -81,6 +100,58 @@ typedef struct {
 
 #define THEORETICAL_UDP_MAX_SIZE 65507
 
+/*
+ * Fan-out server.
+ * A single thread accepts connections and services all clients with poll().
+ * asynOctet->write copies the buffer into a ring for each client.
+ */
+typedef enum {
+    fanoutPolicyDrop,       /* drop the message for a client whose ring is full */
+    fanoutPolicyDisconnect, /* disconnect a client whose ring is full */
+    fanoutPolicyBlock       /* wait until every client has room */
+} fanoutPolicy;
+
+static const char *fanoutPolicyName[] = {"drop", "disconnect", "block"};
+
+typedef struct {
+    SOCKET             fd;
+    int                closePending;
+    char               address[64];
+    char              *ring;    /* queueSize bytes while connected */
+    size_t             head;    /* oldest queued byte */
+    size_t             count;   /* bytes queued */
+    unsigned long      nWritten;
+    unsigned long      nDropped;
+} fanoutClient;
+
+typedef struct {
+    asynUser          *pasynUser;
+    char              *portName;
+    char              *serverInfo;
+    unsigned int       portNumber;
+    int                maxClients;
+    size_t             queueSize;
+    fanoutPolicy       policy;
+    SOCKET             fd;        /* listening socket */
+    int                closeListener; /* fd is closed by fanoutEventLoop */
+    SOCKET             wakeupFd;  /* loopback datagram socket to wake poll */
+    osiSockAddr        wakeupAddr;
+    epicsMutexId       lock;
+    epicsEventId       spaceAvailable;
+    fanoutClient      *clients;
+    int                nClients;
+    asynInterface      common;
+    asynInterface      octet;
+    void              *octetCallbackPvt;
+    char              *readBuffer;
+    unsigned long      nBroadcast;
+    unsigned long      nRead;
+    unsigned long      nAccepted;
+    unsigned long      nRefused;
+} fanoutController_t;
+
+#define FANOUT_READ_BUFFER_SIZE 4096
+
 /* Function prototypes */
 static void serialBaseInit(void);
 static void closeConnection(asynUser *pasynUser, ttyController_t *tty);
@@ -685,6 +756,589 @@ int drvAsynIPServerPortConfigure(const char *portName,
     return 0;
 }
 
+#ifdef USE_FANOUT
+/*
+ * Fan-out server
+ */
+static void fanoutWakeup(fanoutController_t *fan)
+{
+    char c = 0;
+
+    sendto(fan->wakeupFd, &c, 1, 0, &fan->wakeupAddr.sa,
+           sizeof(fan->wakeupAddr.ia));
+}
+
+/*
+ * Queue data for a client, sending directly if nothing is queued.
+ * Called with fan->lock held.
+ */
+static void fanoutQueue(fanoutController_t *fan, fanoutClient *pc,
+                        const char *data, size_t numchars)
+{
+    size_t tail, n;
+
+    if (pc->count == 0) {
+        int nSent = send(pc->fd, data, (int)numchars, MSG_NOSIGNAL);
+        if (nSent < 0) {
+            if ((SOCKERRNO != SOCK_EWOULDBLOCK) && (SOCKERRNO != SOCK_EINTR)) {
+                pc->closePending = 1;
+                return;
+            }
+        }
+        else {
+            pc->nWritten += nSent;
+            data += nSent;
+            numchars -= nSent;
+        }
+        pc->head = 0;
+    }
+    while (numchars > 0) {
+        tail = (pc->head + pc->count) % fan->queueSize;
+        n = fan->queueSize - tail;
+        if (n > numchars) n = numchars;
+        memcpy(pc->ring + tail, data, n);
+        pc->count += n;
+        data += n;
+        numchars -= n;
+    }
+}
+
+/*
+ * Send as much queued data as the socket accepts.
+ * Called with fan->lock held. Returns -1 if the client must be closed.
+ */
+static int fanoutFlushClient(fanoutController_t *fan, fanoutClient *pc)
+{
+    while (pc->count > 0) {
+        size_t n = fan->queueSize - pc->head;
+        int nSent;
+
+        if (n > pc->count) n = pc->count;
+        nSent = send(pc->fd, pc->ring + pc->head, (int)n, MSG_NOSIGNAL);
+        if (nSent < 0) {
+            if ((SOCKERRNO == SOCK_EWOULDBLOCK) || (SOCKERRNO == SOCK_EINTR))
+                return 0;
+            return -1;
+        }
+        if (nSent == 0)
+            return 0;
+        pc->nWritten += nSent;
+        pc->head = (pc->head + nSent) % fan->queueSize;
+        pc->count -= nSent;
+    }
+    return 0;
+}
+
+/*
+ * Called with fan->lock held
+ */
+static void fanoutCloseClient(fanoutController_t *fan, fanoutClient *pc)
+{
+    asynPrint(fan->pasynUser, ASYN_TRACE_FLOW,
+            "drvAsynIPServerPort: %s close client %s\n",
+            fan->portName, pc->address);
+    epicsSocketDestroy(pc->fd);
+    pc->fd = INVALID_SOCKET;
+    pc->closePending = 0;
+    pc->count = 0;
+    free(pc->ring);
+    pc->ring = NULL;
+    fan->nClients--;
+    if (fan->policy == fanoutPolicyBlock)
+        epicsEventSignal(fan->spaceAvailable);
+}
+
+static void fanoutAccept(fanoutController_t *fan)
+{
+    osiSockAddr clientAddr;
+    osiSocklen_t clientLen = sizeof(clientAddr);
+    osiSockIoctl_t nonBlock = 1;
+    fanoutClient *pc = NULL;
+    SOCKET clientFd;
+    char *ring;
+    int i;
+
+    clientFd = epicsSocketAccept(fan->fd, &clientAddr.sa, &clientLen);
+    if (clientFd == INVALID_SOCKET)
+        return;
+    ring = malloc(fan->queueSize);
+    if (ring == NULL) {
+        asynPrint(fan->pasynUser, ASYN_TRACE_ERROR,
+            "drvAsynIPServerPort: %s: no memory for client queue\n", fan->portName);
+        epicsSocketDestroy(clientFd);
+        return;
+    }
+    epicsMutexMustLock(fan->lock);
+    for (i = 0; i < fan->maxClients; i++) {
+        if (fan->clients[i].fd == INVALID_SOCKET) {
+            pc = &fan->clients[i];
+            break;
+        }
+    }
+    if (pc == NULL) {
+        fan->nRefused++;
+        epicsMutexUnlock(fan->lock);
+        asynPrint(fan->pasynUser, ASYN_TRACE_ERROR,
+            "drvAsynIPServerPort: %s: too many clients\n", fan->portName);
+        epicsSocketDestroy(clientFd);
+        free(ring);
+        return;
+    }
+    socket_ioctl(clientFd, FIONBIO, &nonBlock);
+    ipAddrToDottedIP(&clientAddr.ia, pc->address, sizeof(pc->address));
+    pc->fd = clientFd;
+    pc->ring = ring;
+    pc->head = 0;
+    pc->count = 0;
+    pc->closePending = 0;
+    pc->nWritten = 0;
+    pc->nDropped = 0;
+    fan->nClients++;
+    fan->nAccepted++;
+    epicsMutexUnlock(fan->lock);
+    asynPrint(fan->pasynUser, ASYN_TRACE_FLOW,
+            "drvAsynIPServerPort: %s new client %s\n", fan->portName, pc->address);
+}
+
+/*
+ * Data from a client is passed to asynOctet interrupt users
+ */
+static int fanoutReadClient(fanoutController_t *fan, fanoutClient *pc)
+{
+    ELLLIST *pclientList;
+    interruptNode *pnode;
+    asynOctetInterrupt *pinterrupt;
+    int nRead;
+
+    nRead = recv(pc->fd, fan->readBuffer, FANOUT_READ_BUFFER_SIZE, 0);
+    if (nRead < 0) {
+        if ((SOCKERRNO == SOCK_EWOULDBLOCK) || (SOCKERRNO == SOCK_EINTR))
+            return 0;
+        return -1;
+    }
+    if (nRead == 0)
+        return -1;
+    fan->nRead += nRead;
+    asynPrintIO(fan->pasynUser, ASYN_TRACEIO_DRIVER, fan->readBuffer, nRead,
+            "%s read %d from %s\n", fan->portName, nRead, pc->address);
+    pasynManager->interruptStart(fan->octetCallbackPvt, &pclientList);
+    pnode = (interruptNode *) ellFirst(pclientList);
+    while (pnode) {
+        pinterrupt = pnode->drvPvt;
+        pinterrupt->callback(pinterrupt->userPvt, pinterrupt->pasynUser,
+                fan->readBuffer, nRead, 0);
+        pnode = (interruptNode *) ellNext(&pnode->node);
+    }
+    pasynManager->interruptEnd(fan->octetCallbackPvt);
+    return 0;
+}
+
+/*
+ * The one thread that serves all clients
+ */
+static void fanoutEventLoop(void *drvPvt)
+{
+    fanoutController_t *fan = (fanoutController_t *) drvPvt;
+    struct pollfd *pollfds;
+    int *index;
+    int nfds, i;
+
+    pollfds = callocMustSucceed(fan->maxClients + 2, sizeof(*pollfds),
+            "drvAsynIPServerPort:fanoutEventLoop");
+    index = callocMustSucceed(fan->maxClients + 2, sizeof(*index),
+            "drvAsynIPServerPort:fanoutEventLoop");
+    while (1) {
+        pollfds[0].fd = fan->wakeupFd;
+        pollfds[0].events = POLLIN;
+        nfds = 1;
+        epicsMutexMustLock(fan->lock);
+        if (fan->closeListener) {
+            epicsSocketDestroy(fan->fd);
+            fan->fd = INVALID_SOCKET;
+            fan->closeListener = 0;
+        }
+        if (fan->fd != INVALID_SOCKET) {
+            pollfds[nfds].fd = fan->fd;
+            pollfds[nfds].events = POLLIN;
+            index[nfds++] = -1;
+        }
+        for (i = 0; i < fan->maxClients; i++) {
+            fanoutClient *pc = &fan->clients[i];
+            if (pc->fd == INVALID_SOCKET) continue;
+            if (pc->closePending) {
+                fanoutCloseClient(fan, pc);
+                continue;
+            }
+            pollfds[nfds].fd = pc->fd;
+            pollfds[nfds].events = POLLIN | (pc->count ? POLLOUT : 0);
+            index[nfds++] = i;
+        }
+        epicsMutexUnlock(fan->lock);
+        for (i = 0; i < nfds; i++)
+            pollfds[i].revents = 0;
+        if (poll(pollfds, nfds, -1) < 0) {
+            if (SOCKERRNO != SOCK_EINTR) {
+                asynPrint(fan->pasynUser, ASYN_TRACE_ERROR,
+                    "drvAsynIPServerPort: %s poll failed: %s\n",
+                    fan->portName, strerror(SOCKERRNO));
+                epicsThreadSleep(1.0);
+            }
+            continue;
+        }
+        if (pollfds[0].revents & POLLIN) {
+            char c[16];
+            recv(fan->wakeupFd, c, sizeof c, 0);
+        }
+        for (i = 1; i < nfds; i++) {
+            fanoutClient *pc;
+            int status = 0;
+
+            if (pollfds[i].revents == 0) continue;
+            if (index[i] < 0) {
+                fanoutAccept(fan);
+                continue;
+            }
+            pc = &fan->clients[index[i]];
+            if (pollfds[i].revents & (POLLIN | POLLHUP | POLLERR))
+                status = fanoutReadClient(fan, pc);
+            epicsMutexMustLock(fan->lock);
+            if ((status == 0) && (pollfds[i].revents & POLLOUT)) {
+                status = fanoutFlushClient(fan, pc);
+                if (fan->policy == fanoutPolicyBlock)
+                    epicsEventSignal(fan->spaceAvailable);
+            }
+            if (status != 0)
+                fanoutCloseClient(fan, pc);
+            epicsMutexUnlock(fan->lock);
+        }
+    }
+}
+
+/*
+ * Broadcast a buffer to every client
+ */
+static asynStatus fanoutWrite(void *drvPvt, asynUser *pasynUser,
+        const char *data, size_t numchars, size_t *nbytesTransfered)
+{
+    fanoutController_t *fan = (fanoutController_t *) drvPvt;
+    epicsTimeStamp start, now;
+    int i;
+
+    *nbytesTransfered = 0;
+    if (numchars > fan->queueSize) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                "%s write of %d bytes is larger than queueSize %d",
+                fan->portName, (int)numchars, (int)fan->queueSize);
+        return asynError;
+    }
+    epicsTimeGetCurrent(&start);
+    epicsMutexMustLock(fan->lock);
+    if ((fan->fd == INVALID_SOCKET) || fan->closeListener) {
+        epicsMutexUnlock(fan->lock);
+        return asynDisconnected;
+    }
+    while (fan->policy == fanoutPolicyBlock) {
+        double wait;
+
+        for (i = 0; i < fan->maxClients; i++) {
+            fanoutClient *pc = &fan->clients[i];
+            if ((pc->fd != INVALID_SOCKET) && !pc->closePending
+             && (fan->queueSize - pc->count < numchars))
+                break;
+        }
+        if (i == fan->maxClients)
+            break;
+        epicsTimeGetCurrent(&now);
+        wait = pasynUser->timeout - epicsTimeDiffInSeconds(&now, &start);
+        if ((pasynUser->timeout >= 0) && (wait <= 0)) {
+            epicsMutexUnlock(fan->lock);
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "%s timeout waiting for client %d", fan->portName, i);
+            return asynTimeout;
+        }
+        epicsMutexUnlock(fan->lock);
+        if (pasynUser->timeout < 0)
+            epicsEventMustWait(fan->spaceAvailable);
+        else
+            epicsEventWaitWithTimeout(fan->spaceAvailable, wait);
+        epicsMutexMustLock(fan->lock);
+    }
+    for (i = 0; i < fan->maxClients; i++) {
+        fanoutClient *pc = &fan->clients[i];
+        if ((pc->fd == INVALID_SOCKET) || pc->closePending) continue;
+        if (fan->queueSize - pc->count < numchars) {
+            pc->nDropped++;
+            if (fan->policy == fanoutPolicyDisconnect)
+                pc->closePending = 1;
+            continue;
+        }
+        fanoutQueue(fan, pc, data, numchars);
+    }
+    fan->nBroadcast++;
+    epicsMutexUnlock(fan->lock);
+    fanoutWakeup(fan);
+    asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, data, numchars,
+            "%s broadcast %d\n", fan->portName, (int)numchars);
+    *nbytesTransfered = numchars;
+    return asynSuccess;
+}
+
+static asynStatus fanoutFlush(void *drvPvt, asynUser *pasynUser)
+{
+    return asynSuccess;
+}
+
+static void fanoutReport(void *drvPvt, FILE *fp, int details)
+{
+    fanoutController_t *fan = (fanoutController_t *) drvPvt;
+    int connected;
+    int i;
+
+    epicsMutexMustLock(fan->lock);
+    connected = (fan->fd != INVALID_SOCKET) && !fan->closeListener;
+    epicsMutexUnlock(fan->lock);
+    fprintf(fp, "Port %s: %sonnected, fan-out server\n", fan->portName,
+            connected ? "C" : "Disc");
+    if (details >= 1) {
+        fprintf(fp, "  Clients: %d of %d, queueSize: %d, policy: %s\n",
+                fan->nClients, fan->maxClients, (int)fan->queueSize,
+                fanoutPolicyName[fan->policy]);
+        fprintf(fp, "  Broadcasts: %lu, bytes read: %lu, accepted: %lu, refused: %lu\n",
+                fan->nBroadcast, fan->nRead, fan->nAccepted, fan->nRefused);
+    }
+    if (details >= 2) {
+        epicsMutexMustLock(fan->lock);
+        for (i = 0; i < fan->maxClients; i++) {
+            fanoutClient *pc = &fan->clients[i];
+            if (pc->fd == INVALID_SOCKET) continue;
+            fprintf(fp, "    Client %d %s fd: %d queued: %d written: %lu dropped: %lu\n",
+                    i, pc->address, (int)pc->fd, (int)pc->count,
+                    pc->nWritten, pc->nDropped);
+        }
+        epicsMutexUnlock(fan->lock);
+    }
+}
+
+static asynStatus fanoutConnect(void *drvPvt, asynUser *pasynUser)
+{
+    fanoutController_t *fan = (fanoutController_t *) drvPvt;
+    struct sockaddr_in serverAddr;
+    int oneVal = 1;
+    int listening;
+
+    epicsMutexMustLock(fan->lock);
+    /* still listening if the event loop hasn't closed the socket yet */
+    fan->closeListener = 0;
+    listening = (fan->fd != INVALID_SOCKET);
+    epicsMutexUnlock(fan->lock);
+    if (!listening) {
+        SOCKET fd = epicsSocketCreate(PF_INET, SOCK_STREAM, 0);
+        osiSockIoctl_t nonBlock = 1;
+
+        if (fd == INVALID_SOCKET) {
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "Can't create socket: %s", strerror(SOCKERRNO));
+            return asynError;
+        }
+        memset(&serverAddr, 0, sizeof(serverAddr));
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_addr.s_addr = INADDR_ANY;
+        serverAddr.sin_port = htons(fan->portNumber);
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const void *)&oneVal, sizeof(int));
+        if ((bind(fd, (struct sockaddr *) &serverAddr, sizeof(serverAddr)) < 0)
+         || (listen(fd, fan->maxClients) < 0)) {
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "Can't listen on %s: %s", fan->serverInfo, strerror(SOCKERRNO));
+            epicsSocketDestroy(fd);
+            return asynError;
+        }
+        socket_ioctl(fd, FIONBIO, &nonBlock);
+        epicsMutexMustLock(fan->lock);
+        fan->fd = fd;
+        epicsMutexUnlock(fan->lock);
+        fanoutWakeup(fan);
+    }
+    pasynManager->exceptionConnect(pasynUser);
+    return asynSuccess;
+}
+
+static asynStatus fanoutDisconnect(void *drvPvt, asynUser *pasynUser)
+{
+    fanoutController_t *fan = (fanoutController_t *) drvPvt;
+    int i;
+
+    /* fanoutEventLoop closes the socket it may be polling */
+    epicsMutexMustLock(fan->lock);
+    if (fan->fd != INVALID_SOCKET)
+        fan->closeListener = 1;
+    for (i = 0; i < fan->maxClients; i++) {
+        if (fan->clients[i].fd != INVALID_SOCKET)
+            fan->clients[i].closePending = 1;
+    }
+    epicsMutexUnlock(fan->lock);
+    fanoutWakeup(fan);
+    pasynManager->exceptionDisconnect(pasynUser);
+    return asynSuccess;
+}
+
+static asynCommon drvAsynIPServerFanoutCommon = {
+    fanoutReport,
+    fanoutConnect,
+    fanoutDisconnect
+};
+
+static asynOctet drvAsynIPServerFanoutOctet = {
+    fanoutWrite,
+    NULL, /* Read */
+    fanoutFlush,
+};
+
+/*
+ * Configure and register a fan-out server port
+ */
+int drvAsynIPServerFanoutConfigure(const char *portName,
+        const char *serverInfo,
+        unsigned int maxClients,
+        int queueSize,
+        const char *policy,
+        unsigned int priority,
+        int noAutoConnect)
+{
+    fanoutController_t *fan;
+    osiSocklen_t addrLen;
+    const char *cp;
+    int i;
+
+    if (portName == NULL) {
+        printf("Port name missing.\n");
+        return -1;
+    }
+    if (serverInfo == NULL) {
+        printf("TCP server information missing.\n");
+        return -1;
+    }
+    if (maxClients <= 0) {
+        printf("No clients.\n");
+        return -1;
+    }
+    if (pserialBase == NULL) {
+        if (osiSockAttach() == 0) {
+            printf("drvAsynIPServerFanoutConfigure: osiSockAttach failed\n");
+            return -1;
+        }
+        serialBaseInit();
+    }
+    fan = (fanoutController_t *) callocMustSucceed(1, sizeof(fanoutController_t),
+            "drvAsynIPServerFanoutConfigure()");
+    fan->fd = INVALID_SOCKET;
+    fan->portName = epicsStrDup(portName);
+    fan->serverInfo = epicsStrDup(serverInfo);
+    fan->maxClients = maxClients;
+    fan->queueSize = (queueSize > 0) ? queueSize : 65536;
+    if ((policy == NULL) || (*policy == '\0')
+     || (epicsStrCaseCmp(policy, "drop") == 0)) {
+        fan->policy = fanoutPolicyDrop;
+    } else if (epicsStrCaseCmp(policy, "disconnect") == 0) {
+        fan->policy = fanoutPolicyDisconnect;
+    } else if (epicsStrCaseCmp(policy, "block") == 0) {
+        fan->policy = fanoutPolicyBlock;
+    } else {
+        printf("drvAsynIPServerFanoutConfigure: Unknown policy \"%s\".\n", policy);
+        return -1;
+    }
+    if (((cp = strchr(serverInfo, ':')) == NULL)
+     || (sscanf(cp, ":%u", &fan->portNumber) != 1)) {
+        printf("drvAsynIPServerFanoutConfigure: \"%s\" is not of the form \"<host>:<port>\"\n",
+                serverInfo);
+        return -1;
+    }
+    fan->lock = epicsMutexMustCreate();
+    fan->spaceAvailable = epicsEventMustCreate(epicsEventEmpty);
+    fan->readBuffer = callocMustSucceed(1, FANOUT_READ_BUFFER_SIZE,
+            "drvAsynIPServerFanoutConfigure()");
+    fan->clients = callocMustSucceed(maxClients, sizeof(fanoutClient),
+            "drvAsynIPServerFanoutConfigure()");
+    for (i = 0; i < fan->maxClients; i++)
+        fan->clients[i].fd = INVALID_SOCKET;
+
+    /*
+     * Datagram socket on the loopback interface used to wake the event loop
+     */
+    fan->wakeupFd = epicsSocketCreate(PF_INET, SOCK_DGRAM, 0);
+    if (fan->wakeupFd == INVALID_SOCKET) {
+        printf("drvAsynIPServerFanoutConfigure: Can't create socket: %s\n",
+                strerror(SOCKERRNO));
+        return -1;
+    }
+    memset(&fan->wakeupAddr, 0, sizeof(fan->wakeupAddr));
+    fan->wakeupAddr.ia.sin_family = AF_INET;
+    fan->wakeupAddr.ia.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    fan->wakeupAddr.ia.sin_port = 0;
+    addrLen = sizeof(fan->wakeupAddr.ia);
+    if ((bind(fan->wakeupFd, &fan->wakeupAddr.sa, sizeof(fan->wakeupAddr.ia)) < 0)
+     || (getsockname(fan->wakeupFd, &fan->wakeupAddr.sa, &addrLen) < 0)) {
+        printf("drvAsynIPServerFanoutConfigure: Can't bind wakeup socket: %s\n",
+                strerror(SOCKERRNO));
+        epicsSocketDestroy(fan->wakeupFd);
+        return -1;
+    }
+
+    fan->common.interfaceType = asynCommonType;
+    fan->common.pinterface = &drvAsynIPServerFanoutCommon;
+    fan->common.drvPvt = fan;
+    if (pasynManager->registerPort(fan->portName,
+            ASYN_CANBLOCK,
+            !noAutoConnect,
+            priority,
+            0) != asynSuccess) {
+        printf("drvAsynIPServerFanoutConfigure: Can't register myself.\n");
+        return -1;
+    }
+    if (pasynManager->registerInterface(fan->portName, &fan->common) != asynSuccess) {
+        printf("drvAsynIPServerFanoutConfigure: Can't register common.\n");
+        return -1;
+    }
+    fan->octet.interfaceType = asynOctetType;
+    fan->octet.pinterface = &drvAsynIPServerFanoutOctet;
+    fan->octet.drvPvt = fan;
+    if (pasynOctetBase->initialize(fan->portName, &fan->octet, 0, 0, 0) != asynSuccess) {
+        printf("drvAsynIPServerFanoutConfigure: pasynOctetBase->initialize failed.\n");
+        return -1;
+    }
+    if (pasynManager->registerInterruptSource(fan->portName, &fan->octet,
+            &fan->octetCallbackPvt) != asynSuccess) {
+        printf("drvAsynIPServerFanoutConfigure registerInterruptSource failed\n");
+        return -1;
+    }
+    fan->pasynUser = pasynManager->createAsynUser(0, 0);
+    if (pasynManager->connectDevice(fan->pasynUser, fan->portName, -1) != asynSuccess) {
+        printf("connectDevice failed %s\n", fan->pasynUser->errorMessage);
+        return -1;
+    }
+    if (fanoutConnect(fan, fan->pasynUser) != asynSuccess) {
+        printf("drvAsynIPServerFanoutConfigure: %s\n", fan->pasynUser->errorMessage);
+        return -1;
+    }
+    epicsThreadCreate(fan->portName,
+            priority ? priority : epicsThreadPriorityMedium,
+            epicsThreadGetStackSize(epicsThreadStackSmall),
+            (EPICSTHREADFUNC) fanoutEventLoop, fan);
+    return 0;
+}
+#else
+int drvAsynIPServerFanoutConfigure(const char *portName,
+        const char *serverInfo,
+        unsigned int maxClients,
+        int queueSize,
+        const char *policy,
+        unsigned int priority,
+        int noAutoConnect)
+{
+    printf("drvAsynIPServerFanoutConfigure: not supported on this architecture\n");
+    return -1;
+}
+#endif /* USE_FANOUT */
+
 /*
  * IOC shell command registration
  */
@@ -707,6 +1361,27 @@ static void drvAsynIPServerPortConfigureCallFunc(const iocshArgBuf *args) {
             args[3].ival, args[4].ival, args[5].ival);
 }
 
+static const iocshArg drvAsynIPServerFanoutConfigureArg0 = {"port name", iocshArgString};
+static const iocshArg drvAsynIPServerFanoutConfigureArg1 = {"localhost:port", iocshArgString};
+static const iocshArg drvAsynIPServerFanoutConfigureArg2 = {"max clients", iocshArgInt};
+static const iocshArg drvAsynIPServerFanoutConfigureArg3 = {"queue size", iocshArgInt};
+static const iocshArg drvAsynIPServerFanoutConfigureArg4 = {"policy (drop/disconnect/block)", iocshArgString};
+static const iocshArg drvAsynIPServerFanoutConfigureArg5 = {"priority", iocshArgInt};
+static const iocshArg drvAsynIPServerFanoutConfigureArg6 = {"disable auto-connect", iocshArgInt};
+
+static const iocshArg *drvAsynIPServerFanoutConfigureArgs[] = {
+    &drvAsynIPServerFanoutConfigureArg0, &drvAsynIPServerFanoutConfigureArg1,
+    &drvAsynIPServerFanoutConfigureArg2, &drvAsynIPServerFanoutConfigureArg3,
+    &drvAsynIPServerFanoutConfigureArg4, &drvAsynIPServerFanoutConfigureArg5,
+    &drvAsynIPServerFanoutConfigureArg6};
+
+static const iocshFuncDef drvAsynIPServerFanoutConfigureFuncDef = {"drvAsynIPServerFanoutConfigure", 7, drvAsynIPServerFanoutConfigureArgs};
+
+static void drvAsynIPServerFanoutConfigureCallFunc(const iocshArgBuf *args) {
+    drvAsynIPServerFanoutConfigure(args[0].sval, args[1].sval, args[2].ival,
+            args[3].ival, args[4].sval, args[5].ival, args[6].ival);
+}
+
 /*
  * This routine is called before multitasking has started, so there's
  * no race condition in the test/set of firstTime.
@@ -717,6 +1392,7 @@ drvAsynIPServerPortRegisterCommands(void)
     static int firstTime = 1;
     if (firstTime) {
         iocshRegister(&drvAsynIPServerPortConfigureFuncDef, drvAsynIPServerPortConfigureCallFunc);
+        iocshRegister(&drvAsynIPServerFanoutConfigureFuncDef, drvAsynIPServerFanoutConfigureCallFunc);
         firstTime = 0;
     }
 }
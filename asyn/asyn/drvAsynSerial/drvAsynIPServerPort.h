@@ -20,6 +20,10 @@ extern "C" {
 int drvAsynIPServerPortConfigure(const char *portName, const char *serverInfo,
                                  unsigned int maxClients, unsigned int priority,
                                  int noAutoConnect, int noProcessEos);
+int drvAsynIPServerFanoutConfigure(const char *portName, const char *serverInfo,
+                                   unsigned int maxClients, int queueSize,
+                                   const char *policy, unsigned int priority,
+                                   int noAutoConnect);
 
 #ifdef __cplusplus
 }
@@ -48,10 +48,33 @@
 # define CSTOPB STOPB
 #else
 # include <termios.h>
+# include <poll.h>
 #endif
 
 #include "serial_rs485.h"
 
+#if defined(__linux__) && !defined(vxWorks)
+# include <sys/ioctl.h>
+# include <linux/serial.h>
+# ifdef ASYNC_LOW_LATENCY
+#  define ASYN_LOW_LATENCY_SUPPORTED
+# endif
+#endif
+
+/*
+ * Read modes.  In low latency mode a read returns as soon as any
+ * characters are available.  In batched mode the kernel collects up to
+ * readBatch characters, or until the line has been idle for readGap
+ * deciseconds, before waking the reader.
+ */
+typedef enum {
+    readModeDefault,
+    readModeLowLatency,
+    readModeBatched
+} readMode_t;
+#define DEFAULT_READ_BATCH 64
+#define DEFAULT_READ_GAP   1
+
 #ifdef vxWorks
 /*
  * Fake termios structure
@@ -77,6 +100,9 @@ typedef struct {
     struct serial_rs485  rs485;
 #endif
     int                baud;
+    readMode_t         readMode;
+    int                readBatch;
+    int                readGap;
     double             readTimeout;
     double             writeTimeout;
     epicsTimerId       timer;
@@ -129,6 +155,61 @@ applyOptions(asynUser *pasynUser, ttyController_t *tty)
     return asynSuccess;
 }
 
+#ifndef vxWorks
+/*
+ * Set the termios VMIN/VTIME values for a read timeout
+ */
+static void
+setReadTermios(ttyController_t *tty, double timeout)
+{
+    if (timeout == 0) {
+        tty->termios.c_cc[VMIN] = 0;
+        tty->termios.c_cc[VTIME] = 0;
+    }
+    else if (tty->readMode == readModeBatched) {
+        /* The read timeout is handled by poll() in readIt */
+        tty->termios.c_cc[VMIN] = tty->readBatch;
+        tty->termios.c_cc[VTIME] = tty->readGap;
+    }
+    else if (timeout > 0) {
+        int t = (timeout * 10) + 1;
+        if (t > 255)
+            t = 255;
+        tty->termios.c_cc[VMIN] = 0;
+        tty->termios.c_cc[VTIME] = t;
+    }
+    else {
+        tty->termios.c_cc[VMIN] = 1;
+        tty->termios.c_cc[VTIME] = 0;
+    }
+}
+
+/*
+ * Ask the UART driver to pass characters up immediately in low latency
+ * mode.  Not all drivers support this so errors are ignored.
+ */
+static void
+applyReadMode(asynUser *pasynUser, ttyController_t *tty)
+{
+#ifdef ASYN_LOW_LATENCY_SUPPORTED
+    struct serial_struct serial;
+
+    if (tty->readMode == readModeDefault)
+        return;
+    if (ioctl(tty->fd, TIOCGSERIAL, &serial) < 0)
+        return;
+    if (tty->readMode == readModeLowLatency)
+        serial.flags |= ASYNC_LOW_LATENCY;
+    else
+        serial.flags &= ~ASYNC_LOW_LATENCY;
+    if (ioctl(tty->fd, TIOCSSERIAL, &serial) < 0)
+        asynPrint(pasynUser, ASYN_TRACE_WARNING,
+                  "%s can't set ASYNC_LOW_LATENCY: %s\n",
+                  tty->serialDeviceName, strerror(errno));
+#endif
+}
+#endif
+
 /*
  * asynOption methods
  */
@@ -200,6 +281,18 @@ getOption(void *drvPvt, asynUser *pasynUser,
         l = epicsSnprintf(val, valSize, "%c",  (tty->termios.c_iflag & IXOFF) ? 'Y' : 'N');
 #endif
     }
+#ifndef vxWorks
+    else if (epicsStrCaseCmp(key, "read_mode") == 0) {
+        l = epicsSnprintf(val, valSize, "%s",
+            (tty->readMode == readModeBatched) ? "batched" : "low_latency");
+    }
+    else if (epicsStrCaseCmp(key, "read_batch") == 0) {
+        l = epicsSnprintf(val, valSize, "%d", tty->readBatch);
+    }
+    else if (epicsStrCaseCmp(key, "read_gap") == 0) {
+        l = epicsSnprintf(val, valSize, "%d", tty->readGap * 100);
+    }
+#endif
 #ifdef ASYN_RS485_SUPPORTED
     else if (epicsStrCaseCmp(key, "rs485_enable") == 0) {
         l = epicsSnprintf(val, valSize, "%c",  (tty->rs485.flags & SER_RS485_ENABLED) ? 'Y' : 'N');
@@ -236,6 +329,7 @@ setOption(void *drvPvt, asynUser *pasynUser, const char *key, const char *val)
     ttyController_t *tty = (ttyController_t *)drvPvt;
     struct termios termiosPrev;
     int baudPrev;
+    int readModeChanged = 0;
 #ifdef ASYN_RS485_SUPPORTED
     struct serial_rs485 rs485Prev;
     int rs485_changed = 0;
@@ -495,6 +589,62 @@ setOption(void *drvPvt, asynUser *pasynUser, const char *key, const char *val)
                                                     "Invalid ixoff value.");
             return asynError;
         }
+#endif
+    }
+    else if (epicsStrCaseCmp(key, "read_mode") == 0) {
+#ifdef vxWorks
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                                                    "Option read_mode not supported on vxWorks");
+            return asynError;
+#else
+        if (epicsStrCaseCmp(val, "low_latency") == 0) {
+            tty->readMode = readModeLowLatency;
+        }
+        else if (epicsStrCaseCmp(val, "batched") == 0) {
+            tty->readMode = readModeBatched;
+        }
+        else {
+            epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                                                    "Invalid read_mode value.");
+            return asynError;
+        }
+        readModeChanged = 1;
+        setReadTermios(tty, tty->readTimeout);
+#endif
+    }
+    else if (epicsStrCaseCmp(key, "read_batch") == 0) {
+#ifdef vxWorks
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                                                    "Option read_batch not supported on vxWorks");
+            return asynError;
+#else
+        int batch;
+        if((sscanf(val, "%d", &batch) != 1) || (batch < 1) || (batch > 255)) {
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                                                    "Invalid read_batch value.");
+            return asynError;
+        }
+        tty->readBatch = batch;
+        setReadTermios(tty, tty->readTimeout);
+#endif
+    }
+    else if (epicsStrCaseCmp(key, "read_gap") == 0) {
+#ifdef vxWorks
+        epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                                                    "Option read_gap not supported on vxWorks");
+            return asynError;
+#else
+        int msec;
+        if((sscanf(val, "%d", &msec) != 1) || (msec < 0)) {
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                                                    "Invalid read_gap value.");
+            return asynError;
+        }
+        /* termios VTIME is in deciseconds */
+        tty->readGap = (msec + 99) / 100;
+        if (tty->readGap < 1) tty->readGap = 1;
+        if (tty->readGap > 255) tty->readGap = 255;
+        setReadTermios(tty, tty->readTimeout);
 #endif
     }
 #ifdef ASYN_RS485_SUPPORTED
@@ -573,6 +723,10 @@ setOption(void *drvPvt, asynUser *pasynUser, const char *key, const char *val)
             tty->termios = termiosPrev;
             return asynError;
         }
+#ifndef vxWorks
+        if (readModeChanged)
+            applyReadMode(pasynUser, tty);
+#endif
 #ifdef ASYN_RS485_SUPPORTED
         if (rs485_changed) {
             if( ioctl( tty->fd, TIOCSRS485, &tty->rs485 ) < 0 ) {
@@ -646,6 +800,13 @@ report(void *drvPvt, FILE *fp, int details)
         fprintf(fp, "                    fd: %d\n", tty->fd);
         fprintf(fp, "    Characters written: %lu\n", tty->nWritten);
         fprintf(fp, "       Characters read: %lu\n", tty->nRead);
+#ifndef vxWorks
+        if (tty->readMode == readModeBatched)
+            fprintf(fp, "             Read mode: batched %d chars or %d msec gap\n",
+                    tty->readBatch, tty->readGap * 100);
+        else
+            fprintf(fp, "             Read mode: low latency\n");
+#endif
     }
 }
 
@@ -691,6 +852,9 @@ connectIt(void *drvPvt, asynUser *pasynUser)
     }
 #endif
     applyOptions(pasynUser, tty);
+#ifndef vxWorks
+    applyReadMode(pasynUser, tty);
+#endif
 
     /*
      * Turn off non-blocking mode
@@ -829,6 +993,9 @@ static asynStatus readIt(void *drvPvt, asynUser *pasynUser,
     int nRead = 0;
     int timerStarted = 0;
     asynStatus status = asynSuccess;
+#ifndef vxWorks
+    epicsTimeStamp readStart;
+#endif
 
     assert(tty);
     asynPrint(pasynUser, ASYN_TRACE_FLOW,
@@ -862,21 +1029,7 @@ static asynStatus readIt(void *drvPvt, asynUser *pasynUser,
         /*
          * Set TERMIOS timeout
          */
-        if (pasynUser->timeout > 0) {
-            int t = (pasynUser->timeout * 10) + 1;
-            if (t > 255)
-                t = 255;
-            tty->termios.c_cc[VMIN] = 0;
-            tty->termios.c_cc[VTIME] = t;
-        }
-        else if (pasynUser->timeout == 0) {
-            tty->termios.c_cc[VMIN] = 0;
-            tty->termios.c_cc[VTIME] = 0;
-        }
-        else {
-            tty->termios.c_cc[VMIN] = 1;
-            tty->termios.c_cc[VTIME] = 0;
-        }
+        setReadTermios(tty, pasynUser->timeout);
 
         if (tcsetattr(tty->fd, TCSANOW, &tty->termios) < 0) {
             epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
@@ -910,7 +1063,47 @@ static asynStatus readIt(void *drvPvt, asynUser *pasynUser,
         if (!timerStarted && (tty->readTimeout > 0)) {
             epicsTimerStartDelay(tty->timer, tty->readTimeout);
             timerStarted = 1;
+#ifndef vxWorks
+            epicsTimeGetCurrent(&readStart);
+#endif
         }
+#ifndef vxWorks
+        /*
+         * In batched mode VMIN is not zero so read() blocks until the
+         * first character arrives.  Wait for it here with the timeout.
+         */
+        if ((tty->readMode == readModeBatched) && (tty->readTimeout > 0)) {
+            struct pollfd pollfd;
+            epicsTimeStamp now;
+            double remaining;
+            int pollstatus;
+
+            epicsTimeGetCurrent(&now);
+            remaining = tty->readTimeout - epicsTimeDiffInSeconds(&now, &readStart);
+            if (remaining <= 0) {
+                tty->timeoutFlag = 1;
+                break;
+            }
+            pollfd.fd = tty->fd;
+            pollfd.events = POLLIN;
+            pollfd.revents = 0;
+            pollstatus = poll(&pollfd, 1, (int)(remaining * 1000) + 1);
+            if (pollstatus == 0) {
+                tty->timeoutFlag = 1;
+                break;
+            }
+            if (pollstatus < 0) {
+                if (errno == EINTR)
+                    continue;
+                epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+                                "%s poll error: %s",
+                                        tty->serialDeviceName, strerror(errno));
+                closeConnection(pasynUser,tty);
+                status = asynError;
+                break;
+            }
+        }
+#endif
         thisRead = read(tty->fd, data, maxchars);
         if (thisRead > 0) {
             asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, data, thisRead,
@@ -1054,6 +1247,8 @@ drvAsynSerialPortConfigure(char *portName,
     tty->termios.c_cc[VTIME] = 0;
     tty->termios.c_cc[VSTOP]  = 0x13; /* ^S */
     tty->termios.c_cc[VSTART] = 0x11; /* ^Q */
+    tty->readBatch = DEFAULT_READ_BATCH;
+    tty->readGap = DEFAULT_READ_GAP;
 
     cfsetispeed(&tty->termios, B9600);
     cfsetospeed(&tty->termios, B9600);
@@ -0,0 +1,870 @@
+/**********************************************************************
+* Asyn port driver using a shared memory ring to another process      *
+**********************************************************************/
+/***********************************************************************
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+* National Laboratory, and the Regents of the University of
+* California, as Operator of Los Alamos National Laboratory, and
+* Berliner Elektronenspeicherring-Gesellschaft m.b.H. (BESSY).
+* asynDriver is distributed subject to a Software License Agreement
+* found in file LICENSE that is included with this distribution.
+***********************************************************************/
+
+/*
+ * A POSIX shared memory segment holds two single-producer/single-consumer
+ * rings, one in each direction.  Each message is a frame: an 8 byte header
+ * giving the length and type, followed by the payload padded to 8 bytes.
+ * Producers and consumers only spin on head/tail; a process-shared semaphore
+ * is posted only when the other side has said it is about to sleep.
+ *
+ * The IOC creates the segment, or reuses it if a segment of the same size
+ * already exists, so a companion process can survive an IOC restart.  The
+ * companion attaches with drvAsynShmClientOpen.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cantProceed.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <epicsAtomic.h>
+#include <epicsStdio.h>
+#include <epicsString.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+
+#include <epicsExport.h>
+#include "asynDriver.h"
+#include "asynOctet.h"
+#include "asynInt8Array.h"
+#include "asynInt16Array.h"
+#include "asynInt32Array.h"
+#include "asynInt64Array.h"
+#include "asynFloat32Array.h"
+#include "asynFloat64Array.h"
+#include "drvAsynSharedMemory.h"
+
+#define SHM_MAGIC 0x61534d31 /* "aSM1" */
+#define SHM_ALIGN 8
+#define SHM_DEFAULT_RING_SIZE 1048576
+#define SHM_TO_IOC 0
+#define SHM_FROM_IOC 1
+
+/*
+ * Layout of the shared segment.  head and tail are byte counts modulo 2^32,
+ * each written by one side only, and kept on separate cache lines.
+ */
+typedef struct shmRing {
+    int         head;           /* written by the producer */
+    char        pad0[60];
+    int         tail;           /* written by the consumer */
+    char        pad1[60];
+    int         readerWaiting;
+    int         writerWaiting;
+    epicsUInt32 size;           /* bytes, power of 2 */
+    epicsUInt32 offset;         /* of the data area from the start of the segment */
+    sem_t       dataReady;
+    sem_t       spaceReady;
+} shmRing;
+
+typedef struct shmSegment {
+    epicsUInt32 magic;
+    epicsUInt32 segmentSize;
+    shmRing     ring[2];
+} shmSegment;
+
+typedef struct shmFrame {
+    epicsUInt32 length;         /* payload bytes */
+    epicsUInt32 type;           /* drvAsynShmFrameType */
+} shmFrame;
+
+/* One end of the segment */
+typedef struct shmEndpoint {
+    shmSegment  *pseg;
+    size_t      mapSize;
+    shmRing     *in;
+    shmRing     *out;
+    char        *inData;
+    char        *outData;
+    epicsUInt32 readOffset;     /* payload bytes of the current input frame already consumed */
+    unsigned long framesDiscarded;
+} shmEndpoint;
+
+struct drvAsynShmClient {
+    shmEndpoint ep;
+};
+
+typedef struct shmController {
+    char          *portName;
+    char          *shmName;
+    shmEndpoint   ep;
+    int           useCallbacks;
+    asynUser      *pasynUser;
+    char          *callbackBuffer;
+    asynInterface common;
+    asynInterface octet;
+    asynInterface array[drvAsynShmNumFrameTypes];
+    void          *callbackPvt[drvAsynShmNumFrameTypes];
+    unsigned long framesRead;
+    unsigned long framesWritten;
+    unsigned long bytesRead;
+    unsigned long bytesWritten;
+} shmController;
+
+static const char *frameTypeNames[drvAsynShmNumFrameTypes] = {
+    "octet", "int8Array", "int16Array", "int32Array", "int64Array",
+    "float32Array", "float64Array"
+};
+
+/*
+ * Ring primitives, used by both ends
+ */
+static epicsUInt32 frameSize(epicsUInt32 length)
+{
+    return sizeof(shmFrame) + ((length + SHM_ALIGN - 1) & ~(epicsUInt32)(SHM_ALIGN - 1));
+}
+
+static void ringCopyIn(shmRing *pring, char *data, epicsUInt32 position,
+                       const void *source, size_t nBytes)
+{
+    epicsUInt32 offset = position & (pring->size - 1);
+    size_t first = pring->size - offset;
+
+    if (first > nBytes) first = nBytes;
+    memcpy(data + offset, source, first);
+    if (nBytes > first) memcpy(data, (const char *)source + first, nBytes - first);
+}
+
+static void ringCopyOut(shmRing *pring, const char *data, epicsUInt32 position,
+                        void *dest, size_t nBytes)
+{
+    epicsUInt32 offset = position & (pring->size - 1);
+    size_t first = pring->size - offset;
+
+    if (first > nBytes) first = nBytes;
+    memcpy(dest, data + offset, first);
+    if (nBytes > first) memcpy((char *)dest + first, data, nBytes - first);
+}
+
+/* Wait on a process-shared semaphore; timeout<0 waits forever */
+static asynStatus semWait(sem_t *psem, double timeout)
+{
+    struct timespec deadline;
+    int status;
+
+    if (timeout < 0) {
+        while ((status = sem_wait(psem)) != 0 && errno == EINTR)
+            ;
+        return status ? asynError : asynSuccess;
+    }
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)timeout;
+    deadline.tv_nsec += (long)((timeout - (time_t)timeout) * 1e9);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    while ((status = sem_timedwait(psem, &deadline)) != 0 && errno == EINTR)
+        ;
+    return status ? asynTimeout : asynSuccess;
+}
+
+static double timeLeft(const epicsTimeStamp *pstart, double timeout)
+{
+    epicsTimeStamp now;
+    double left;
+
+    if (timeout <= 0) return timeout;
+    epicsTimeGetCurrent(&now);
+    left = timeout - epicsTimeDiffInSeconds(&now, pstart);
+    return (left > 0) ? left : 0;
+}
+
+static asynStatus frameWrite(shmEndpoint *pep, drvAsynShmFrameType type,
+                             const void *data, size_t nBytes, double timeout)
+{
+    shmRing *pring = pep->out;
+    epicsUInt32 total = frameSize((epicsUInt32)nBytes);
+    epicsUInt32 head = (epicsUInt32)epicsAtomicGetIntT(&pring->head);
+    epicsTimeStamp start;
+    shmFrame frame;
+
+    if (nBytes > pring->size/2 - sizeof(shmFrame)) return asynOverflow;
+    epicsTimeGetCurrent(&start);
+    while (pring->size - (head - (epicsUInt32)epicsAtomicGetIntT(&pring->tail)) < total) {
+        double left = timeLeft(&start, timeout);
+        /* Announce that we will sleep, then look again before sleeping */
+        epicsAtomicCmpAndSwapIntT(&pring->writerWaiting, 0, 1);
+        if (pring->size - (head - (epicsUInt32)epicsAtomicGetIntT(&pring->tail)) >= total) {
+            epicsAtomicCmpAndSwapIntT(&pring->writerWaiting, 1, 0);
+            break;
+        }
+        if (left == 0 || semWait(&pring->spaceReady, left) != asynSuccess) {
+            epicsAtomicCmpAndSwapIntT(&pring->writerWaiting, 1, 0);
+            return asynTimeout;
+        }
+    }
+    frame.length = (epicsUInt32)nBytes;
+    frame.type = type;
+    ringCopyIn(pring, pep->outData, head, &frame, sizeof(frame));
+    ringCopyIn(pring, pep->outData, head + sizeof(frame), data, nBytes);
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetIntT(&pring->head, (int)(head + total));
+    if (epicsAtomicCmpAndSwapIntT(&pring->readerWaiting, 1, 0) == 1)
+        sem_post(&pring->dataReady);
+    return asynSuccess;
+}
+
+/*
+ * Waits for the next input frame and returns its header without consuming it.
+ * The length comes from the other process, so a frame that could not have
+ * been written by frameWrite is counted as discarded along with everything
+ * queued behind it, and the wait starts again from the producer's head.
+ */
+static asynStatus framePeek(shmEndpoint *pep, shmFrame *pframe, double timeout)
+{
+    shmRing *pring = pep->in;
+    epicsUInt32 tail = (epicsUInt32)epicsAtomicGetIntT(&pring->tail);
+    epicsUInt32 head;
+    epicsTimeStamp start;
+
+    epicsTimeGetCurrent(&start);
+    while (1) {
+        while ((head = (epicsUInt32)epicsAtomicGetIntT(&pring->head)) == tail) {
+            double left = timeLeft(&start, timeout);
+            epicsAtomicCmpAndSwapIntT(&pring->readerWaiting, 0, 1);
+            if ((epicsUInt32)epicsAtomicGetIntT(&pring->head) != tail) {
+                epicsAtomicCmpAndSwapIntT(&pring->readerWaiting, 1, 0);
+                continue;
+            }
+            if (left == 0 || semWait(&pring->dataReady, left) != asynSuccess) {
+                epicsAtomicCmpAndSwapIntT(&pring->readerWaiting, 1, 0);
+                return asynTimeout;
+            }
+        }
+        epicsAtomicReadMemoryBarrier();
+        ringCopyOut(pring, pep->inData, tail, pframe, sizeof(*pframe));
+        if (pframe->length <= pring->size/2 - sizeof(shmFrame)
+         && frameSize(pframe->length) <= head - tail)
+            return asynSuccess;
+        pep->framesDiscarded++;
+        pep->readOffset = 0;
+        tail = head;
+        epicsAtomicSetIntT(&pring->tail, (int)tail);
+        if (epicsAtomicCmpAndSwapIntT(&pring->writerWaiting, 1, 0) == 1)
+            sem_post(&pring->spaceReady);
+    }
+}
+
+static void frameCopy(shmEndpoint *pep, epicsUInt32 offset, void *dest, size_t nBytes)
+{
+    shmRing *pring = pep->in;
+    epicsUInt32 tail = (epicsUInt32)epicsAtomicGetIntT(&pring->tail);
+
+    ringCopyOut(pring, pep->inData, tail + sizeof(shmFrame) + offset, dest, nBytes);
+}
+
+static void frameRelease(shmEndpoint *pep, const shmFrame *pframe)
+{
+    shmRing *pring = pep->in;
+    epicsUInt32 tail = (epicsUInt32)epicsAtomicGetIntT(&pring->tail);
+
+    pep->readOffset = 0;
+    /* The payload must have been read before the producer may reuse it */
+    epicsAtomicReadMemoryBarrier();
+    epicsAtomicSetIntT(&pring->tail, (int)(tail + frameSize(pframe->length)));
+    if (epicsAtomicCmpAndSwapIntT(&pring->writerWaiting, 1, 0) == 1)
+        sem_post(&pring->spaceReady);
+}
+
+static char *segmentName(const char *shmName)
+{
+    char *name = mallocMustSucceed(strlen(shmName) + 2, "drvAsynSharedMemory");
+
+    /* POSIX shared memory names start with a single slash */
+    sprintf(name, "%s%s", (shmName[0] == '/') ? "" : "/", shmName);
+    return name;
+}
+
+static void ringInit(shmSegment *pseg, int index, epicsUInt32 size, epicsUInt32 offset)
+{
+    shmRing *pring = &pseg->ring[index];
+
+    memset(pring, 0, sizeof(*pring));
+    pring->size = size;
+    pring->offset = offset;
+    sem_init(&pring->dataReady, 1, 0);
+    sem_init(&pring->spaceReady, 1, 0);
+}
+
+/* which is SHM_TO_IOC for the IOC and SHM_FROM_IOC for the client */
+static void endpointInit(shmEndpoint *pep, shmSegment *pseg, size_t mapSize, int which)
+{
+    pep->pseg = pseg;
+    pep->mapSize = mapSize;
+    pep->in = &pseg->ring[which];
+    pep->out = &pseg->ring[1 - which];
+    pep->inData = (char *)pseg + pep->in->offset;
+    pep->outData = (char *)pseg + pep->out->offset;
+    pep->readOffset = 0;
+}
+
+static asynStatus segmentCreate(shmController *pshm, epicsUInt32 ringSize)
+{
+    epicsUInt32 headerSize = (sizeof(shmSegment) + 4095) & ~4095u;
+    size_t mapSize = headerSize + 2*(size_t)ringSize;
+    shmSegment *pseg;
+    struct stat st;
+    int fd;
+
+    fd = shm_open(pshm->shmName, O_RDWR | O_CREAT, 0660);
+    if (fd < 0) {
+        printf("drvAsynSharedMemoryConfigure: shm_open %s failed: %s\n",
+                pshm->shmName, strerror(errno));
+        return asynError;
+    }
+    if (fstat(fd, &st) < 0) {
+        printf("drvAsynSharedMemoryConfigure: fstat %s failed: %s\n",
+                pshm->shmName, strerror(errno));
+        close(fd);
+        return asynError;
+    }
+    if ((size_t)st.st_size != mapSize && ftruncate(fd, mapSize) < 0) {
+        printf("drvAsynSharedMemoryConfigure: ftruncate %s failed: %s\n",
+                pshm->shmName, strerror(errno));
+        close(fd);
+        return asynError;
+    }
+    pseg = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pseg == MAP_FAILED) {
+        printf("drvAsynSharedMemoryConfigure: mmap %s failed: %s\n",
+                pshm->shmName, strerror(errno));
+        return asynError;
+    }
+    /* Keep an existing segment, and whatever is queued in it, if it has our geometry */
+    if (pseg->magic != SHM_MAGIC || pseg->segmentSize != mapSize
+     || pseg->ring[SHM_TO_IOC].size != ringSize) {
+        pseg->magic = 0;
+        pseg->segmentSize = (epicsUInt32)mapSize;
+        ringInit(pseg, SHM_TO_IOC, ringSize, headerSize);
+        ringInit(pseg, SHM_FROM_IOC, ringSize, headerSize + ringSize);
+        epicsAtomicWriteMemoryBarrier();
+        pseg->magic = SHM_MAGIC;
+    }
+    endpointInit(&pshm->ep, pseg, mapSize, SHM_TO_IOC);
+    return asynSuccess;
+}
+
+/*
+ * Companion process interface
+ */
+drvAsynShmClient *drvAsynShmClientOpen(const char *shmName)
+{
+    drvAsynShmClient *pclient;
+    shmSegment *pseg;
+    struct stat st;
+    char *name;
+    int fd;
+
+    if (!shmName || !*shmName) return NULL;
+    name = segmentName(shmName);
+    fd = shm_open(name, O_RDWR, 0);
+    free(name);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(shmSegment)) {
+        close(fd);
+        return NULL;
+    }
+    pseg = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pseg == MAP_FAILED) return NULL;
+    if (pseg->magic != SHM_MAGIC || pseg->segmentSize != (epicsUInt32)st.st_size) {
+        munmap(pseg, st.st_size);
+        return NULL;
+    }
+    epicsAtomicReadMemoryBarrier();
+    pclient = callocMustSucceed(1, sizeof(*pclient), "drvAsynShmClientOpen");
+    endpointInit(&pclient->ep, pseg, st.st_size, SHM_FROM_IOC);
+    return pclient;
+}
+
+void drvAsynShmClientClose(drvAsynShmClient *pclient)
+{
+    if (!pclient) return;
+    munmap(pclient->ep.pseg, pclient->ep.mapSize);
+    free(pclient);
+}
+
+asynStatus drvAsynShmClientWrite(drvAsynShmClient *pclient, drvAsynShmFrameType type,
+                                 const void *data, size_t nBytes, double timeout)
+{
+    if ((int)type < 0 || type >= drvAsynShmNumFrameTypes) return asynError;
+    return frameWrite(&pclient->ep, type, data, nBytes, timeout);
+}
+
+asynStatus drvAsynShmClientRead(drvAsynShmClient *pclient, drvAsynShmFrameType *ptype,
+                                void *buffer, size_t bufferSize, size_t *nBytes,
+                                double timeout)
+{
+    shmFrame frame;
+    asynStatus status;
+    size_t n;
+
+    *nBytes = 0;
+    status = framePeek(&pclient->ep, &frame, timeout);
+    if (status != asynSuccess) return status;
+    n = (frame.length < bufferSize) ? frame.length : bufferSize;
+    frameCopy(&pclient->ep, 0, buffer, n);
+    frameRelease(&pclient->ep, &frame);
+    *ptype = (drvAsynShmFrameType)frame.type;
+    *nBytes = n;
+    return (n < frame.length) ? asynOverflow : asynSuccess;
+}
+
+/*
+ * asynCommon methods
+ */
+static void
+shmReport(void *drvPvt, FILE *fp, int details)
+{
+    shmController *pshm = (shmController *)drvPvt;
+    shmRing *pin = pshm->ep.in, *pout = pshm->ep.out;
+
+    fprintf(fp, "Shared memory %s, %s, ring size %u\n", pshm->shmName,
+            pshm->useCallbacks ? "callbacks" : "read on request", pin->size);
+    if (details >= 1) {
+        fprintf(fp, "    Input queued: %u bytes  Output queued: %u bytes\n",
+                (epicsUInt32)epicsAtomicGetIntT(&pin->head) - (epicsUInt32)epicsAtomicGetIntT(&pin->tail),
+                (epicsUInt32)epicsAtomicGetIntT(&pout->head) - (epicsUInt32)epicsAtomicGetIntT(&pout->tail));
+        fprintf(fp, "    Frames read: %lu (%lu bytes)  written: %lu (%lu bytes)  discarded: %lu\n",
+                pshm->framesRead, pshm->bytesRead, pshm->framesWritten,
+                pshm->bytesWritten, pshm->ep.framesDiscarded);
+    }
+}
+
+static asynStatus
+shmConnect(void *drvPvt, asynUser *pasynUser)
+{
+    pasynManager->exceptionConnect(pasynUser);
+    return asynSuccess;
+}
+
+static asynStatus
+shmDisconnect(void *drvPvt, asynUser *pasynUser)
+{
+    pasynManager->exceptionDisconnect(pasynUser);
+    return asynSuccess;
+}
+
+static asynCommon drvAsynSharedMemoryCommon = {
+    shmReport,
+    shmConnect,
+    shmDisconnect
+};
+
+/*
+ * Reads on request; only allowed when the port does not do callbacks
+ */
+static asynStatus
+shmNextFrame(shmController *pshm, asynUser *pasynUser,
+             drvAsynShmFrameType type, shmFrame *pframe)
+{
+    asynStatus status;
+
+    if (pshm->useCallbacks) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                      "%s does callbacks, read is not allowed", pshm->portName);
+        return asynError;
+    }
+    status = framePeek(&pshm->ep, pframe, pasynUser->timeout);
+    if (status != asynSuccess) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                      "%s timeout", pshm->portName);
+        return status;
+    }
+    if (pframe->type != (epicsUInt32)type) {
+        frameRelease(&pshm->ep, pframe);
+        pshm->ep.framesDiscarded++;
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                      "%s expected %s frame, discarded %s frame", pshm->portName,
+                      frameTypeNames[type],
+                      (pframe->type < drvAsynShmNumFrameTypes) ? frameTypeNames[pframe->type] : "unknown");
+        return asynError;
+    }
+    return asynSuccess;
+}
+
+static asynStatus
+shmArrayRead(shmController *pshm, asynUser *pasynUser, drvAsynShmFrameType type,
+             void *value, size_t nelements, size_t elementSize, size_t *nIn)
+{
+    shmFrame frame;
+    asynStatus status;
+    size_t n;
+
+    *nIn = 0;
+    status = shmNextFrame(pshm, pasynUser, type, &frame);
+    if (status != asynSuccess) return status;
+    n = frame.length / elementSize;
+    if (n > nelements) n = nelements;
+    frameCopy(&pshm->ep, 0, value, n * elementSize);
+    frameRelease(&pshm->ep, &frame);
+    pshm->framesRead++;
+    pshm->bytesRead += frame.length;
+    *nIn = n;
+    asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, (char *)value, n * elementSize,
+                "%s read %s %lu elements\n", pshm->portName, frameTypeNames[type],
+                (unsigned long)n);
+    if (frame.length / elementSize > nelements) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                      "%s %s frame of %lu bytes truncated to %lu elements", pshm->portName,
+                      frameTypeNames[type], (unsigned long)frame.length, (unsigned long)n);
+        return asynOverflow;
+    }
+    return asynSuccess;
+}
+
+static asynStatus
+shmArrayWrite(shmController *pshm, asynUser *pasynUser, drvAsynShmFrameType type,
+              const void *value, size_t nelements, size_t elementSize)
+{
+    asynStatus status;
+
+    status = frameWrite(&pshm->ep, type, value, nelements * elementSize, pasynUser->timeout);
+    if (status != asynSuccess) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                      "%s %s writing %lu bytes", pshm->portName,
+                      (status == asynOverflow) ? "frame larger than half the ring" : "timeout",
+                      (unsigned long)(nelements * elementSize));
+        return status;
+    }
+    pshm->framesWritten++;
+    pshm->bytesWritten += nelements * elementSize;
+    asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, (const char *)value, nelements * elementSize,
+                "%s write %s %lu elements\n", pshm->portName, frameTypeNames[type],
+                (unsigned long)nelements);
+    return asynSuccess;
+}
+
+/*
+ * asynOctet methods.  A read returns at most one frame, with ASYN_EOM_END
+ * when the end of the frame has been reached.
+ */
+static asynStatus
+shmReadOctet(void *drvPvt, asynUser *pasynUser,
+             char *data, size_t maxchars, size_t *nbytesTransfered, int *gotEom)
+{
+    shmController *pshm = (shmController *)drvPvt;
+    shmFrame frame;
+    asynStatus status;
+    size_t n;
+
+    *nbytesTransfered = 0;
+    if (gotEom) *gotEom = 0;
+    if (maxchars == 0) return asynSuccess;
+    status = shmNextFrame(pshm, pasynUser, drvAsynShmOctet, &frame);
+    if (status != asynSuccess) return status;
+    n = frame.length - pshm->ep.readOffset;
+    if (n > maxchars) n = maxchars;
+    frameCopy(&pshm->ep, pshm->ep.readOffset, data, n);
+    pshm->ep.readOffset += (epicsUInt32)n;
+    pshm->bytesRead += n;
+    if (pshm->ep.readOffset == frame.length) {
+        frameRelease(&pshm->ep, &frame);
+        pshm->framesRead++;
+        if (gotEom) *gotEom = ASYN_EOM_END;
+    } else if (gotEom) {
+        *gotEom = ASYN_EOM_CNT;
+    }
+    *nbytesTransfered = n;
+    asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, data, n,
+                "%s read %lu\n", pshm->portName, (unsigned long)n);
+    return asynSuccess;
+}
+
+static asynStatus
+shmWriteOctet(void *drvPvt, asynUser *pasynUser,
+              const char *data, size_t numchars, size_t *nbytesTransfered)
+{
+    shmController *pshm = (shmController *)drvPvt;
+    asynStatus status;
+
+    *nbytesTransfered = 0;
+    status = shmArrayWrite(pshm, pasynUser, drvAsynShmOctet, data, numchars, 1);
+    if (status == asynSuccess) *nbytesTransfered = numchars;
+    return status;
+}
+
+static asynStatus
+shmFlushOctet(void *drvPvt, asynUser *pasynUser)
+{
+    shmController *pshm = (shmController *)drvPvt;
+    shmFrame frame;
+
+    if (pshm->useCallbacks) return asynSuccess;
+    while (framePeek(&pshm->ep, &frame, 0) == asynSuccess) {
+        frameRelease(&pshm->ep, &frame);
+        pshm->ep.framesDiscarded++;
+    }
+    return asynSuccess;
+}
+
+static asynOctet drvAsynSharedMemoryOctet = {
+    shmWriteOctet,
+    shmReadOctet,
+    shmFlushOctet
+};
+
+/*
+ * Array interfaces and their callbacks
+ */
+#define SHM_ARRAY_FUNCS(INTERFACE, EPICS_TYPE, FRAME_TYPE) \
+static asynStatus shmWrite##INTERFACE(void *drvPvt, asynUser *pasynUser, \
+                                      EPICS_TYPE *value, size_t nelements) \
+{ \
+    return shmArrayWrite((shmController *)drvPvt, pasynUser, FRAME_TYPE, \
+                         value, nelements, sizeof(EPICS_TYPE)); \
+} \
+static asynStatus shmRead##INTERFACE(void *drvPvt, asynUser *pasynUser, \
+                                     EPICS_TYPE *value, size_t nelements, size_t *nIn) \
+{ \
+    return shmArrayRead((shmController *)drvPvt, pasynUser, FRAME_TYPE, \
+                        value, nelements, sizeof(EPICS_TYPE), nIn); \
+} \
+static asyn##INTERFACE shm##INTERFACE = { shmWrite##INTERFACE, shmRead##INTERFACE, 0, 0 }; \
+static void shmCallback##INTERFACE(shmController *pshm, void *data, size_t nBytes) \
+{ \
+    ELLLIST *pclientList; \
+    interruptNode *pnode; \
+ \
+    pasynManager->interruptStart(pshm->callbackPvt[FRAME_TYPE], &pclientList); \
+    pnode = (interruptNode *)ellFirst(pclientList); \
+    while (pnode) { \
+        asyn##INTERFACE##Interrupt *pinterrupt = pnode->drvPvt; \
+        pinterrupt->callback(pinterrupt->userPvt, pinterrupt->pasynUser, \
+                             (EPICS_TYPE *)data, nBytes/sizeof(EPICS_TYPE)); \
+        pnode = (interruptNode *)ellNext(&pnode->node); \
+    } \
+    pasynManager->interruptEnd(pshm->callbackPvt[FRAME_TYPE]); \
+}
+
+SHM_ARRAY_FUNCS(Int8Array,    epicsInt8,    drvAsynShmInt8Array)
+SHM_ARRAY_FUNCS(Int16Array,   epicsInt16,   drvAsynShmInt16Array)
+SHM_ARRAY_FUNCS(Int32Array,   epicsInt32,   drvAsynShmInt32Array)
+SHM_ARRAY_FUNCS(Int64Array,   epicsInt64,   drvAsynShmInt64Array)
+SHM_ARRAY_FUNCS(Float32Array, epicsFloat32, drvAsynShmFloat32Array)
+SHM_ARRAY_FUNCS(Float64Array, epicsFloat64, drvAsynShmFloat64Array)
+
+static void shmCallbackOctet(shmController *pshm, void *data, size_t nBytes)
+{
+    ELLLIST *pclientList;
+    interruptNode *pnode;
+
+    pasynManager->interruptStart(pshm->callbackPvt[drvAsynShmOctet], &pclientList);
+    pnode = (interruptNode *)ellFirst(pclientList);
+    while (pnode) {
+        asynOctetInterrupt *pinterrupt = pnode->drvPvt;
+        pinterrupt->callback(pinterrupt->userPvt, pinterrupt->pasynUser,
+                             (char *)data, nBytes, ASYN_EOM_END);
+        pnode = (interruptNode *)ellNext(&pnode->node);
+    }
+    pasynManager->interruptEnd(pshm->callbackPvt[drvAsynShmOctet]);
+}
+
+typedef void (*shmCallbackFunc)(shmController *pshm, void *data, size_t nBytes);
+static const shmCallbackFunc shmCallbacks[drvAsynShmNumFrameTypes] = {
+    shmCallbackOctet,
+    shmCallbackInt8Array,
+    shmCallbackInt16Array,
+    shmCallbackInt32Array,
+    shmCallbackInt64Array,
+    shmCallbackFloat32Array,
+    shmCallbackFloat64Array
+};
+
+/*
+ * With useCallbacks this thread is the only consumer of the input ring.
+ * Each frame is copied to an aligned buffer and passed to the interrupt
+ * users of the interface that matches its type.
+ */
+static void
+shmCallbackThread(void *arg)
+{
+    shmController *pshm = (shmController *)arg;
+    shmFrame frame;
+
+    while (1) {
+        if (framePeek(&pshm->ep, &frame, -1) != asynSuccess) {
+            epicsThreadSleep(0.1);
+            continue;
+        }
+        if (frame.type >= drvAsynShmNumFrameTypes) {
+            frameRelease(&pshm->ep, &frame);
+            pshm->ep.framesDiscarded++;
+            continue;
+        }
+        frameCopy(&pshm->ep, 0, pshm->callbackBuffer, frame.length);
+        frameRelease(&pshm->ep, &frame);
+        pshm->framesRead++;
+        pshm->bytesRead += frame.length;
+        asynPrintIO(pshm->pasynUser, ASYN_TRACEIO_DRIVER, pshm->callbackBuffer, frame.length,
+                    "%s callback %s %u bytes\n", pshm->portName,
+                    frameTypeNames[frame.type], frame.length);
+        shmCallbacks[frame.type](pshm, pshm->callbackBuffer, frame.length);
+    }
+}
+
+/*
+ * Configure and register a shared memory port
+ */
+int
+drvAsynSharedMemoryConfigure(const char *portName,
+                             const char *shmName,
+                             int ringSize,
+                             int useCallbacks,
+                             unsigned int priority,
+                             int noAutoConnect)
+{
+    static const char *interfaceTypes[drvAsynShmNumFrameTypes] = {
+        asynOctetType, asynInt8ArrayType, asynInt16ArrayType, asynInt32ArrayType,
+        asynInt64ArrayType, asynFloat32ArrayType, asynFloat64ArrayType
+    };
+    static void *arrayInterfaces[drvAsynShmNumFrameTypes] = {
+        NULL, &shmInt8Array, &shmInt16Array, &shmInt32Array,
+        &shmInt64Array, &shmFloat32Array, &shmFloat64Array
+    };
+    shmController *pshm;
+    epicsUInt32 size;
+    asynStatus status;
+    int i;
+
+    if (portName == NULL || shmName == NULL || *shmName == '\0') {
+        printf("Usage: drvAsynSharedMemoryConfigure portName shmName ringSize useCallbacks priority noAutoConnect\n");
+        return -1;
+    }
+    if (ringSize <= 0) ringSize = SHM_DEFAULT_RING_SIZE;
+    for (size = 4096; size < (epicsUInt32)ringSize && size < 0x40000000u; size <<= 1)
+        ;
+    pshm = callocMustSucceed(1, sizeof(*pshm), "drvAsynSharedMemoryConfigure()");
+    pshm->portName = epicsStrDup(portName);
+    pshm->shmName = segmentName(shmName);
+    pshm->useCallbacks = useCallbacks;
+    if (segmentCreate(pshm, size) != asynSuccess) return -1;
+    if (useCallbacks)
+        pshm->callbackBuffer = mallocMustSucceed(size/2 + SHM_ALIGN, "drvAsynSharedMemoryConfigure()");
+
+    if (pasynManager->registerPort(pshm->portName,
+            ASYN_CANBLOCK,
+            !noAutoConnect,
+            priority,
+            0) != asynSuccess) {
+        printf("drvAsynSharedMemoryConfigure: Can't register myself.\n");
+        return -1;
+    }
+    pshm->common.interfaceType = asynCommonType;
+    pshm->common.pinterface = &drvAsynSharedMemoryCommon;
+    pshm->common.drvPvt = pshm;
+    if (pasynManager->registerInterface(pshm->portName, &pshm->common) != asynSuccess) {
+        printf("drvAsynSharedMemoryConfigure: Can't register common.\n");
+        return -1;
+    }
+    pshm->octet.interfaceType = asynOctetType;
+    pshm->octet.pinterface = &drvAsynSharedMemoryOctet;
+    pshm->octet.drvPvt = pshm;
+    if (pasynOctetBase->initialize(pshm->portName, &pshm->octet, 0, 0, 0) != asynSuccess) {
+        printf("drvAsynSharedMemoryConfigure: pasynOctetBase->initialize failed.\n");
+        return -1;
+    }
+    if (pasynManager->registerInterruptSource(pshm->portName, &pshm->octet,
+            &pshm->callbackPvt[drvAsynShmOctet]) != asynSuccess) {
+        printf("drvAsynSharedMemoryConfigure registerInterruptSource failed\n");
+        return -1;
+    }
+    for (i = drvAsynShmInt8Array; i < drvAsynShmNumFrameTypes; i++) {
+        pshm->array[i].interfaceType = interfaceTypes[i];
+        pshm->array[i].pinterface = arrayInterfaces[i];
+        pshm->array[i].drvPvt = pshm;
+    }
+    status = pasynInt8ArrayBase->initialize(pshm->portName, &pshm->array[drvAsynShmInt8Array]);
+    if (status == asynSuccess)
+        status = pasynInt16ArrayBase->initialize(pshm->portName, &pshm->array[drvAsynShmInt16Array]);
+    if (status == asynSuccess)
+        status = pasynInt32ArrayBase->initialize(pshm->portName, &pshm->array[drvAsynShmInt32Array]);
+    if (status == asynSuccess)
+        status = pasynInt64ArrayBase->initialize(pshm->portName, &pshm->array[drvAsynShmInt64Array]);
+    if (status == asynSuccess)
+        status = pasynFloat32ArrayBase->initialize(pshm->portName, &pshm->array[drvAsynShmFloat32Array]);
+    if (status == asynSuccess)
+        status = pasynFloat64ArrayBase->initialize(pshm->portName, &pshm->array[drvAsynShmFloat64Array]);
+    if (status != asynSuccess) {
+        printf("drvAsynSharedMemoryConfigure: array interface initialize failed.\n");
+        return -1;
+    }
+    for (i = drvAsynShmInt8Array; i < drvAsynShmNumFrameTypes; i++) {
+        if (pasynManager->registerInterruptSource(pshm->portName, &pshm->array[i],
+                &pshm->callbackPvt[i]) != asynSuccess) {
+            printf("drvAsynSharedMemoryConfigure registerInterruptSource failed\n");
+            return -1;
+        }
+    }
+    pshm->pasynUser = pasynManager->createAsynUser(0, 0);
+    if (pasynManager->connectDevice(pshm->pasynUser, pshm->portName, -1) != asynSuccess) {
+        printf("connectDevice failed %s\n", pshm->pasynUser->errorMessage);
+        return -1;
+    }
+    if (useCallbacks) {
+        epicsThreadCreate(pshm->portName,
+                priority ? priority : epicsThreadPriorityMedium,
+                epicsThreadGetStackSize(epicsThreadStackSmall),
+                shmCallbackThread, pshm);
+    }
+    return 0;
+}
+
+/*
+ * IOC shell command registration
+ */
+static const iocshArg drvAsynSharedMemoryConfigureArg0 = {"port name", iocshArgString};
+static const iocshArg drvAsynSharedMemoryConfigureArg1 = {"shared memory name", iocshArgString};
+static const iocshArg drvAsynSharedMemoryConfigureArg2 = {"ring size", iocshArgInt};
+static const iocshArg drvAsynSharedMemoryConfigureArg3 = {"use callbacks", iocshArgInt};
+static const iocshArg drvAsynSharedMemoryConfigureArg4 = {"priority", iocshArgInt};
+static const iocshArg drvAsynSharedMemoryConfigureArg5 = {"disable auto-connect", iocshArgInt};
+
+static const iocshArg *drvAsynSharedMemoryConfigureArgs[] = {
+    &drvAsynSharedMemoryConfigureArg0, &drvAsynSharedMemoryConfigureArg1,
+    &drvAsynSharedMemoryConfigureArg2, &drvAsynSharedMemoryConfigureArg3,
+    &drvAsynSharedMemoryConfigureArg4, &drvAsynSharedMemoryConfigureArg5};
+
+static const iocshFuncDef drvAsynSharedMemoryConfigureFuncDef =
+    {"drvAsynSharedMemoryConfigure", 6, drvAsynSharedMemoryConfigureArgs};
+
+static void drvAsynSharedMemoryConfigureCallFunc(const iocshArgBuf *args)
+{
+    drvAsynSharedMemoryConfigure(args[0].sval, args[1].sval, args[2].ival,
+            args[3].ival, args[4].ival, args[5].ival);
+}
+
+/*
+ * This routine is called before multitasking has started, so there's
+ * no race condition in the test/set of firstTime.
+ */
+static void
+drvAsynSharedMemoryRegisterCommands(void)
+{
+    static int firstTime = 1;
+    if (firstTime) {
+        iocshRegister(&drvAsynSharedMemoryConfigureFuncDef, drvAsynSharedMemoryConfigureCallFunc);
+        firstTime = 0;
+    }
+}
+epicsExportRegistrar(drvAsynSharedMemoryRegisterCommands);
@@ -0,0 +1,59 @@
+/**********************************************************************
+* Asyn port driver using a shared memory ring to another process      *
+**********************************************************************/
+/***********************************************************************
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+* National Laboratory, and the Regents of the University of
+* California, as Operator of Los Alamos National Laboratory, and
+* Berliner Elektronenspeicherring-Gesellschaft m.b.H. (BESSY).
+* asynDriver is distributed subject to a Software License Agreement
+* found in file LICENSE that is included with this distribution.
+***********************************************************************/
+
+#ifndef DRVASYNSHAREDMEMORY_H
+#define DRVASYNSHAREDMEMORY_H
+
+#include <shareLib.h>
+#include "asynDriver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/* Every message in the rings is one frame of one of these types */
+typedef enum {
+    drvAsynShmOctet,
+    drvAsynShmInt8Array,
+    drvAsynShmInt16Array,
+    drvAsynShmInt32Array,
+    drvAsynShmInt64Array,
+    drvAsynShmFloat32Array,
+    drvAsynShmFloat64Array,
+    drvAsynShmNumFrameTypes
+} drvAsynShmFrameType;
+
+epicsShareFunc int drvAsynSharedMemoryConfigure(const char *portName,
+                                                const char *shmName,
+                                                int ringSize,
+                                                int useCallbacks,
+                                                unsigned int priority,
+                                                int noAutoConnect);
+
+/* The other end of the segment, for the companion process.
+ * A client must be used by one thread only. */
+typedef struct drvAsynShmClient drvAsynShmClient;
+epicsShareFunc drvAsynShmClient *drvAsynShmClientOpen(const char *shmName);
+epicsShareFunc void drvAsynShmClientClose(drvAsynShmClient *pclient);
+epicsShareFunc asynStatus drvAsynShmClientWrite(drvAsynShmClient *pclient,
+                                                drvAsynShmFrameType type,
+                                                const void *data, size_t nBytes,
+                                                double timeout);
+epicsShareFunc asynStatus drvAsynShmClientRead(drvAsynShmClient *pclient,
+                                               drvAsynShmFrameType *ptype,
+                                               void *buffer, size_t bufferSize,
+                                               size_t *nBytes, double timeout);
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
+#endif  /* DRVASYNSHAREDMEMORY_H */
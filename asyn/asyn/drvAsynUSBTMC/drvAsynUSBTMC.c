@@ -8,6 +8,7 @@
  ***************************************************************************
  */
 
+#include <stdlib.h>
 #include <string.h>
 #include <errlog.h>
 #include <epicsStdio.h>
@@ -16,6 +17,7 @@
 #include <epicsMessageQueue.h>
 #include <epicsMutex.h>
 #include <epicsThread.h>
+#include <epicsTime.h>
 #include <epicsExport.h>
 #include <cantProceed.h>
 #include <iocsh.h>
@@ -36,6 +38,16 @@
 #define BULK_IO_PAYLOAD_CAPACITY 4096
 #define IDSTRING_CAPACITY        100
 
+/*
+ * Asynchronous bulk-in transfer ring
+ */
+#define RING_TRANSFER_COUNT      4
+#define RING_TRANSFER_SIZE       16384
+#define RING_PAYLOAD_CAPACITY    ((RING_TRANSFER_COUNT*RING_TRANSFER_SIZE)-BULK_IO_HEADER_SIZE)
+
+#define FLAG_NO_AUTOCONNECT      0x1
+#define FLAG_ASYNC_BULK_IN       0x2
+
 #define ASYN_REASON_SRQ 4345
 #define ASYN_REASON_STB 4346
 #define ASYN_REASON_REN 4347
@@ -44,6 +56,12 @@
 # error "You need to get a newer version of libsb-1.0 (16 at the very least)"
 #endif
 
+typedef struct ringEntry {
+    struct libusb_transfer *transfer;
+    int                     isSubmitted;
+    int                     isCompleted;
+} ringEntry;
+
 typedef struct drvPvt {
     /*
      * Used to find matching device
@@ -112,6 +130,18 @@ typedef struct drvPvt {
     const unsigned char   *bufp;
     unsigned char          bulkInPacketFlags;
 
+    /*
+     * Asynchronous bulk-in transfer ring.
+     * The transfer at ringHead is the next to complete.  While ringHeld
+     * is set its data is being consumed through bufp/bufCount.
+     */
+    int                    useRing;
+    ringEntry              ring[RING_TRANSFER_COUNT];
+    int                    ringHead;
+    int                    ringHeld;
+    int                    ringPayloadRemaining;
+    int                    ringTrailerPending;
+
     /*
      * Statistics
      */
@@ -119,6 +149,7 @@ typedef struct drvPvt {
     size_t                 interruptCount;
     size_t                 bytesSentCount;
     size_t                 bytesReceivedCount;
+    size_t                 ringTransferCount;
 } drvPvt;
 
 static asynStatus disconnect(void *pvt, asynUser *pasynUser);
@@ -205,6 +236,147 @@ startInterruptThread(drvPvt *pdpvt)
     epicsMutexUnlock(pdpvt->interruptTidMutex);
 }
 
+/*
+ * Asynchronous bulk-in transfer ring support
+ */
+static void LIBUSB_CALL
+ringCallback(struct libusb_transfer *transfer)
+{
+    ringEntry *pentry = (ringEntry *)transfer->user_data;
+
+    pentry->isCompleted = 1;
+}
+
+static int
+ringSubmit(drvPvt *pdpvt, ringEntry *pentry)
+{
+    int s;
+
+    libusb_fill_bulk_transfer(pentry->transfer, pdpvt->handle,
+                              pdpvt->bulkInEndpointAddress,
+                              pentry->transfer->buffer, RING_TRANSFER_SIZE,
+                              ringCallback, pentry, 0);
+    pentry->isCompleted = 0;
+    s = libusb_submit_transfer(pentry->transfer);
+    pentry->isSubmitted = (s == 0);
+    return s;
+}
+
+static int
+ringStart(drvPvt *pdpvt)
+{
+    int i;
+    int s;
+
+    pdpvt->ringHead = 0;
+    pdpvt->ringHeld = 0;
+    pdpvt->ringPayloadRemaining = 0;
+    pdpvt->ringTrailerPending = 0;
+    for (i = 0 ; i < RING_TRANSFER_COUNT ; i++) {
+        s = ringSubmit(pdpvt, &pdpvt->ring[i]);
+        if (s)
+            return s;
+    }
+    return 0;
+}
+
+/*
+ * Cancel all outstanding transfers and wait for their callbacks
+ */
+static void
+ringStop(drvPvt *pdpvt)
+{
+    int i;
+    int pass;
+
+    for (i = 0 ; i < RING_TRANSFER_COUNT ; i++) {
+        if (pdpvt->ring[i].isSubmitted && !pdpvt->ring[i].isCompleted)
+            libusb_cancel_transfer(pdpvt->ring[i].transfer);
+    }
+    for (i = 0 ; i < RING_TRANSFER_COUNT ; i++) {
+        ringEntry *pentry = &pdpvt->ring[i];
+        for (pass = 0 ; pentry->isSubmitted && !pentry->isCompleted ; pass++) {
+            struct timeval tv = { 0, 100000 };
+            if (pass == 20) {
+                errlogPrintf("----- WARNING ----- "
+                             "Bulk-in transfer for ASYN port \"%s\" "
+                             "won't cancel!\n", pdpvt->portName);
+                break;
+            }
+            libusb_handle_events_timeout_completed(pdpvt->usb, &tv,
+                                                   &pentry->isCompleted);
+        }
+        pentry->isSubmitted = 0;
+    }
+    pdpvt->ringHeld = 0;
+    pdpvt->bufCount = 0;
+}
+
+/*
+ * Wait for the transfer at the head of the ring to complete.
+ * Events are handled by the calling (port) thread.
+ */
+static int
+ringWait(drvPvt *pdpvt, double timeout)
+{
+    ringEntry *pentry = &pdpvt->ring[pdpvt->ringHead];
+    epicsTimeStamp deadline;
+
+    if (!pentry->isSubmitted)
+        return LIBUSB_ERROR_IO;
+    epicsTimeGetCurrent(&deadline);
+    epicsTimeAddSeconds(&deadline, timeout);
+    while (!pentry->isCompleted) {
+        struct timeval tv = { 1, 0 };
+        int s;
+
+        if (timeout >= 0) {
+            epicsTimeStamp now;
+            double remaining;
+
+            epicsTimeGetCurrent(&now);
+            remaining = epicsTimeDiffInSeconds(&deadline, &now);
+            if (remaining <= 0)
+                return LIBUSB_ERROR_TIMEOUT;
+            if (remaining < 1.0) {
+                tv.tv_sec = 0;
+                tv.tv_usec = remaining * 1e6;
+            }
+        }
+        s = libusb_handle_events_timeout_completed(pdpvt->usb, &tv,
+                                                   &pentry->isCompleted);
+        if (s && (s != LIBUSB_ERROR_INTERRUPTED))
+            return s;
+    }
+    pdpvt->ringHeld = 1;
+    pdpvt->ringTransferCount++;
+    switch (pentry->transfer->status) {
+    case LIBUSB_TRANSFER_COMPLETED: return 0;
+    case LIBUSB_TRANSFER_TIMED_OUT: return LIBUSB_ERROR_TIMEOUT;
+    case LIBUSB_TRANSFER_STALL:     return LIBUSB_ERROR_PIPE;
+    case LIBUSB_TRANSFER_NO_DEVICE: return LIBUSB_ERROR_NO_DEVICE;
+    case LIBUSB_TRANSFER_OVERFLOW:  return LIBUSB_ERROR_OVERFLOW;
+    default:                        return LIBUSB_ERROR_IO;
+    }
+}
+
+/*
+ * Give the transfer at the head of the ring back to libusb
+ */
+static int
+ringRelease(drvPvt *pdpvt)
+{
+    int s;
+
+    if (!pdpvt->ringHeld)
+        return 0;
+    pdpvt->ringHeld = 0;
+    pdpvt->bufCount = 0;
+    s = ringSubmit(pdpvt, &pdpvt->ring[pdpvt->ringHead]);
+    pdpvt->ringHead = (pdpvt->ringHead + 1) % RING_TRANSFER_COUNT;
+    return s;
+}
+
 /*
  * Decode a status byte
  */
@@ -321,6 +493,11 @@ report(void *pvt, FILE *fp, int details)
         showCount(fp, "Interrupt", pdpvt->interruptCount);
         showCount(fp, "Send", pdpvt->bytesSentCount);
         showCount(fp, "Receive", pdpvt->bytesReceivedCount);
+        if (pdpvt->useRing) {
+            fprintf(fp, "%28s: %d transfers of %d bytes\n", "Bulk input ring",
+                                    RING_TRANSFER_COUNT, RING_TRANSFER_SIZE);
+            showCount(fp, "Ring transfer", pdpvt->ringTransferCount);
+        }
     }
     if (details >= 100) {
         int l = details % 100;
@@ -641,6 +818,16 @@ connect(void *pvt, asynUser *pasynUser)
         }
         pdpvt->bulkInPacketFlags = 0;
         pdpvt->bufCount = 0;
+        if (pdpvt->useRing) {
+            s = ringStart(pdpvt);
+            if (s) {
+                ringStop(pdpvt);
+                libusb_close(pdpvt->handle);
+                epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "Can't submit bulk-in transfer: %s", libusb_strerror(s));
+                return asynError;
+            }
+        }
         pdpvt->connectionCount++;
         startInterruptThread(pdpvt);
     }
@@ -685,6 +872,8 @@ disconnect(void *pvt, asynUser *pasynUser)
                 100);                    // timeout (ms)
             epicsEventWaitWithTimeout(pdpvt->didTerminate, 2.0);
         }
+        if (pdpvt->useRing)
+            ringStop(pdpvt);
         libusb_close(pdpvt->handle);
     }
     pdpvt->isConnected = 0;
@@ -764,6 +953,241 @@ asynOctetWrite(void *pvt, asynUser *pasynUser,
     return asynSuccess;
 }
 
+/*
+ * Ask the device to send a message of up to 'capacity' bytes
+ */
+static asynStatus
+requestRead(drvPvt *pdpvt, asynUser *pasynUser, int capacity, int timeout,
+            unsigned char *bTag)
+{
+    unsigned char cbuf[BULK_IO_HEADER_SIZE];
+    int ioCount;
+    int s;
+
+    cbuf[0] = MESSAGE_ID_REQUEST_DEV_DEP_MSG_IN;
+    cbuf[1] = pdpvt->bTag;
+    cbuf[2] = ~pdpvt->bTag;
+    cbuf[3] = 0;
+    cbuf[4] = capacity & 0xFF;
+    cbuf[5] = (capacity >> 8) & 0xFF;
+    cbuf[6] = (capacity >> 16) & 0xFF;
+    cbuf[7] = (capacity >> 24) & 0xFF;
+    if (pdpvt->termChar >= 0) {
+        cbuf[8] = 2;
+        cbuf[9] = pdpvt->termChar;
+    }
+    else {
+        cbuf[8] = 0;
+        cbuf[9] = 0;
+    }
+    cbuf[10] = 0;
+    cbuf[11] = 0;
+    *bTag = pdpvt->bTag;
+    pdpvt->bTag = (pdpvt->bTag == 0xFF) ? 0x1 : pdpvt->bTag + 1;
+    asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, (const char *)cbuf,
+                        BULK_IO_HEADER_SIZE,
+                        "Request %d, command: ", capacity);
+    s = libusb_bulk_transfer(pdpvt->handle, pdpvt->bulkOutEndpointAddress,
+                      cbuf, BULK_IO_HEADER_SIZE, &ioCount, timeout);
+    if (s) {
+        disconnectIfGone(pdpvt, pasynUser, s);
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "Bulk transfer request failed: %s", libusb_strerror(s));
+        return asynError;
+    }
+    return asynSuccess;
+}
+
+/*
+ * Sanity check on the header of a bulk-in message
+ */
+static asynStatus
+checkReadHeader(asynUser *pasynUser, const unsigned char *buf, int ioCount,
+                unsigned char bTag, int capacity, int *payloadSize)
+{
+    if (ioCount < BULK_IO_HEADER_SIZE) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                        "Incomplete packet header (read only %d)", ioCount);
+        return asynError;
+    }
+    if ((buf[0] != MESSAGE_ID_REQUEST_DEV_DEP_MSG_IN)
+     || (buf[1] != bTag)
+     || (buf[2] != (unsigned char)~bTag)) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                        "Packet header corrupt %x %x %x (btag %x)",
+                                            buf[0], buf[1], buf[2], bTag);
+        return asynError;
+    }
+    *payloadSize = buf[4]        |
+                  (buf[5] << 8)  |
+                  (buf[6] << 16) |
+                  (buf[7] << 24);
+    if (*payloadSize > capacity) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                "Packet header claims %d sent, but requested only %d",
+                                                    *payloadSize, capacity);
+        return asynError;
+    }
+    return asynSuccess;
+}
+
+/*
+ * Read using the asynchronous bulk-in transfer ring.
+ * The transfers stay queued between reads so the host controller
+ * can accept data as fast as the device sends it.
+ */
+static asynStatus
+ringRead(drvPvt *pdpvt, asynUser *pasynUser,
+         char *data, size_t maxchars, size_t *nbytesTransfered,
+         int *eomReason)
+{
+    unsigned char bTag;
+    int s;
+    int nCopy, payloadSize;
+    int eom = 0;
+    int timeout = pasynUser->timeout * 1000;
+    struct libusb_transfer *transfer;
+    if (timeout == 0) timeout = 1;
+
+    *nbytesTransfered = 0;
+    for (;;) {
+        /*
+         * Special case for stream device which requires an asynTimeout return.
+         */
+        if ((pasynUser->timeout == 0) && (pdpvt->bufCount == 0)
+                                      && (pdpvt->ringPayloadRemaining == 0))
+            return asynTimeout;
+
+        /*
+         * Transfer buffered data
+         */
+        if (pdpvt->bufCount) {
+            nCopy = maxchars;
+            if (nCopy > pdpvt->bufCount)
+                nCopy = pdpvt->bufCount;
+            memcpy(data, pdpvt->bufp, nCopy);
+            pdpvt->bufp += nCopy;
+            pdpvt->bufCount -= nCopy;
+            maxchars -= nCopy;
+            *nbytesTransfered += nCopy;
+            pdpvt->bytesReceivedCount += nCopy;
+            data += nCopy;
+            if (maxchars == 0)
+                eom |= ASYN_EOM_CNT;
+        }
+        if ((pdpvt->bufCount == 0) && (pdpvt->ringPayloadRemaining == 0)) {
+            if (pdpvt->bulkInPacketFlags & 0x2)
+                eom |= ASYN_EOM_EOS;
+            if (pdpvt->bulkInPacketFlags & 0x1)
+                eom |= ASYN_EOM_END;
+        }
+        if (eom) {
+            if (eomReason) *eomReason = eom;
+            return asynSuccess;
+        }
+
+        /*
+         * Finished with this transfer
+         */
+        s = ringRelease(pdpvt);
+        if (s) {
+            disconnectIfGone(pdpvt, pasynUser, s);
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "Can't resubmit bulk-in transfer: %s", libusb_strerror(s));
+            return asynError;
+        }
+
+        /*
+         * Rest of the message is in the following transfers
+         */
+        if (pdpvt->ringPayloadRemaining) {
+            s = ringWait(pdpvt, pasynUser->timeout);
+            if (s) {
+                disconnectIfGone(pdpvt, pasynUser, s);
+                epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                                    "Bulk read failed: %s", libusb_strerror(s));
+                return (s == LIBUSB_ERROR_TIMEOUT) ? asynTimeout : asynError;
+            }
+            transfer = pdpvt->ring[pdpvt->ringHead].transfer;
+            asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER,
+                        (const char *)transfer->buffer, transfer->actual_length,
+                        "Read %d: ", transfer->actual_length);
+            pdpvt->bufp = transfer->buffer;
+            pdpvt->bufCount = transfer->actual_length;
+            if (pdpvt->bufCount > pdpvt->ringPayloadRemaining)
+                pdpvt->bufCount = pdpvt->ringPayloadRemaining;
+            pdpvt->ringPayloadRemaining -= pdpvt->bufCount;
+            if (transfer->actual_length < transfer->length)
+                pdpvt->ringPayloadRemaining = 0; /* short packet */
+            else if (pdpvt->ringPayloadRemaining == 0)
+                pdpvt->ringTrailerPending = 1;
+            continue;
+        }
+
+        /*
+         * Request another message
+         */
+        pdpvt->bulkInPacketFlags = 0;
+        if (requestRead(pdpvt, pasynUser, RING_PAYLOAD_CAPACITY, timeout,
+                                                        &bTag) != asynSuccess)
+            return asynError;
+        for (;;) {
+            s = ringWait(pdpvt, pasynUser->timeout);
+            if (s) {
+                disconnectIfGone(pdpvt, pasynUser, s);
+                epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                                    "Bulk read failed: %s", libusb_strerror(s));
+                return (s == LIBUSB_ERROR_TIMEOUT) ? asynTimeout : asynError;
+            }
+            transfer = pdpvt->ring[pdpvt->ringHead].transfer;
+            asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER,
+                        (const char *)transfer->buffer, transfer->actual_length,
+                        "Read %d, flags %#x: ", transfer->actual_length,
+                                                        transfer->buffer[8]);
+
+            /*
+             * A message that filled its last transfer exactly is followed
+             * by a transfer holding only alignment bytes or a zero length
+             * packet.
+             */
+            if (!pdpvt->ringTrailerPending
+             || (transfer->actual_length >= BULK_IO_HEADER_SIZE))
+                break;
+            pdpvt->ringTrailerPending = 0;
+            s = ringRelease(pdpvt);
+            if (s) {
+                disconnectIfGone(pdpvt, pasynUser, s);
+                epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "Can't resubmit bulk-in transfer: %s", libusb_strerror(s));
+                return asynError;
+            }
+        }
+        pdpvt->ringTrailerPending = 0;
+        if (checkReadHeader(pasynUser, transfer->buffer, transfer->actual_length,
+                    bTag, RING_PAYLOAD_CAPACITY, &payloadSize) != asynSuccess)
+            return asynError;
+        pdpvt->bufp = &transfer->buffer[BULK_IO_HEADER_SIZE];
+        pdpvt->bufCount = transfer->actual_length - BULK_IO_HEADER_SIZE;
+        if (pdpvt->bufCount > payloadSize)
+            pdpvt->bufCount = payloadSize;
+        pdpvt->ringPayloadRemaining = payloadSize - pdpvt->bufCount;
+        if (transfer->actual_length < transfer->length) {
+            if (pdpvt->ringPayloadRemaining) {
+                epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                    "Packet header claims %d sent, but packet contains only %d",
+                                                payloadSize, pdpvt->bufCount);
+                pdpvt->bufCount = 0;
+                pdpvt->ringPayloadRemaining = 0;
+                return asynError;
+            }
+        }
+        else if (pdpvt->ringPayloadRemaining == 0) {
+            pdpvt->ringTrailerPending = 1;
+        }
+        pdpvt->bulkInPacketFlags = transfer->buffer[8];
+    }
+}
+
 static asynStatus
 asynOctetRead(void *pvt, asynUser *pasynUser,
               char *data, size_t maxchars, size_t *nbytesTransfered,
@@ -777,6 +1201,9 @@ asynOctetRead(void *pvt, asynUser *pasynUser,
     int timeout = pasynUser->timeout * 1000;
     if (timeout == 0) timeout = 1;
 
+    if (pdpvt->useRing)
+        return ringRead(pdpvt, pasynUser, data, maxchars, nbytesTransfered,
+                                                                    eomReason);
     *nbytesTransfered = 0;
     for (;;) {
         /*
@@ -817,37 +1244,9 @@ asynOctetRead(void *pvt, asynUser *pasynUser,
          * Request another chunk
          */
         pdpvt->bulkInPacketFlags = 0;
-        pdpvt->buf[0] = MESSAGE_ID_REQUEST_DEV_DEP_MSG_IN;
-        pdpvt->buf[1] = pdpvt->bTag;
-        pdpvt->buf[2] = ~pdpvt->bTag;
-        pdpvt->buf[3] = 0;
-        pdpvt->buf[4] = BULK_IO_PAYLOAD_CAPACITY & 0xFF;
-        pdpvt->buf[5] = (BULK_IO_PAYLOAD_CAPACITY >> 8) & 0xFF;
-        pdpvt->buf[6] = (BULK_IO_PAYLOAD_CAPACITY >> 16) & 0xFF;
-        pdpvt->buf[7] = (BULK_IO_PAYLOAD_CAPACITY >> 24) & 0xFF;
-        if (pdpvt->termChar >= 0) {
-            pdpvt->buf[8] = 2;
-            pdpvt->buf[9] = pdpvt->termChar;
-        }
-        else {
-            pdpvt->buf[8] = 0;
-            pdpvt->buf[9] = 0;
-        }
-        pdpvt->buf[10] = 0;
-        pdpvt->buf[11] = 0;
-        bTag = pdpvt->bTag;
-        pdpvt->bTag = (pdpvt->bTag == 0xFF) ? 0x1 : pdpvt->bTag + 1;
-        asynPrintIO(pasynUser, ASYN_TRACEIO_DRIVER, (const char *)pdpvt->buf,
-                            BULK_IO_HEADER_SIZE,
-                            "Request %d, command: ", BULK_IO_PAYLOAD_CAPACITY);
-        s = libusb_bulk_transfer(pdpvt->handle, pdpvt->bulkOutEndpointAddress,
-                          pdpvt->buf, BULK_IO_HEADER_SIZE, &ioCount, timeout);
-        if (s) {
-            disconnectIfGone(pdpvt, pasynUser, s);
-            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
-                        "Bulk transfer request failed: %s", libusb_strerror(s));
+        if (requestRead(pdpvt, pasynUser, BULK_IO_PAYLOAD_CAPACITY, timeout,
+                                                        &bTag) != asynSuccess)
             return asynError;
-        }
 
         /*
          * Read back
@@ -866,35 +1265,15 @@ asynOctetRead(void *pvt, asynUser *pasynUser,
         /*
          * Sanity check on transfer
          */
-        if (ioCount < BULK_IO_HEADER_SIZE) {
-            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
-                            "Incomplete packet header (read only %d)", ioCount);
-            return asynError;
-        }
-        if ((pdpvt->buf[0] != MESSAGE_ID_REQUEST_DEV_DEP_MSG_IN)
-         || (pdpvt->buf[1] != bTag)
-         || (pdpvt->buf[2] != (unsigned char)~bTag)) {
-            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
-                            "Packet header corrupt %x %x %x (btag %x)",
-                        pdpvt->buf[0], pdpvt->buf[1], pdpvt->buf[2], bTag);
+        if (checkReadHeader(pasynUser, pdpvt->buf, ioCount, bTag,
+                        BULK_IO_PAYLOAD_CAPACITY, &payloadSize) != asynSuccess)
             return asynError;
-        }
-        payloadSize = pdpvt->buf[4]        |
-                     (pdpvt->buf[5] << 8)  |
-                     (pdpvt->buf[6] << 16) |
-                     (pdpvt->buf[7] << 24);
         if (payloadSize > (ioCount - BULK_IO_HEADER_SIZE)) {
             epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
                 "Packet header claims %d sent, but packet contains only %d",
                             payloadSize, ioCount - BULK_IO_HEADER_SIZE);
             return asynError;
         }
-        if (payloadSize > BULK_IO_PAYLOAD_CAPACITY) {
-            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
-                    "Packet header claims %d sent, but requested only %d",
-                                    payloadSize, BULK_IO_PAYLOAD_CAPACITY);
-            return asynError;
-        }
         pdpvt->bufCount = payloadSize;
         pdpvt->bufp = &pdpvt->buf[BULK_IO_HEADER_SIZE];
 
@@ -921,6 +1300,26 @@ asynOctetFlush(void *pvt, asynUser *pasynUser)
 
     pdpvt->bufCount = 0;
     pdpvt->bulkInPacketFlags = 0;
+    if (pdpvt->useRing && pdpvt->isConnected) {
+        /*
+         * Discard the rest of a partially read message
+         */
+        while (pdpvt->ringPayloadRemaining
+            && (ringRelease(pdpvt) == 0)
+            && (ringWait(pdpvt, 1.0) == 0)) {
+            struct libusb_transfer *transfer;
+            transfer = pdpvt->ring[pdpvt->ringHead].transfer;
+            if (transfer->actual_length < transfer->length)
+                break;
+            if (transfer->actual_length >= pdpvt->ringPayloadRemaining) {
+                pdpvt->ringTrailerPending = 1;
+                break;
+            }
+            pdpvt->ringPayloadRemaining -= transfer->actual_length;
+        }
+        pdpvt->ringPayloadRemaining = 0;
+        ringRelease(pdpvt);
+    }
     return asynSuccess;
 }
 
@@ -1212,13 +1611,39 @@ usbtmcConfigure(const char *portName,
         printf("Can't create message queue!\n");
         return;
     }
+    if (flags & FLAG_ASYNC_BULK_IN) {
+        int i;
+        for (i = 0 ; i < RING_TRANSFER_COUNT ; i++) {
+            struct libusb_transfer *transfer = libusb_alloc_transfer(0);
+            if (transfer == NULL) {
+                printf("Can't allocate bulk-in transfer!\n");
+                while (--i >= 0) {
+                    free(pdpvt->ring[i].transfer->buffer);
+                    libusb_free_transfer(pdpvt->ring[i].transfer);
+                }
+                epicsMessageQueueDestroy(pdpvt->statusByteMessageQueue);
+                epicsEventDestroy(pdpvt->didTerminate);
+                epicsEventDestroy(pdpvt->pleaseTerminate);
+                epicsMutexDestroy(pdpvt->interruptTidMutex);
+                libusb_exit(pdpvt->usb);
+                free((void *)pdpvt->serialNumber);
+                free(pdpvt->interruptThreadName);
+                free(pdpvt->portName);
+                free(pdpvt);
+                return;
+            }
+            transfer->buffer = mallocMustSucceed(RING_TRANSFER_SIZE, portName);
+            pdpvt->ring[i].transfer = transfer;
+        }
+        pdpvt->useRing = 1;
+    }
 
     /*
      * Create our port
      */
     status = pasynManager->registerPort(pdpvt->portName,
                                         ASYN_CANBLOCK,
-                                        (flags & 0x1) == 0,
+                                        (flags & FLAG_NO_AUTOCONNECT) == 0,
                                         priority, 0);
     if(status != asynSuccess) {
         printf("registerPort failed\n");
@@ -180,6 +180,30 @@ static asynStatus writeIt(void *ppvt,asynUser *pasynUser,
     return status;
 }
 
+/*
+ * Find the input EOS in buf[0..len).  The search uses memchr for the first
+ * EOS character.  A two character EOS whose first character is the last
+ * character of buf is remembered in eosInMatch.
+ */
+static const char *findEos(eosPvt *peosPvt,const char *buf,size_t len)
+{
+    const char *p = buf;
+    const char *end = buf + len;
+
+    while ((p = memchr(p, peosPvt->eosIn[0], end - p)) != NULL) {
+        if (peosPvt->eosInLen == 1)
+            return p;
+        if (p + 1 == end) {
+            peosPvt->eosInMatch = 1;
+            return NULL;
+        }
+        if (p[1] == peosPvt->eosIn[1])
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
 static asynStatus readIt(void *ppvt,asynUser *pasynUser,
     char *data,size_t maxchars,size_t *nbytesTransfered,int *eomReason)
 {
@@ -194,33 +218,43 @@ static asynStatus readIt(void *ppvt,asynUser *pasynUser,
     }
     for (;;) {
         if ((peosPvt->inBufTail != peosPvt->inBufHead)) {
-            char c = *data++ = peosPvt->inBuf[peosPvt->inBufTail++];
-            nRead++;
-            if (peosPvt->eosInLen > 0) {
-                if (c == peosPvt->eosIn[peosPvt->eosInMatch]) {
-                    if (++peosPvt->eosInMatch == peosPvt->eosInLen) {
-                        peosPvt->eosInMatch = 0;
-                        nRead -= peosPvt->eosInLen;
-                        data -= peosPvt->eosInLen;
-                        *(data+1) = 0;
-                        eom |= ASYN_EOM_EOS;
-                        break;
-                    }
-                } else {
-                    /*
-                     * Resynchronize the search.  Since the driver
-                     * allows a maximum two-character EOS it doesn't
-                     * have to worry about cases like:
-                     *    End-of-string is "eeef"
-                     *    Input stream so far is "eeeeeeeee"
-                     */
-                    if (c == peosPvt->eosIn[0]) {
-                        peosPvt->eosInMatch = 1;
-                    } else {
-                        peosPvt->eosInMatch = 0;
-                    }
+            const char *pin = &peosPvt->inBuf[peosPvt->inBufTail];
+            size_t nAvail = peosPvt->inBufHead - peosPvt->inBufTail;
+            size_t nCopy = maxchars - nRead;
+            const char *peos = NULL;
+
+            if (peosPvt->eosInMatch) {
+                /*
+                 * The previous buffer ended with the first character of a
+                 * two character EOS.  That character has already been
+                 * copied to the caller.
+                 */
+                peosPvt->eosInMatch = 0;
+                if (*pin == peosPvt->eosIn[1]) {
+                    peosPvt->inBufTail++;
+                    if (nRead > 0) nRead--;
+                    eom |= ASYN_EOM_EOS;
+                    break;
                 }
             }
+            if (nCopy == 0) {
+                eom = ASYN_EOM_CNT;
+                break;
+            }
+            if (nCopy > nAvail) nCopy = nAvail;
+            if (peosPvt->eosInLen > 0)
+                peos = findEos(peosPvt, pin, nCopy);
+            if (peos) {
+                size_t n = peos - pin;
+                memcpy(&data[nRead], pin, n);
+                nRead += n;
+                peosPvt->inBufTail += (unsigned int)(n + peosPvt->eosInLen);
+                eom |= ASYN_EOM_EOS;
+                break;
+            }
+            memcpy(&data[nRead], pin, nCopy);
+            nRead += nCopy;
+            peosPvt->inBufTail += (unsigned int)nCopy;
             if (nRead >= maxchars)  {
                 eom = ASYN_EOM_CNT;
                 break;
@@ -247,7 +281,7 @@ static asynStatus readIt(void *ppvt,asynUser *pasynUser,
         peosPvt->inBufTail = 0;
         peosPvt->inBufHead = (int)thisRead;
     }
-    if(nRead<maxchars) *data = 0; /*null terminate string if room*/
+    if(nRead<maxchars) data[nRead] = 0; /*null terminate string if room*/
     if (eomReason) *eomReason = eom;
     *nbytesTransfered = nRead;
     return status;
@@ -0,0 +1,462 @@
+/*asynInterposeWriteCombine.c*/
+/***********************************************************************
+* Copyright (c) 2002 The University of Chicago, as Operator of Argonne
+* National Laboratory, and the Regents of the University of
+* California, as Operator of Los Alamos National Laboratory, and
+* Berliner Elektronenspeicherring-Gesellschaft m.b.H. (BESSY).
+* asynDriver is distributed subject to a Software License Agreement
+* found in file LICENSE that is included with this distribution.
+***********************************************************************/
+
+/*
+ * Interpose that gathers consecutive asynOctet writes into one buffer and
+ * passes them to the driver as a single write.  The buffer is written when
+ * it is full, by a request queued with the first buffered write, and before
+ * every read or flush, so ordering is unchanged.  Writes are combined while
+ * that request waits in the queue; with a combining window it is queued
+ * only after the window has expired.
+ *
+ * An error writing the buffer from the queued request is kept and returned
+ * by the next write or flush, as the writers of the lost bytes have already
+ * been told success.
+ *
+ * The output EOS is taken over from the layers below, so that each write
+ * still gets its own terminator.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cantProceed.h>
+#include <epicsStdio.h>
+#include <epicsString.h>
+#include <epicsThread.h>
+#include <epicsTimer.h>
+#include <iocsh.h>
+
+#include <epicsExport.h>
+#include "asynDriver.h"
+#include "asynOctet.h"
+#include "asynOption.h"
+#include "asynInterposeWriteCombine.h"
+
+#define DEFAULT_BUFFER_SIZE 1400    /* One ethernet frame of TCP payload */
+
+typedef struct interposePvt {
+    char          *portName;
+    int           addr;
+    asynInterface octet;
+    asynOctet     *pasynOctetDrv;
+    void          *octetPvt;
+    asynInterface option;
+    asynOption    *pasynOptionDrv;
+    void          *optionPvt;
+    asynUser      *pflushUser;  /* Queued to write the buffer */
+    epicsTimerId  timer;
+    double        window;       /* 0 queues pflushUser without a delay */
+    size_t        bufferSize;
+    size_t        allocSize;
+    size_t        nBuffered;
+    char          *buffer;
+    double        timeout;      /* of the last buffered write */
+    asynStatus    flushStatus;  /* of pflushUser, until reported */
+    char          flushError[128];
+    char          eosOut[2];
+    int           eosOutLen;
+    unsigned long writes;
+    unsigned long driverWrites;
+}interposePvt;
+
+static epicsTimerQueueId timerQueue;
+
+/* Passes the buffered bytes to the driver. Called with the port locked. */
+static asynStatus writeBuffer(interposePvt *pvt, asynUser *pasynUser)
+{
+    asynStatus status = asynSuccess;
+    double     timeout = pasynUser->timeout;
+    size_t     written = 0;
+    size_t     n;
+
+    if (pvt->nBuffered == 0) return asynSuccess;
+    epicsTimerCancel(pvt->timer);
+    pasynUser->timeout = pvt->timeout;
+    while (written < pvt->nBuffered) {
+        status = pvt->pasynOctetDrv->write(pvt->octetPvt, pasynUser,
+            pvt->buffer + written, pvt->nBuffered - written, &n);
+        if (status != asynSuccess) break;
+        written += n;
+    }
+    pasynUser->timeout = timeout;
+    pvt->driverWrites++;
+    if (status != asynSuccess) {
+        /* Writers of the lost bytes have already been told success */
+        asynPrint(pasynUser, ASYN_TRACE_ERROR,
+            "%s asynInterposeWriteCombine discarding %lu of %lu buffered bytes: %s\n",
+            pvt->portName, (unsigned long)(pvt->nBuffered - written),
+            (unsigned long)pvt->nBuffered, pasynUser->errorMessage);
+    }
+    pvt->nBuffered = 0;
+    return status;
+}
+
+static void flushCallback(asynUser *pasynUser)
+{
+    interposePvt *pvt = (interposePvt *)pasynUser->userPvt;
+    asynStatus status;
+
+    status = writeBuffer(pvt, pasynUser);
+    if (status != asynSuccess && pvt->flushStatus == asynSuccess) {
+        pvt->flushStatus = status;
+        epicsSnprintf(pvt->flushError, sizeof(pvt->flushError), "%s",
+            pasynUser->errorMessage);
+    }
+}
+
+/* Returns, and forgets, an error of the last queued flush */
+static asynStatus flushError(interposePvt *pvt, asynUser *pasynUser)
+{
+    asynStatus status = pvt->flushStatus;
+
+    if (status == asynSuccess) return asynSuccess;
+    epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+        "%s buffered write failed: %s", pvt->portName, pvt->flushError);
+    pvt->flushStatus = asynSuccess;
+    return status;
+}
+
+static void queueFlush(interposePvt *pvt, asynQueuePriority priority)
+{
+    /* Fails harmlessly if a flush is already queued */
+    pasynManager->queueRequest(pvt->pflushUser, priority, 0.0);
+}
+
+static void timerCallback(void *ppvt)
+{
+    queueFlush((interposePvt *)ppvt, asynQueuePriorityHigh);
+}
+
+/* asynOctet methods */
+static asynStatus writeIt(void *ppvt, asynUser *pasynUser,
+    const char *data, size_t numchars, size_t *nbytesTransfered)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+    size_t     needed = numchars + pvt->eosOutLen;
+    int        first = (pvt->nBuffered == 0);
+    asynStatus status;
+
+    *nbytesTransfered = 0;
+    status = flushError(pvt, pasynUser);
+    if (status != asynSuccess) return status;
+    if (pvt->nBuffered + needed > pvt->bufferSize) {
+        status = writeBuffer(pvt, pasynUser);
+        if (status != asynSuccess) return status;
+        first = 1;
+    }
+    if (needed > pvt->allocSize) {
+        /* Larger than the buffer; it still goes to the driver as one write */
+        free(pvt->buffer);
+        pvt->allocSize = needed;
+        pvt->buffer = mallocMustSucceed(pvt->allocSize, "asynInterposeWriteCombine");
+    }
+    memcpy(pvt->buffer + pvt->nBuffered, data, numchars);
+    memcpy(pvt->buffer + pvt->nBuffered + numchars, pvt->eosOut, pvt->eosOutLen);
+    pvt->nBuffered += needed;
+    pvt->timeout = pasynUser->timeout;
+    pvt->writes++;
+    asynPrintIO(pasynUser, ASYN_TRACEIO_FILTER, data, numchars,
+        "%s asynInterposeWriteCombine buffered %lu\n",
+        pvt->portName, (unsigned long)numchars);
+    if (pvt->nBuffered >= pvt->bufferSize) {
+        status = writeBuffer(pvt, pasynUser);
+        if (status != asynSuccess) return status;
+    } else if (first) {
+        if (pvt->window > 0)
+            epicsTimerStartDelay(pvt->timer, pvt->window);
+        else
+            /* writes queued ahead of the flush are combined with this one */
+            queueFlush(pvt, asynQueuePriorityLow);
+    }
+    *nbytesTransfered = numchars;
+    return asynSuccess;
+}
+
+static asynStatus readIt(void *ppvt, asynUser *pasynUser,
+    char *data, size_t maxchars, size_t *nbytesTransfered, int *eomReason)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+    asynStatus status;
+
+    status = writeBuffer(pvt, pasynUser);
+    if (status != asynSuccess) {
+        *nbytesTransfered = 0;
+        return status;
+    }
+    return pvt->pasynOctetDrv->read(pvt->octetPvt,
+        pasynUser, data, maxchars, nbytesTransfered, eomReason);
+}
+
+static asynStatus flushIt(void *ppvt, asynUser *pasynUser)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+    asynStatus status, writeStatus, flushStatus;
+
+    /* Flush discards input, but pending output must still go out first */
+    status = flushError(pvt, pasynUser);
+    writeStatus = writeBuffer(pvt, pasynUser);
+    flushStatus = pvt->pasynOctetDrv->flush(pvt->octetPvt, pasynUser);
+    if (status == asynSuccess) status = writeStatus;
+    if (status == asynSuccess) status = flushStatus;
+    return status;
+}
+
+static asynStatus registerInterruptUser(void *ppvt, asynUser *pasynUser,
+    interruptCallbackOctet callback, void *userPvt, void **registrarPvt)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+
+    return pvt->pasynOctetDrv->registerInterruptUser(
+        pvt->octetPvt,
+        pasynUser, callback, userPvt, registrarPvt);
+}
+
+static asynStatus cancelInterruptUser(void *drvPvt, asynUser *pasynUser,
+    void *registrarPvt)
+{
+    interposePvt *pvt = (interposePvt *)drvPvt;
+
+    return pvt->pasynOctetDrv->cancelInterruptUser(
+        pvt->octetPvt, pasynUser, registrarPvt);
+}
+
+static asynStatus setInputEos(void *ppvt, asynUser *pasynUser,
+    const char *eos, int eoslen)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+
+    return pvt->pasynOctetDrv->setInputEos(pvt->octetPvt,
+        pasynUser, eos, eoslen);
+}
+
+static asynStatus getInputEos(void *ppvt, asynUser *pasynUser,
+    char *eos, int eossize, int *eoslen)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+
+    return pvt->pasynOctetDrv->getInputEos(pvt->octetPvt,
+        pasynUser, eos, eossize, eoslen);
+}
+
+static asynStatus setOutputEos(void *ppvt, asynUser *pasynUser,
+    const char *eos, int eoslen)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+
+    if (eoslen < 0 || eoslen > (int)sizeof(pvt->eosOut)) {
+        epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+            "%s setOutputEos illegal eoslen %d", pvt->portName, eoslen);
+        return asynError;
+    }
+    if (eoslen > 0) memcpy(pvt->eosOut, eos, eoslen);
+    pvt->eosOutLen = eoslen;
+    return asynSuccess;
+}
+
+static asynStatus getOutputEos(void *ppvt, asynUser *pasynUser,
+    char *eos, int eossize, int *eoslen)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+
+    if (eossize < pvt->eosOutLen) {
+        *eoslen = 0;
+        return asynOverflow;
+    }
+    memcpy(eos, pvt->eosOut, pvt->eosOutLen);
+    if (eossize > pvt->eosOutLen) eos[pvt->eosOutLen] = 0;
+    *eoslen = pvt->eosOutLen;
+    return asynSuccess;
+}
+
+static asynOctet octet = {
+    writeIt, readIt, flushIt,
+    registerInterruptUser, cancelInterruptUser,
+    setInputEos, getInputEos, setOutputEos, getOutputEos
+};
+
+/* asynOption methods */
+
+static asynStatus
+getOption(void *ppvt, asynUser *pasynUser,
+                              const char *key, char *val, int valSize)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+    if (epicsStrCaseCmp(key, "combineWindow") == 0) {
+        epicsSnprintf(val, valSize, "%g", pvt->window);
+        return asynSuccess;
+    }
+    if (epicsStrCaseCmp(key, "combineSize") == 0) {
+        epicsSnprintf(val, valSize, "%lu", (unsigned long)pvt->bufferSize);
+        return asynSuccess;
+    }
+    if (epicsStrCaseCmp(key, "combineStats") == 0) {
+        epicsSnprintf(val, valSize, "%lu %lu", pvt->writes, pvt->driverWrites);
+        return asynSuccess;
+    }
+    if (pvt->pasynOptionDrv)
+        return pvt->pasynOptionDrv->getOption(pvt->optionPvt,
+            pasynUser, key, val, valSize);
+    epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+        "Unknown option \"%s\"", key);
+    return asynError;
+}
+static asynStatus
+setOption(void *ppvt, asynUser *pasynUser, const char *key, const char *val)
+{
+    interposePvt *pvt = (interposePvt *)ppvt;
+    if (epicsStrCaseCmp(key, "combineWindow") == 0) {
+        double window;
+        if ((sscanf(val, "%lf", &window) != 1) || (window < 0)) {
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                "Bad number %s", val);
+            return asynError;
+        }
+        pvt->window = window;
+        return asynSuccess;
+    }
+    if (epicsStrCaseCmp(key, "combineSize") == 0) {
+        unsigned long size;
+        if ((sscanf(val, "%lu", &size) != 1) || (size == 0)) {
+            epicsSnprintf(pasynUser->errorMessage, pasynUser->errorMessageSize,
+                "Bad number %s", val);
+            return asynError;
+        }
+        writeBuffer(pvt, pasynUser);
+        if (size > pvt->allocSize) {
+            free(pvt->buffer);
+            pvt->allocSize = size;
+            pvt->buffer = mallocMustSucceed(pvt->allocSize, "asynInterposeWriteCombine");
+        }
+        pvt->bufferSize = size;
+        return asynSuccess;
+    }
+    if (epicsStrCaseCmp(key, "combineStats") == 0) {
+        pvt->writes = pvt->driverWrites = 0;
+        return asynSuccess;
+    }
+    if (pvt->pasynOptionDrv)
+        return pvt->pasynOptionDrv->setOption(pvt->optionPvt,
+            pasynUser, key, val);
+    epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
+        "Unknown option \"%s\"", key);
+    return asynError;
+}
+
+static asynOption option = {
+    setOption, getOption
+};
+
+
+epicsShareFunc int
+asynInterposeWriteCombine(const char *portName, int addr,
+    int bufferSize, double window)
+{
+    interposePvt *pvt;
+    asynStatus status;
+    asynInterface *poctetasynInterface;
+    asynInterface *poptionasynInterface;
+    asynUser *pasynUser;
+    char eos[2];
+    int eosLen;
+
+    if (bufferSize <= 0) bufferSize = DEFAULT_BUFFER_SIZE;
+    if (window < 0) window = 0;
+    pvt = callocMustSucceed(1, sizeof(interposePvt), "asynInterposeWriteCombine");
+    pvt->portName = epicsStrDup(portName);
+    pvt->addr = addr;
+    pvt->bufferSize = pvt->allocSize = bufferSize;
+    pvt->buffer = mallocMustSucceed(pvt->allocSize, "asynInterposeWriteCombine");
+    pvt->window = window;
+    pvt->timeout = 1.0;
+
+    pasynUser = pasynManager->createAsynUser(flushCallback, 0);
+    pasynUser->userPvt = pvt;
+    status = pasynManager->connectDevice(pasynUser, portName, addr);
+    if (status != asynSuccess) {
+        printf("%s connectDevice failed\n", portName);
+        pasynManager->freeAsynUser(pasynUser);
+        free(pvt->buffer);
+        free(pvt);
+        return -1;
+    }
+    pvt->pflushUser = pasynUser;
+
+    pvt->octet.interfaceType = asynOctetType;
+    pvt->octet.pinterface = &octet;
+    pvt->octet.drvPvt = pvt;
+    status = pasynManager->interposeInterface(portName, addr,
+        &pvt->octet, &poctetasynInterface);
+    if ((status!=asynSuccess) || !poctetasynInterface) {
+        printf("%s interposeInterface asynOctetType failed.\n", portName);
+        pasynManager->freeAsynUser(pasynUser);
+        free(pvt->buffer);
+        free(pvt);
+        return -1;
+    }
+    pvt->pasynOctetDrv = (asynOctet *)poctetasynInterface->pinterface;
+    pvt->octetPvt = poctetasynInterface->drvPvt;
+
+    /* Take over the output EOS so that it is appended to each buffered write */
+    if (pvt->pasynOctetDrv->getOutputEos(pvt->octetPvt, pasynUser,
+            eos, sizeof(eos), &eosLen) == asynSuccess && eosLen > 0) {
+        memcpy(pvt->eosOut, eos, eosLen);
+        pvt->eosOutLen = eosLen;
+        pvt->pasynOctetDrv->setOutputEos(pvt->octetPvt, pasynUser, "", 0);
+    }
+
+    pvt->option.interfaceType = asynOptionType;
+    pvt->option.pinterface = &option;
+    pvt->option.drvPvt = pvt;
+    status = pasynManager->interposeInterface(portName, addr,
+        &pvt->option, &poptionasynInterface);
+    if ((status!=asynSuccess) || !poptionasynInterface) {
+        status = pasynManager->registerInterface(portName,&pvt->option);
+        if(status != asynSuccess) {
+            printf("asynInterposeWriteCombine: Can't interpose or register option.\n");
+        }
+    } else {
+        pvt->pasynOptionDrv = (asynOption *)poptionasynInterface->pinterface;
+    }
+
+    if (!timerQueue) {
+        timerQueue = epicsTimerQueueAllocate(1, epicsThreadPriorityScanHigh);
+    }
+    pvt->timer = epicsTimerQueueCreateTimer(timerQueue, timerCallback, pvt);
+    return 0;
+}
+
+/* register asynInterposeWriteCombine*/
+static const iocshArg iocshArg0 = {"portName", iocshArgString};
+static const iocshArg iocshArg1 = {"addr", iocshArgInt};
+static const iocshArg iocshArg2 = {"bufferSize", iocshArgInt};
+static const iocshArg iocshArg3 = {"window(sec)", iocshArgDouble};
+static const iocshArg *iocshArgs[] =
+    {&iocshArg0, &iocshArg1, &iocshArg2, &iocshArg3};
+
+static const iocshFuncDef asynInterposeWriteCombineFuncDef =
+    {"asynInterposeWriteCombine", 4, iocshArgs};
+
+static void asynInterposeWriteCombineCallFunc(const iocshArgBuf *args)
+{
+    asynInterposeWriteCombine(args[0].sval, args[1].ival,
+        args[2].ival, args[3].dval);
+}
+
+static void asynInterposeWriteCombineRegister(void)
+{
+    static int firstTime = 1;
+    if (firstTime) {
+        firstTime = 0;
+        iocshRegister(&asynInterposeWriteCombineFuncDef, asynInterposeWriteCombineCallFunc);
+    }
+}
+epicsExportRegistrar(asynInterposeWriteCombineRegister);
@@ -595,6 +595,57 @@ static void asynReportCall(const iocshArgBuf * args) {
     asynReport(args[0].ival,args[1].sval);
 }
 
+static const iocshArg asynStatisticsReportArg0 = {"level", iocshArgInt};
+static const iocshArg asynStatisticsReportArg1 = {"port", iocshArgString};
+static const iocshArg *const asynStatisticsReportArgs[] = {
+    &asynStatisticsReportArg0,&asynStatisticsReportArg1};
+static const iocshFuncDef asynStatisticsReportDef =
+    {"asynStatisticsReport", 2, asynStatisticsReportArgs};
+epicsShareFunc int
+ asynStatisticsReport(int level, const char *portName)
+{
+    pasynManager->reportStatistics(stdout,level,portName);
+    return 0;
+}
+static void asynStatisticsReportCall(const iocshArgBuf * args) {
+    asynStatisticsReport(args[0].ival,args[1].sval);
+}
+
+static const iocshArg asynStatisticsResetArg0 = {"portName", iocshArgString};
+static const iocshArg *const asynStatisticsResetArgs[] = {
+    &asynStatisticsResetArg0};
+static const iocshFuncDef asynStatisticsResetDef =
+    {"asynStatisticsReset", 1, asynStatisticsResetArgs};
+epicsShareFunc int
+ asynStatisticsReset(const char *portName)
+{
+    asynUser *pasynUser;
+    asynStatus status;
+
+    if (!portName || !*portName) {
+        printf("Usage: asynStatisticsReset portName\n");
+        return -1;
+    }
+    pasynUser = pasynManager->createAsynUser(0,0);
+    status = pasynManager->connectDevice(pasynUser,portName,-1);
+    if(status!=asynSuccess) {
+        printf("%s\n",pasynUser->errorMessage);
+        pasynManager->freeAsynUser(pasynUser);
+        return -1;
+    }
+    status = pasynManager->resetPortStatistics(pasynUser);
+    if(status!=asynSuccess) {
+        printf("%s\n",pasynUser->errorMessage);
+        pasynManager->freeAsynUser(pasynUser);
+        return -1;
+    }
+    pasynManager->freeAsynUser(pasynUser);
+    return 0;
+}
+static void asynStatisticsResetCall(const iocshArgBuf * args) {
+    asynStatisticsReset(args[0].sval);
+}
+
 static const iocshArg asynSetOptionArg0 = {"portName", iocshArgString};
 static const iocshArg asynSetOptionArg1 = {"addr", iocshArgInt};
 static const iocshArg asynSetOptionArg2 = {"key", iocshArgString};
@@ -735,6 +786,7 @@ static int asynTraceIOMaskStringToInt(const char* maskStr) {
             else if (STARTSWITH(maskStr, ASCII)) mask |= ASYN_TRACEIO_ASCII;
             else if (STARTSWITH(maskStr, ESCAPE)) mask |= ASYN_TRACEIO_ESCAPE;
             else if (STARTSWITH(maskStr, HEX)) mask |= ASYN_TRACEIO_HEX;
+            else if (STARTSWITH(maskStr, BINARY)) mask |= ASYN_TRACEIO_BINARY;
             else break;
             while (isspace((unsigned char)*maskStr)) maskStr++;
         }
@@ -903,6 +955,55 @@ static void asynSetTraceIOTruncateSizeCall(const iocshArgBuf * args) {
     asynSetTraceIOTruncateSize(portName,addr,size);
 }
 
+static const iocshArg asynTraceBufferDumpArg0 = {"portName", iocshArgString};
+static const iocshArg asynTraceBufferDumpArg1 = {"maxRecords", iocshArgInt};
+static const iocshArg asynTraceBufferDumpArg2 = {"filename", iocshArgString};
+static const iocshArg *const asynTraceBufferDumpArgs[] = {
+    &asynTraceBufferDumpArg0,&asynTraceBufferDumpArg1,&asynTraceBufferDumpArg2};
+static const iocshFuncDef asynTraceBufferDumpDef =
+    {"asynTraceBufferDump", 3, asynTraceBufferDumpArgs};
+epicsShareFunc int
+ asynTraceBufferDump(const char *portName,int maxRecords,const char *filename)
+{
+    asynUser   *pasynUser;
+    asynStatus status;
+    FILE       *fp = stdout;
+
+    if(!portName || strlen(portName)==0) {
+        printf("Usage: asynTraceBufferDump portName [maxRecords] [filename]\n");
+        return -1;
+    }
+    pasynUser = pasynManager->createAsynUser(0,0);
+    status = pasynManager->connectDevice(pasynUser,portName,-1);
+    if(status!=asynSuccess) {
+        printf("%s\n",pasynUser->errorMessage);
+        pasynManager->freeAsynUser(pasynUser);
+        return -1;
+    }
+    if(filename && strlen(filename)>0 && strcmp(filename,"stdout")!=0) {
+        if(strcmp(filename,"stderr")==0) {
+            fp = stderr;
+        } else {
+            fp = fopen(filename,"w");
+            if(!fp) {
+                printf("fopen failed %s\n",strerror(errno));
+                pasynManager->freeAsynUser(pasynUser);
+                return -1;
+            }
+        }
+    }
+    status = pasynTrace->dumpTraceBuffer(pasynUser,fp,maxRecords<0 ? 0 : maxRecords);
+    if(status!=asynSuccess) {
+        printf("%s\n",pasynUser->errorMessage);
+    }
+    if(fp!=stdout && fp!=stderr) fclose(fp);
+    pasynManager->freeAsynUser(pasynUser);
+    return status==asynSuccess ? 0 : -1;
+}
+static void asynTraceBufferDumpCall(const iocshArgBuf * args) {
+    asynTraceBufferDump(args[0].sval,args[1].ival,args[2].sval);
+}
+
 static const iocshArg asynEnableArg0 = {"portName", iocshArgString};
 static const iocshArg asynEnableArg1 = {"addr", iocshArgInt};
 static const iocshArg asynEnableArg2 = {"yesNo", iocshArgInt};
@@ -1276,6 +1377,8 @@ static void asynRegister(void)
     if(!firstTime) return;
     firstTime = 0;
     iocshRegister(&asynReportDef,asynReportCall);
+    iocshRegister(&asynStatisticsReportDef,asynStatisticsReportCall);
+    iocshRegister(&asynStatisticsResetDef,asynStatisticsResetCall);
     iocshRegister(&asynSetOptionDef,asynSetOptionCall);
     iocshRegister(&asynShowOptionDef,asynShowOptionCall);
     iocshRegister(&asynSetTraceMaskDef,asynSetTraceMaskCall);
@@ -1283,6 +1386,7 @@ static void asynRegister(void)
     iocshRegister(&asynSetTraceInfoMaskDef,asynSetTraceInfoMaskCall);
     iocshRegister(&asynSetTraceFileDef,asynSetTraceFileCall);
     iocshRegister(&asynSetTraceIOTruncateSizeDef,asynSetTraceIOTruncateSizeCall);
+    iocshRegister(&asynTraceBufferDumpDef,asynTraceBufferDumpCall);
     iocshRegister(&asynEnableDef,asynEnableCall);
     iocshRegister(&asynAutoConnectDef,asynAutoConnectCall);
     iocshRegister(&asynSetQueueLockPortTimeoutDef,asynSetQueueLockPortTimeoutCall);
@@ -23,6 +23,10 @@ epicsShareFunc int
  asynShowOption(const char *portName, int addr,const char *key);
 epicsShareFunc int
  asynReport(int level, const char *portName);
+epicsShareFunc int
+ asynStatisticsReport(int level, const char *portName);
+epicsShareFunc int
+ asynStatisticsReset(const char *portName);
 epicsShareFunc int
  asynSetTraceMask(const char *portName,int addr,int mask);
 epicsShareFunc int
@@ -33,6 +37,8 @@ epicsShareFunc int
  asynSetTraceFile(const char *portName,int addr,const char *filename);
 epicsShareFunc int
  asynSetTraceIOTruncateSize(const char *portName,int addr,int size);
+epicsShareFunc int
+ asynTraceBufferDump(const char *portName,int maxRecords,const char *filename);
 epicsShareFunc int
  asynAutoConnect(const char *portName,int addr,int yesNo);
 epicsShareFunc int
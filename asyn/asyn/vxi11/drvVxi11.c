@@ -114,8 +114,20 @@ typedef struct vxiPort {
     epicsInterruptibleSyscallContext *srqInterrupt;
     int           srqEnabled;
     vxiConnectStatus previousConnectStatus;
+    unsigned long readCalls;   /* vxiRead calls */
+    unsigned long readRpcs;    /* device_read RPCs */
+    unsigned long readBytes;   /* bytes returned by device_read */
 }vxiPort;
 
+/*
+ * device_read results are decoded directly into the caller's buffer.
+ * maxBytes bounds the data a misbehaving server can return.
+ */
+typedef struct readResp {
+    Device_ReadResp resp;
+    u_int           maxBytes;
+}readResp;
+
 /* Local routines */
 static char *vxiError(Device_ErrorCode error);
 static unsigned long getIoTimeout(asynUser *pasynUser,vxiPort *ppvxiPort);
@@ -134,6 +146,7 @@ static enum clnt_stat clientCall(vxiPort * pvxiPort,
     u_long req,xdrproc_t proc1, caddr_t addr1,xdrproc_t proc2, caddr_t addr2);
 static enum clnt_stat clientIoCall(vxiPort * pvxiPort,asynUser *pasynUser,
     u_long req,xdrproc_t proc1, caddr_t addr1,xdrproc_t proc2, caddr_t addr2);
+static bool_t xdrReadResp(XDR *xdrs,readResp *preadResp);
 static asynStatus vxiBusStatus(vxiPort * pvxiPort, int request,
     double timeout,int *status);
 static void vxiCreateIrqChannel(vxiPort *pvxiPort,asynUser *pasynUser);
@@ -543,6 +556,20 @@ static asynStatus vxiBusStatus(vxiPort * pvxiPort, int request,
     return asynSuccess;
 }
 
+static bool_t xdrReadResp(XDR *xdrs,readResp *preadResp)
+{
+    Device_ReadResp *objp = &preadResp->resp;
+    long            reason; /* rpcgen declares reason as int or long */
+
+    /* data_val belongs to the caller so there is nothing to free */
+    if(xdrs->x_op==XDR_FREE) return TRUE;
+    if(!xdr_Device_ErrorCode(xdrs,&objp->error)) return FALSE;
+    if(!xdr_long(xdrs,&reason)) return FALSE;
+    objp->reason = reason;
+    return xdr_bytes(xdrs,(char **)&objp->data.data_val,
+        (u_int *)&objp->data.data_len,preadResp->maxBytes);
+}
+
 static enum clnt_stat clientCall(vxiPort * pvxiPort,
     u_long req,xdrproc_t proc1, caddr_t addr1,xdrproc_t proc2, caddr_t addr2)
 {
@@ -1055,6 +1082,8 @@ static void vxiReport(void *drvPvt,FILE *fd,int details)
         fprintf(fd," isSingleLink:%s isGpibLink:%s\n",
             ((pvxiPort->isSingleLink) ? "yes" : "no"),
             ((pvxiPort->isGpibLink) ? "yes" : "no"));
+        fprintf(fd,"    reads:%lu device_read RPCs:%lu bytes:%lu\n",
+            pvxiPort->readCalls,pvxiPort->readRpcs,pvxiPort->readBytes);
     }
 }
 
@@ -1138,7 +1167,7 @@ static asynStatus vxiRead(void *drvPvt,asynUser *pasynUser,
     devLink *pdevLink;
     enum clnt_stat   clntStat;
     Device_ReadParms devReadP;
-    Device_ReadResp  devReadR;
+    readResp         devReadR;
     asynStatus       status = asynSuccess;
 
     status = pasynManager->getAddr(pasynUser,&addr);
@@ -1156,6 +1185,7 @@ static asynStatus vxiRead(void *drvPvt,asynUser *pasynUser,
         return asynError;
     }
     devReadP.lid = pdevLink->lid;
+    pvxiPort->readCalls++;
     /* device link is created; do the read */
     do {
         thisRead = -1;
@@ -1167,47 +1197,51 @@ static asynStatus vxiRead(void *drvPvt,asynUser *pasynUser,
             devReadP.flags |= VXI_TERMCHRSET;
             devReadP.termChar = pdevLink->eos;
         }
-        /* initialize devReadR */
-        memset((char *) &devReadR, 0, sizeof(Device_ReadResp));
         /* RPC call */
         while(TRUE) { /*Allow for very long or infinite timeout*/
+            /* initialize devReadR to decode into the caller's buffer */
+            memset((char *) &devReadR, 0, sizeof(devReadR));
+            devReadR.resp.data.data_val = data;
+            devReadR.maxBytes = maxchars;
             clntStat = clientIoCall(pvxiPort, pasynUser, device_read,
                 (const xdrproc_t) xdr_Device_ReadParms,(void *) &devReadP,
-                (const xdrproc_t) xdr_Device_ReadResp,(void *) &devReadR);
+                (const xdrproc_t) xdrReadResp,(void *) &devReadR);
+            pvxiPort->readRpcs++;
             if(devReadP.io_timeout!=UINT_MAX
-            || devReadR.error!=VXI_IOTIMEOUT
-            || devReadR.data.data_len>0) break;
+            || devReadR.resp.error!=VXI_IOTIMEOUT
+            || devReadR.resp.data.data_len>0) break;
         }
         if(clntStat != RPC_SUCCESS) {
             epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
                 "%s RPC failed",pvxiPort->portName);
             status = asynError;
             break;
-        } else if(devReadR.error != VXI_OK) {
-            if((devReadR.error == VXI_IOTIMEOUT) && (pvxiPort->recoverWithIFC))
+        } else if(devReadR.resp.error != VXI_OK) {
+            if((devReadR.resp.error == VXI_IOTIMEOUT)
+            && (pvxiPort->recoverWithIFC))
                 vxiIfc(drvPvt, pasynUser);
             epicsSnprintf(pasynUser->errorMessage,pasynUser->errorMessageSize,
                 "%s read request failed",pvxiPort->portName);
-            status = (devReadR.error==VXI_IOTIMEOUT) ? asynTimeout : asynError;
+            status = (devReadR.resp.error==VXI_IOTIMEOUT)
+                ? asynTimeout : asynError;
             break;
         }
-        thisRead = devReadR.data.data_len;
+        thisRead = devReadR.resp.data.data_len;
         if(thisRead>0) {
             asynPrintIO(pasynUser,ASYN_TRACEIO_DRIVER,
-                devReadR.data.data_val,devReadR.data.data_len,
+                data,thisRead,
                 "%s %d vxiRead\n",pvxiPort->portName,addr);
-            memcpy(data, devReadR.data.data_val, thisRead);
+            pvxiPort->readBytes += thisRead;
             nRead += thisRead;
             data += thisRead;
             maxchars -= thisRead;
         }
-        xdr_free((const xdrproc_t) xdr_Device_ReadResp, (char *) &devReadR);
-    } while(!devReadR.reason && thisRead>0);
+    } while(!devReadR.resp.reason && thisRead>0 && maxchars>0);
     if(eomReason) {
         *eomReason = 0;
-        if(devReadR.reason & VXI_REQCNT) *eomReason |= ASYN_EOM_CNT;
-        if(devReadR.reason & VXI_CHR) *eomReason |= ASYN_EOM_EOS;
-        if(devReadR.reason & VXI_ENDR) *eomReason |= ASYN_EOM_END;
+        if(devReadR.resp.reason & VXI_REQCNT) *eomReason |= ASYN_EOM_CNT;
+        if(devReadR.resp.reason & VXI_CHR) *eomReason |= ASYN_EOM_EOS;
+        if(devReadR.resp.reason & VXI_ENDR) *eomReason |= ASYN_EOM_END;
     }
     *nbytesTransfered = nRead;
     return status;
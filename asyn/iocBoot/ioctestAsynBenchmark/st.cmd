@@ -0,0 +1,22 @@
+dbLoadDatabase("../../dbd/testAsynBenchmark.dbd")
+testAsynBenchmark_registerRecordDeviceDriver(pdbbase)
+
+# Arguments: portName, numChannels, maxArrayLength
+testAsynBenchmarkConfigure("BENCH", 4, 10000)
+
+# One set of records per address. FIFO is the asyn:FIFO ring buffer size of the I/O Intr records.
+dbLoadRecords("../../db/testAsynBenchmark.db","P=testAsynBenchmark:,PORT=BENCH,ADDR=0,TIMEOUT=1,NELM=10000,FIFO=100")
+dbLoadRecords("../../db/testAsynBenchmark.db","P=testAsynBenchmark:,PORT=BENCH,ADDR=1,TIMEOUT=1,NELM=10000,FIFO=100")
+dbLoadRecords("../../db/testAsynBenchmark.db","P=testAsynBenchmark:,PORT=BENCH,ADDR=2,TIMEOUT=1,NELM=10000,FIFO=100")
+dbLoadRecords("../../db/testAsynBenchmark.db","P=testAsynBenchmark:,PORT=BENCH,ADDR=3,TIMEOUT=1,NELM=10000,FIFO=100")
+
+iocInit()
+
+# Arguments: portName, rate (rounds of callbacks per second, 0=as fast as possible),
+#            arrayLength (0=scalars only), duration (s), output file for JSON results
+testAsynBenchmarkRun("BENCH", 100,     0, 5, "testAsynBenchmark.json")
+testAsynBenchmarkRun("BENCH", 1000,    0, 5, "testAsynBenchmark.json")
+testAsynBenchmarkRun("BENCH", 10000,   0, 5, "testAsynBenchmark.json")
+testAsynBenchmarkRun("BENCH", 1000,  100, 5, "testAsynBenchmark.json")
+testAsynBenchmarkRun("BENCH", 100, 10000, 5, "testAsynBenchmark.json")
+testAsynBenchmarkRun("BENCH", 100000,  0, 5, "testAsynBenchmark.json")
@@ -0,0 +1,483 @@
+/*
+ * testAsynBenchmark.cpp
+ *
+ * Asyn driver that inherits from the asynPortDriver class to measure the throughput
+ * and latency of callbacks from a driver to I/O Intr records.
+ *
+ * A thread does callbacks on the asynFloat64 and asynFloat64Array interfaces of every
+ * address at a fixed rate, each stamped with the time it was issued.  The records that
+ * receive them (SCAN=I/O Intr, TSE=-2) forward link to sink records with the device
+ * support in this file, which compare the time stamp of the source record with the time
+ * it was processed.  The testAsynBenchmarkRun command runs one measurement and writes
+ * the result as a single line of JSON.
+ *
+ * Created October 19, 2026
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include <epicsTypes.h>
+#include <epicsTime.h>
+#include <epicsAtomic.h>
+#include <epicsStdio.h>
+#include <iocsh.h>
+#include <dbAccess.h>
+#include <dbLink.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <aiRecord.h>
+
+#include <asynPortDriver.h>
+
+#include <epicsExport.h>
+#include "testAsynBenchmark.h"
+
+static const char *driverName="testAsynBenchmark";
+
+/* Latencies are histogrammed from 100 ns to 10 s with 20 bins per decade */
+#define LATENCY_MIN_DECADE      (-7)
+#define LATENCY_BINS_PER_DECADE 20
+#define LATENCY_BINS            (8*LATENCY_BINS_PER_DECADE)
+#define DRAIN_QUIET_TIME        0.2
+#define DRAIN_MAX_TIME          10.
+
+typedef enum {
+    sinkScalar,
+    sinkArray,
+    numSinks
+} sinkType;
+
+static const char *sinkNames[numSinks] = {"scalar", "array"};
+
+/* Updated by the sink records in the callback threads, so only with atomics */
+typedef struct {
+    size_t count;
+    size_t maxNanoseconds;
+    size_t bins[LATENCY_BINS];
+} latencyHistogram;
+
+static latencyHistogram sinks[numSinks];
+
+static void sinkReset()
+{
+    int i, j;
+
+    for (i=0; i<numSinks; i++) {
+        epicsAtomicSetSizeT(&sinks[i].count, 0);
+        epicsAtomicSetSizeT(&sinks[i].maxNanoseconds, 0);
+        for (j=0; j<LATENCY_BINS; j++) epicsAtomicSetSizeT(&sinks[i].bins[j], 0);
+    }
+}
+
+static void sinkAdd(sinkType type, double latency)
+{
+    latencyHistogram *phist = &sinks[type];
+    size_t ns = (latency > 0) ? (size_t)(latency*1e9) : 0;
+    size_t max;
+    int bin = 0;
+
+    if (latency > 0) {
+        bin = (int)floor((log10(latency) - LATENCY_MIN_DECADE) * LATENCY_BINS_PER_DECADE);
+        if (bin < 0) bin = 0;
+        if (bin >= LATENCY_BINS) bin = LATENCY_BINS - 1;
+    }
+    epicsAtomicIncrSizeT(&phist->bins[bin]);
+    while ((max = epicsAtomicGetSizeT(&phist->maxNanoseconds)) < ns) {
+        if (epicsAtomicCmpAndSwapSizeT(&phist->maxNanoseconds, max, ns) == max) break;
+    }
+    epicsAtomicIncrSizeT(&phist->count);
+}
+
+/* Returns the upper edge of the bin that holds the given fraction of the samples, in microseconds */
+static double sinkPercentile(sinkType type, double fraction)
+{
+    latencyHistogram *phist = &sinks[type];
+    size_t total = epicsAtomicGetSizeT(&phist->count);
+    size_t target = (size_t)ceil(fraction * total);
+    double max = epicsAtomicGetSizeT(&phist->maxNanoseconds) / 1e3;
+    double edge;
+    size_t sum = 0;
+    int bin;
+
+    if (total == 0) return 0.;
+    for (bin=0; bin<LATENCY_BINS; bin++) {
+        sum += epicsAtomicGetSizeT(&phist->bins[bin]);
+        if (sum >= target) break;
+    }
+    edge = 1e6 * pow(10., LATENCY_MIN_DECADE + (double)(bin + 1)/LATENCY_BINS_PER_DECADE);
+    return (edge < max) ? edge : max;
+}
+
+static size_t sinkTotal()
+{
+    return epicsAtomicGetSizeT(&sinks[sinkScalar].count) +
+           epicsAtomicGetSizeT(&sinks[sinkArray].count);
+}
+
+static void updateThreadC(void *pPvt)
+{
+    testAsynBenchmark *p = (testAsynBenchmark*)pPvt;
+    p->updateThread();
+}
+
+/** Constructor for the testAsynBenchmark class.
+  * Calls constructor for the asynPortDriver base class.
+  * \param[in] portName The name of the asyn port driver to be created.
+  * \param[in] numChannels The number of addresses that get callbacks.
+  * \param[in] maxArrayLength The largest array length that can be selected. */
+testAsynBenchmark::testAsynBenchmark(const char *portName, int numChannels, int maxArrayLength)
+   : asynPortDriver(portName,
+                    numChannels, /* maxAddr */
+                     /* Interface mask */
+                    asynInt32Mask | asynFloat64Mask | asynFloat64ArrayMask | asynDrvUserMask,
+                    /* Interrupt mask */
+                    asynInt32Mask | asynFloat64Mask | asynFloat64ArrayMask,
+                    ASYN_MULTIDEVICE, /* asynFlags.  Does not block */
+                    1, /* Autoconnect */
+                    0, /* Default priority */
+                    0) /* Default stack size*/,
+     numChannels_(numChannels), maxArrayLength_(maxArrayLength), arrayLength_(0),
+     rate_(1000.), running_(0), ticks_(0)
+{
+    int i;
+
+    createParam(P_RunString,                 asynParamInt32,         &P_Run);
+    createParam(P_RateString,                asynParamFloat64,       &P_Rate);
+    createParam(P_ArrayLengthString,         asynParamInt32,         &P_ArrayLength);
+    createParam(P_UpdatesString,             asynParamInt32,         &P_Updates);
+    createParam(P_ScalarString,              asynParamFloat64,       &P_Scalar);
+    createParam(P_ArrayString,               asynParamFloat64Array,  &P_Array);
+
+    for (i=0; i<numChannels_; i++) {
+        setIntegerParam(i, P_Run, 0);
+        setDoubleParam(i, P_Rate, rate_);
+        setIntegerParam(i, P_ArrayLength, arrayLength_);
+        setIntegerParam(i, P_Updates, 0);
+        /* No tick writes -1, so every tick is a change that gets a callback */
+        setDoubleParam(i, P_Scalar, -1.);
+    }
+    array_ = (epicsFloat64 *)calloc(maxArrayLength_ > 0 ? maxArrayLength_ : 1, sizeof(epicsFloat64));
+
+    startEvent_ = epicsEventCreate(epicsEventEmpty);
+    stoppedEvent_ = epicsEventCreate(epicsEventEmpty);
+    epicsThreadCreate("testAsynBenchmark",
+        epicsThreadPriorityHigh,
+        epicsThreadGetStackSize(epicsThreadStackMedium),
+        (EPICSTHREADFUNC)updateThreadC, this);
+}
+
+/** Does one round of callbacks on every address per period until running_ is cleared */
+void testAsynBenchmark::updateThread()
+{
+    epicsTimeStamp next, now;
+    double delay;
+    int i;
+
+    lock();
+    while (1) {
+        unlock();
+        epicsEventMustWait(startEvent_);
+        lock();
+        epicsTimeGetCurrent(&next);
+        while (running_) {
+            updateTimeStamp();
+            for (i=0; i<numChannels_; i++) {
+                setDoubleParam(i, P_Scalar, (double)ticks_);
+                callParamCallbacks(i);
+                if (arrayLength_ > 0) {
+                    array_[0] = (double)ticks_;
+                    doCallbacksFloat64Array(array_, arrayLength_, P_Array, i);
+                }
+            }
+            ticks_++;
+            if (rate_ > 0) {
+                epicsTimeAddSeconds(&next, 1./rate_);
+                epicsTimeGetCurrent(&now);
+                delay = epicsTimeDiffInSeconds(&next, &now);
+                /* Do not try to catch up after falling more than a second behind */
+                if (delay < -1.) next = now;
+            } else {
+                delay = 0.;
+            }
+            unlock();
+            if (delay > 0) epicsThreadSleep(delay);
+            lock();
+        }
+        for (i=0; i<numChannels_; i++) {
+            setIntegerParam(i, P_Updates, ticks_);
+            callParamCallbacks(i);
+        }
+        epicsEventSignal(stoppedEvent_);
+    }
+}
+
+/** Called with the lock held */
+void testAsynBenchmark::start()
+{
+    int i;
+
+    if (running_) return;
+    ticks_ = 0;
+    for (i=0; i<numChannels_; i++) {
+        setDoubleParam(i, P_Scalar, -1.);
+    }
+    running_ = 1;
+    epicsEventSignal(startEvent_);
+}
+
+/** Called with the lock held */
+void testAsynBenchmark::stop()
+{
+    if (!running_) return;
+    running_ = 0;
+    unlock();
+    epicsEventMustWait(stoppedEvent_);
+    lock();
+}
+
+asynStatus testAsynBenchmark::writeInt32(asynUser *pasynUser, epicsInt32 value)
+{
+    int function = pasynUser->reason;
+    int addr;
+
+    getAddress(pasynUser, &addr);
+    if (function == P_ArrayLength) {
+        if (value < 0 || value > maxArrayLength_) return asynError;
+        arrayLength_ = value;
+    }
+    else if (function == P_Run) {
+        if (value) start(); else stop();
+    }
+    setIntegerParam(addr, function, value);
+    callParamCallbacks(addr);
+    return asynSuccess;
+}
+
+asynStatus testAsynBenchmark::writeFloat64(asynUser *pasynUser, epicsFloat64 value)
+{
+    int function = pasynUser->reason;
+    int addr;
+
+    getAddress(pasynUser, &addr);
+    if (function == P_Rate) {
+        rate_ = value;
+    }
+    setDoubleParam(addr, function, value);
+    callParamCallbacks(addr);
+    return asynSuccess;
+}
+
+/** Runs one measurement and reports it.
+  * \param[in] rate Rounds of callbacks per second on every address; 0 runs as fast as possible.
+  * \param[in] arrayLength Number of elements in the array callbacks; 0 does only scalar callbacks.
+  * \param[in] duration Seconds to generate callbacks for.
+  * \param[in] fileName If not empty the result is appended to this file as well as printed. */
+int testAsynBenchmark::run(double rate, int arrayLength, double duration, const char *fileName)
+{
+    static const char *functionName = "run";
+    epicsTimeStamp startTime, endTime, lastChange, now;
+    clock_t startCPU, endCPU;
+    size_t delivered, last, issued[numSinks];
+    double elapsed, cpu;
+    char result[1024];
+    int i, n, ticks;
+
+    if (arrayLength < 0 || arrayLength > maxArrayLength_) {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR,
+            "%s::%s arrayLength %d must be between 0 and %d\n",
+            driverName, functionName, arrayLength, maxArrayLength_);
+        return -1;
+    }
+    lock();
+    stop();
+    rate_ = rate;
+    arrayLength_ = arrayLength;
+    sinkReset();
+    startCPU = clock();
+    epicsTimeGetCurrent(&startTime);
+    start();
+    unlock();
+    epicsThreadSleep(duration);
+    lock();
+    stop();
+    ticks = ticks_;
+    unlock();
+    epicsTimeGetCurrent(&endTime);
+
+    /* Wait for the records to process everything that is still queued */
+    last = sinkTotal();
+    lastChange = endTime;
+    while (1) {
+        epicsThreadSleep(0.02);
+        epicsTimeGetCurrent(&now);
+        delivered = sinkTotal();
+        if (delivered != last) {
+            last = delivered;
+            lastChange = now;
+        }
+        if (epicsTimeDiffInSeconds(&now, &lastChange) > DRAIN_QUIET_TIME) break;
+        if (epicsTimeDiffInSeconds(&now, &endTime) > DRAIN_MAX_TIME) break;
+    }
+    endCPU = clock();
+
+    elapsed = epicsTimeDiffInSeconds(&endTime, &startTime);
+    cpu = (double)(endCPU - startCPU) / CLOCKS_PER_SEC;
+    issued[sinkScalar] = (size_t)ticks * numChannels_;
+    issued[sinkArray] = (arrayLength > 0) ? (size_t)ticks * numChannels_ : 0;
+    delivered = sinkTotal();
+
+    n = epicsSnprintf(result, sizeof(result),
+        "{\"port\":\"%s\",\"channels\":%d,\"rate\":%g,\"arrayLength\":%d,\"duration\":%.3f,"
+        "\"updates\":%d,\"callbacksPerSecond\":%.1f,\"cpuPercent\":%.1f,\"cpuMicrosecondsPerUpdate\":%.3f",
+        portName, numChannels_, rate, arrayLength, elapsed,
+        ticks, delivered / elapsed, 100. * cpu / elapsed,
+        delivered ? 1e6 * cpu / delivered : 0.);
+    for (i=0; i<numSinks; i++) {
+        size_t count = epicsAtomicGetSizeT(&sinks[i].count);
+        if (issued[i] == 0) continue;
+        n += epicsSnprintf(result + n, sizeof(result) - n,
+            ",\"%s\":{\"issued\":%lu,\"processed\":%lu,\"overflows\":%lu,"
+            "\"latencyMicroseconds\":{\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}}",
+            sinkNames[i], (unsigned long)issued[i], (unsigned long)count,
+            (unsigned long)(issued[i] > count ? issued[i] - count : 0),
+            sinkPercentile((sinkType)i, 0.5), sinkPercentile((sinkType)i, 0.9),
+            sinkPercentile((sinkType)i, 0.99), sinkPercentile((sinkType)i, 0.999),
+            epicsAtomicGetSizeT(&sinks[i].maxNanoseconds) / 1e3);
+    }
+    epicsSnprintf(result + n, sizeof(result) - n, "}");
+    printf("%s\n", result);
+    if (fileName && fileName[0]) {
+        FILE *fp = fopen(fileName, "a");
+        if (!fp) {
+            asynPrint(pasynUserSelf, ASYN_TRACE_ERROR,
+                "%s::%s cannot open %s\n", driverName, functionName, fileName);
+            return -1;
+        }
+        fprintf(fp, "%s\n", result);
+        fclose(fp);
+    }
+    return 0;
+}
+
+/* Device support for the sink records.  INP is a link to the record whose latency is measured */
+static long initSink(aiRecord *prec)
+{
+    if (prec->inp.type != DB_LINK && prec->inp.type != CA_LINK) {
+        recGblRecordError(S_db_badField, (void *)prec,
+            "asynBenchmarkSink: INP must be a link to the source record");
+        return S_db_badField;
+    }
+    return 0;
+}
+
+static long readSink(aiRecord *prec, sinkType type)
+{
+    epicsTimeStamp sent, now;
+    double latency;
+
+    epicsTimeGetCurrent(&now);
+    if (dbGetTimeStamp(&prec->inp, &sent)) return 2;
+    latency = epicsTimeDiffInSeconds(&now, &sent);
+    sinkAdd(type, latency);
+    prec->val = 1e6 * latency;
+    prec->udf = 0;
+    return 2;
+}
+
+static long readScalarSink(aiRecord *prec) { return readSink(prec, sinkScalar); }
+static long readArraySink(aiRecord *prec)  { return readSink(prec, sinkArray); }
+
+typedef struct {
+    long        number;
+    DEVSUPFUN   report;
+    DEVSUPFUN   init;
+    DEVSUPFUN   init_record;
+    DEVSUPFUN   get_ioint_info;
+    DEVSUPFUN   read_ai;
+    DEVSUPFUN   special_linconv;
+} sinkDset;
+
+static sinkDset devAiBenchmarkScalarSink = {
+    6, NULL, NULL, (DEVSUPFUN)initSink, NULL, (DEVSUPFUN)readScalarSink, NULL
+};
+static sinkDset devAiBenchmarkArraySink = {
+    6, NULL, NULL, (DEVSUPFUN)initSink, NULL, (DEVSUPFUN)readArraySink, NULL
+};
+
+/* Configuration routines.  Called directly, or from the iocsh function below */
+
+extern "C" {
+
+epicsExportAddress(dset, devAiBenchmarkScalarSink);
+epicsExportAddress(dset, devAiBenchmarkArraySink);
+
+/** EPICS iocsh callable function to call constructor for the testAsynBenchmark class.
+  * \param[in] portName The name of the asyn port driver to be created.
+  * \param[in] numChannels The number of addresses that get callbacks.
+  * \param[in] maxArrayLength The largest array length that can be selected. */
+int testAsynBenchmarkConfigure(const char *portName, int numChannels, int maxArrayLength)
+{
+    if (numChannels < 1) numChannels = 1;
+    new testAsynBenchmark(portName, numChannels, maxArrayLength);
+    return(asynSuccess);
+}
+
+/** EPICS iocsh callable function to run one measurement on a testAsynBenchmark port. */
+int testAsynBenchmarkRun(const char *portName, double rate, int arrayLength,
+                         double duration, const char *fileName)
+{
+    testAsynBenchmark *pBenchmark = (testAsynBenchmark *)findAsynPortDriver(portName);
+
+    if (!pBenchmark) {
+        printf("testAsynBenchmarkRun: port %s not found\n", portName);
+        return -1;
+    }
+    return pBenchmark->run(rate, arrayLength, duration, fileName);
+}
+
+
+/* EPICS iocsh shell commands */
+
+static const iocshArg configArg0 = { "portName",iocshArgString};
+static const iocshArg configArg1 = { "numChannels",iocshArgInt};
+static const iocshArg configArg2 = { "maxArrayLength",iocshArgInt};
+static const iocshArg * const configArgs[] = {&configArg0,
+                                              &configArg1,
+                                              &configArg2};
+static const iocshFuncDef configFuncDef = {"testAsynBenchmarkConfigure",3,configArgs};
+static void configCallFunc(const iocshArgBuf *args)
+{
+    testAsynBenchmarkConfigure(args[0].sval, args[1].ival, args[2].ival);
+}
+
+static const iocshArg runArg0 = { "portName",iocshArgString};
+static const iocshArg runArg1 = { "rate",iocshArgDouble};
+static const iocshArg runArg2 = { "arrayLength",iocshArgInt};
+static const iocshArg runArg3 = { "duration",iocshArgDouble};
+static const iocshArg runArg4 = { "fileName",iocshArgString};
+static const iocshArg * const runArgs[] = {&runArg0,
+                                           &runArg1,
+                                           &runArg2,
+                                           &runArg3,
+                                           &runArg4};
+static const iocshFuncDef runFuncDef = {"testAsynBenchmarkRun",5,runArgs};
+static void runCallFunc(const iocshArgBuf *args)
+{
+    testAsynBenchmarkRun(args[0].sval, args[1].dval, args[2].ival, args[3].dval, args[4].sval);
+}
+
+void testAsynBenchmarkRegister(void)
+{
+    iocshRegister(&configFuncDef,configCallFunc);
+    iocshRegister(&runFuncDef,runCallFunc);
+}
+
+epicsExportRegistrar(testAsynBenchmarkRegister);
+
+}
@@ -0,0 +1,52 @@
+/*
+ * testAsynBenchmark.h
+ *
+ * Asyn driver that inherits from the asynPortDriver class to measure the throughput
+ * and latency of callbacks from a driver to I/O Intr records
+ *
+ * Created October 19, 2026
+ */
+
+#include <epicsEvent.h>
+#include <asynPortDriver.h>
+
+/* These are the drvInfo strings that are used to identify the parameters.
+ * They are used by asyn clients, including standard asyn device support */
+#define P_RunString                 "BM_RUN"            /* asynInt32,         r/w */
+#define P_RateString                "BM_RATE"           /* asynFloat64,       r/w */
+#define P_ArrayLengthString         "BM_ARRAY_LENGTH"   /* asynInt32,         r/w */
+#define P_UpdatesString             "BM_UPDATES"        /* asynInt32,         r/o */
+#define P_ScalarString              "BM_SCALAR"         /* asynFloat64,       r/o */
+#define P_ArrayString               "BM_ARRAY"          /* asynFloat64Array,  r/o */
+
+/** Class that generates callbacks on every address at a fixed rate so that the
+  * time for them to reach the records can be measured. */
+class testAsynBenchmark : public asynPortDriver {
+public:
+    testAsynBenchmark(const char *portName, int numChannels, int maxArrayLength);
+    asynStatus writeInt32(asynUser *pasynUser, epicsInt32 value);
+    asynStatus writeFloat64(asynUser *pasynUser, epicsFloat64 value);
+    int run(double rate, int arrayLength, double duration, const char *fileName);
+    void updateThread();
+
+protected:
+    int P_Run;
+    int P_Rate;
+    int P_ArrayLength;
+    int P_Updates;
+    int P_Scalar;
+    int P_Array;
+
+private:
+    int numChannels_;
+    int maxArrayLength_;
+    int arrayLength_;
+    double rate_;
+    int running_;
+    int ticks_;
+    epicsFloat64 *array_;
+    epicsEventId startEvent_;
+    epicsEventId stoppedEvent_;
+    void start();
+    void stop();
+};
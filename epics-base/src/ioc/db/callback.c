@@ -26,7 +26,7 @@
 #include "epicsEvent.h"
 #include "epicsExit.h"
 #include "epicsInterrupt.h"
-#include "epicsRingPointer.h"
+#include "epicsSpin.h"
 #include "epicsString.h"
 #include "epicsThread.h"
 #include "epicsTimer.h"
@@ -51,9 +51,32 @@
 
 static int callbackQueueSize = 2000;
 
+/* A full queue is doubled in size, up to this multiple of callbackQueueSize */
+#define CALLBACK_QUEUE_GROWTH 64
+
+/* Each callback thread has its own queue. Requests are given to an idle
+ * thread when there is one, and threads with nothing to do steal from the
+ * queues of the other threads of the same priority before going to sleep.
+ * A thread is only woken when a request is given to it while it is idle,
+ * or by a busy thread which finds it has more work queued.
+ * The fields ring, size, head, count and idle are protected by lock.
+ */
+typedef struct cbWorker {
+    struct cbQueueSet *set;
+    int index;
+    epicsSpinId lock;
+    epicsCallback **ring;
+    int size;
+    int head;
+    int count;
+    int idle;
+    epicsEventId wakeUp;
+} cbWorker;
+
 typedef struct cbQueueSet {
-    epicsEventId semWakeUp;
-    epicsRingPointerId queue;
+    cbWorker *workers;
+    int nextWorker;
+    int nIdle;
     int queueOverflow;
     int shutdown;
     int threadsConfigured;
@@ -61,6 +84,7 @@ typedef struct cbQueueSet {
 } cbQueueSet;
 
 static cbQueueSet callbackQueue[NUM_CALLBACK_PRIORITIES];
+static epicsThreadPrivateId callbackWorker;
 
 int callbackThreadsDefault = 1;
 /* Don't know what a reasonable default is (yet).
@@ -91,7 +115,6 @@ static unsigned int threadPriority[NUM_CALLBACK_PRIORITIES] = {
     epicsThreadPriorityScanLow + 4,
     epicsThreadPriorityScanHigh + 1
 };
-static int priorityValue[NUM_CALLBACK_PRIORITIES] = {0, 1, 2};
 
 
 int callbackSetQueueSize(int size)
@@ -154,26 +177,148 @@ int callbackParallelThreads(int count, const char *prio)
     return 0;
 }
 
+static epicsCallback * queueTake(cbWorker *pw, int *premaining)
+{
+    epicsCallback *pcallback = NULL;
+    int remaining = 0;
+
+    if (pw->count) {
+        epicsSpinLock(pw->lock);
+        if (pw->count) {
+            pcallback = pw->ring[pw->head];
+            if (++pw->head == pw->size)
+                pw->head = 0;
+            pw->count--;
+        }
+        remaining = pw->count;
+        epicsSpinUnlock(pw->lock);
+    }
+    if (premaining)
+        *premaining = remaining;
+    return pcallback;
+}
+
+/* Double the size of a full queue, not from interrupt context */
+static int queueGrow(cbWorker *pw, int size, int priority)
+{
+    epicsCallback **ring, **old;
+    int i;
+
+    if (size >= callbackQueueSize * CALLBACK_QUEUE_GROWTH)
+        return FALSE;
+    ring = malloc(2 * size * sizeof(epicsCallback *));
+    if (!ring)
+        return FALSE;
+
+    epicsSpinLock(pw->lock);
+    if (pw->size != size) {
+        /* Another thread got here first */
+        epicsSpinUnlock(pw->lock);
+        free(ring);
+        return TRUE;
+    }
+    for (i = 0; i < pw->count; i++) {
+        int j = pw->head + i;
+
+        if (j >= size)
+            j -= size;
+        ring[i] = pw->ring[j];
+    }
+    old = pw->ring;
+    pw->ring = ring;
+    pw->head = 0;
+    pw->size = 2 * size;
+    epicsSpinUnlock(pw->lock);
+
+    free(old);
+    errlogPrintf("callbackRequest: %s queue grown to %d entries\n",
+        threadNamePrefix[priority], 2 * size);
+    return TRUE;
+}
+
+/* Wake one idle thread, returns TRUE if there was one */
+static int wakeIdle(cbQueueSet *mySet)
+{
+    int i;
+
+    for (i = 0; i < mySet->threadsConfigured; i++) {
+        cbWorker *pw = &mySet->workers[i];
+        int wake;
+
+        if (!pw->idle)
+            continue;
+        epicsSpinLock(pw->lock);
+        wake = pw->idle;
+        if (wake) {
+            pw->idle = FALSE;
+            epicsAtomicDecrIntT(&mySet->nIdle);
+        }
+        epicsSpinUnlock(pw->lock);
+        if (wake) {
+            epicsEventSignal(pw->wakeUp);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static epicsCallback * callbackSteal(cbWorker *me)
+{
+    cbQueueSet *mySet = me->set;
+    int n = mySet->threadsConfigured;
+    int i;
+
+    for (i = 1; i < n; i++) {
+        epicsCallback *pcallback =
+            queueTake(&mySet->workers[(me->index + i) % n], NULL);
+
+        if (pcallback)
+            return pcallback;
+    }
+    return NULL;
+}
+
+static void callbackIdle(cbWorker *me)
+{
+    cbQueueSet *mySet = me->set;
+
+    epicsSpinLock(me->lock);
+    if (me->count || mySet->shutdown) {
+        epicsSpinUnlock(me->lock);
+        return;
+    }
+    if (!me->idle) {
+        me->idle = TRUE;
+        epicsAtomicIncrIntT(&mySet->nIdle);
+    }
+    epicsSpinUnlock(me->lock);
+    epicsEventMustWait(me->wakeUp);
+}
+
 static void callbackTask(void *arg)
 {
-    int prio = *(int*)arg;
-    cbQueueSet *mySet = &callbackQueue[prio];
+    cbWorker *me = (cbWorker *)arg;
+    cbQueueSet *mySet = me->set;
 
     taskwdInsert(0, NULL, NULL);
+    epicsThreadPrivateSet(callbackWorker, me);
     epicsEventSignal(startStopEvent);
 
     while(!mySet->shutdown) {
-        void *ptr;
-        if (epicsRingPointerIsEmpty(mySet->queue))
-            epicsEventMustWait(mySet->semWakeUp);
-
-        while ((ptr = epicsRingPointerPop(mySet->queue))) {
-            epicsCallback *pcallback = (epicsCallback *)ptr;
-            if(!epicsRingPointerIsEmpty(mySet->queue))
-                epicsEventMustTrigger(mySet->semWakeUp);
-            mySet->queueOverflow = FALSE;
-            (*pcallback->callback)(pcallback);
+        int remaining;
+        epicsCallback *pcallback = queueTake(me, &remaining);
+
+        if (!pcallback)
+            pcallback = callbackSteal(me);
+        if (!pcallback) {
+            callbackIdle(me);
+            continue;
         }
+        /* Share a backlog with any idle threads */
+        if (remaining && epicsAtomicGetIntT(&mySet->nIdle))
+            wakeIdle(mySet);
+        mySet->queueOverflow = FALSE;
+        (*pcallback->callback)(pcallback);
     }
 
     if(!epicsAtomicDecrIntT(&mySet->threadsRunning))
@@ -181,6 +326,14 @@ static void callbackTask(void *arg)
     taskwdRemove(0);
 }
 
+static void callbackWakeAll(cbQueueSet *mySet)
+{
+    int j;
+
+    for (j = 0; j < mySet->threadsConfigured; j++)
+        epicsEventSignal(mySet->workers[j].wakeUp);
+}
+
 void callbackStop(void)
 {
     int i;
@@ -190,14 +343,14 @@ void callbackStop(void)
 
     for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++) {
         callbackQueue[i].shutdown = 1;
-        epicsEventSignal(callbackQueue[i].semWakeUp);
+        callbackWakeAll(&callbackQueue[i]);
     }
 
     for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++) {
         cbQueueSet *mySet = &callbackQueue[i];
 
         while (epicsAtomicGetIntT(&mySet->threadsRunning)) {
-            epicsEventSignal(mySet->semWakeUp);
+            callbackWakeAll(mySet);
             epicsEventWaitWithTimeout(startStopEvent, 0.1);
         }
     }
@@ -209,10 +362,17 @@ void callbackCleanup(void)
 
     for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++) {
         cbQueueSet *mySet = &callbackQueue[i];
+        int j;
 
         assert(epicsAtomicGetIntT(&mySet->threadsRunning)==0);
-        epicsEventDestroy(mySet->semWakeUp);
-        epicsRingPointerDelete(mySet->queue);
+        for (j = 0; j < mySet->threadsConfigured; j++) {
+            cbWorker *pw = &mySet->workers[j];
+
+            epicsEventDestroy(pw->wakeUp);
+            epicsSpinDestroy(pw->lock);
+            free(pw->ring);
+        }
+        free(mySet->workers);
     }
 
     epicsTimerQueueRelease(timerQueue);
@@ -234,45 +394,85 @@ void callbackInit(void)
 
     if(!startStopEvent)
         startStopEvent = epicsEventMustCreate(epicsEventEmpty);
+    if (!callbackWorker)
+        callbackWorker = epicsThreadPrivateCreate();
     cbCtl = ctlRun;
     timerQueue = epicsTimerQueueAllocate(0, epicsThreadPriorityScanHigh);
 
     for (i = 0; i < NUM_CALLBACK_PRIORITIES; i++) {
+        cbQueueSet *mySet = &callbackQueue[i];
         epicsThreadId tid;
 
-        callbackQueue[i].semWakeUp = epicsEventMustCreate(epicsEventEmpty);
-        callbackQueue[i].queue = epicsRingPointerLockedCreate(callbackQueueSize);
-        if (callbackQueue[i].queue == 0)
-            cantProceed("epicsRingPointerLockedCreate failed for %s\n",
-                threadNamePrefix[i]);
-        callbackQueue[i].queueOverflow = FALSE;
-        if (callbackQueue[i].threadsConfigured == 0)
-            callbackQueue[i].threadsConfigured = callbackThreadsDefault;
-
-        for (j = 0; j < callbackQueue[i].threadsConfigured; j++) {
-            if (callbackQueue[i].threadsConfigured > 1 )
+        mySet->queueOverflow = FALSE;
+        if (mySet->threadsConfigured == 0)
+            mySet->threadsConfigured = callbackThreadsDefault;
+        mySet->workers = callocMustSucceed(mySet->threadsConfigured,
+            sizeof(cbWorker), "callbackInit");
+
+        for (j = 0; j < mySet->threadsConfigured; j++) {
+            cbWorker *pw = &mySet->workers[j];
+
+            pw->set = mySet;
+            pw->index = j;
+            pw->lock = epicsSpinMustCreate();
+            pw->wakeUp = epicsEventMustCreate(epicsEventEmpty);
+            pw->size = callbackQueueSize;
+            pw->ring = callocMustSucceed(pw->size, sizeof(epicsCallback *),
+                "callbackInit");
+        }
+
+        for (j = 0; j < mySet->threadsConfigured; j++) {
+            if (mySet->threadsConfigured > 1 )
                 sprintf(threadName, "%s-%d", threadNamePrefix[i], j);
             else
                 strcpy(threadName, threadNamePrefix[i]);
             tid = epicsThreadCreate(threadName, threadPriority[i],
                 epicsThreadGetStackSize(epicsThreadStackBig),
-                (EPICSTHREADFUNC)callbackTask, &priorityValue[i]);
+                (EPICSTHREADFUNC)callbackTask, &mySet->workers[j]);
             if (tid == 0) {
                 cantProceed("Failed to spawn callback thread %s\n", threadName);
             } else {
                 epicsEventWait(startStopEvent);
-                epicsAtomicIncrIntT(&callbackQueue[i].threadsRunning);
+                epicsAtomicIncrIntT(&mySet->threadsRunning);
             }
         }
     }
 }
 
+/* Pick the queue for a new request */
+static cbWorker * callbackTarget(cbQueueSet *mySet)
+{
+    int n = mySet->threadsConfigured;
+    int i;
+
+    if (n == 1)
+        return &mySet->workers[0];
+
+    if (epicsAtomicGetIntT(&mySet->nIdle)) {
+        for (i = 0; i < n; i++) {
+            if (mySet->workers[i].idle)
+                return &mySet->workers[i];
+        }
+    }
+    /* Requests made by callbacks stay with the same thread */
+    if (!epicsInterruptIsInterruptContext()) {
+        cbWorker *self = (cbWorker *)epicsThreadPrivateGet(callbackWorker);
+
+        if (self && self->set == mySet)
+            return self;
+    }
+    return &mySet->workers[
+        (unsigned int)epicsAtomicIncrIntT(&mySet->nextWorker) % n];
+}
+
 /* This routine can be called from interrupt context */
 int callbackRequest(epicsCallback *pcallback)
 {
     int priority;
-    int pushOK;
+    int tail;
+    int wake;
     cbQueueSet *mySet;
+    cbWorker *pw;
 
     if (!pcallback) {
         epicsInterruptContextMessage("callbackRequest: pcallback was NULL\n");
@@ -286,14 +486,40 @@ int callbackRequest(epicsCallback *pcallback)
     mySet = &callbackQueue[priority];
     if (mySet->queueOverflow) return S_db_bufFull;
 
-    pushOK = epicsRingPointerPush(mySet->queue, pcallback);
-
-    if (!pushOK) {
-        epicsInterruptContextMessage(fullMessage[priority]);
-        mySet->queueOverflow = TRUE;
-        return S_db_bufFull;
+    pw = callbackTarget(mySet);
+    for (;;) {
+        int size;
+
+        epicsSpinLock(pw->lock);
+        if (pw->count < pw->size)
+            break;
+        size = pw->size;
+        epicsSpinUnlock(pw->lock);
+
+        /* Memory can't be allocated in interrupt context */
+        if (epicsInterruptIsInterruptContext() ||
+            !queueGrow(pw, size, priority)) {
+            epicsInterruptContextMessage(fullMessage[priority]);
+            mySet->queueOverflow = TRUE;
+            return S_db_bufFull;
+        }
+    }
+    tail = pw->head + pw->count;
+    if (tail >= pw->size)
+        tail -= pw->size;
+    pw->ring[tail] = pcallback;
+    pw->count++;
+    wake = pw->idle;
+    if (wake) {
+        pw->idle = FALSE;
+        epicsAtomicDecrIntT(&mySet->nIdle);
     }
-    epicsEventSignal(mySet->semWakeUp);
+    epicsSpinUnlock(pw->lock);
+
+    if (wake)
+        epicsEventSignal(pw->wakeUp);
+    else if (epicsAtomicGetIntT(&mySet->nIdle))
+        wakeIdle(mySet);
     return 0;
 }
 
@@ -52,6 +52,7 @@
 #include "dbLink.h"
 #include "dbLock.h"
 #include "dbNotify.h"
+#include "dbProfile.h"
 #include "dbScan.h"
 #include "dbServer.h"
 #include "dbStaticLib.h"
@@ -594,7 +595,15 @@ long dbProcess(dbCommon *precord)
         printf("%s: Process %s\n", context, precord->name);
 
     /* process record */
-    status = prset->process(precord);
+    if (dbProfileEnabled) {
+        epicsTimeStamp start;
+
+        epicsTimeGetCurrent(&start);
+        status = prset->process(precord);
+        dbProfileProcessed(precord, &start);
+    }
+    else
+        status = prset->process(precord);
 
     /* Print record's fields if PRINT_MASK set in breakpoint field */
     if (lset_stack_count != 0) {
@@ -826,8 +835,23 @@ long dbGetField(DBADDR *paddr,short dbrType,
     void *pbuffer, long *options, long *nRequest, void *pflin)
 {
     dbCommon *precord = paddr->precord;
+    db_field_log *pfl = (db_field_log *)pflin;
+    unsigned long seq;
     long status = 0;
 
+    /* Try reading a scalar without the lock first */
+    if ((!pfl || pfl->type != dbfl_type_ref) &&
+        (seq = dbLockReadBegin(paddr))) {
+        long opts = options ? *options : 0;
+        long nReq = nRequest ? *nRequest : 0;
+
+        status = dbGet(paddr, dbrType, pbuffer, options, nRequest, pflin);
+        if (dbLockReadEnd(paddr, seq))
+            return status;
+        if (options) *options = opts;
+        if (nRequest) *nRequest = nReq;
+    }
+
     dbScanLock(precord);
     status = dbGet(paddr, dbrType, pbuffer, options, nRequest, pflin);
     dbScanUnlock(precord);
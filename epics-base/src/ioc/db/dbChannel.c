@@ -32,6 +32,7 @@
 #include "dbBase.h"
 #include "dbChannel.h"
 #include "dbCommon.h"
+#include "dbConvertFast.h"
 #include "dbEvent.h"
 #include "dbLock.h"
 #include "dbStaticLib.h"
@@ -659,6 +660,17 @@ long dbChannelOpen(dbChannel *chan)
     chan->final_field_size   = probe.field_size;
     chan->final_type         = probe.field_type;
 
+    /* A plain scalar field always converts through the same row of
+     * dbFastGetConvertRoutine, so look it up once here.
+     */
+    if (chan->addr.no_elements == 1 &&
+        chan->addr.field_type <= DBF_DEVICE &&
+        chan->addr.special != SPC_ATTRIBUTE &&
+        chan->addr.pfldDes->special != SPC_DBADDR)
+        chan->get_convert = dbFastGetConvertRoutine[chan->addr.field_type];
+    else
+        chan->get_convert = NULL;
+
     return 0;
 }
 
@@ -666,19 +678,35 @@ long dbChannelOpen(dbChannel *chan)
 long dbChannelGet(dbChannel *chan, short type, void *pbuffer,
         long *options, long *nRequest, void *pfl)
 {
+    db_field_log *plog = (db_field_log *) pfl;
+
+    /* Value-only reads of scalars go straight to the converter */
+    if (chan->get_convert && (!options || !*options) &&
+        !INVALID_DB_REQ(type)) {
+        if (nRequest) {
+            if (*nRequest == 0)
+                return 0;
+            *nRequest = 1;
+        }
+        if (!plog || plog->type == dbfl_type_rec)
+            return chan->get_convert[type](chan->addr.pfield, pbuffer,
+                &chan->addr);
+        if (plog->type == dbfl_type_val &&
+            plog->field_type == chan->addr.field_type) {
+            DBADDR localAddr = chan->addr; /* Structure copy */
+
+            localAddr.pfield = (char *) &plog->u.v.field;
+            return chan->get_convert[type](localAddr.pfield, pbuffer,
+                &localAddr);
+        }
+    }
     return dbGet(&chan->addr, type, pbuffer, options, nRequest, pfl);
 }
 
 long dbChannelGetField(dbChannel *chan, short dbrType, void *pbuffer,
         long *options, long *nRequest, void *pfl)
 {
-    dbCommon *precord = chan->addr.precord;
-    long status = 0;
-
-    dbScanLock(precord);
-    status = dbChannelGet(chan, dbrType, pbuffer, options, nRequest, pfl);
-    dbScanUnlock(precord);
-    return status;
+    return dbGetField(&chan->addr, dbrType, pbuffer, options, nRequest, pfl);
 }
 
 /* Only use dbChannelPut() if the record is already locked.
@@ -63,6 +63,65 @@ static void copyNoConvert(const void *pfrom,
 #define COPYNOCONVERT(N, FROM, TO, NREQ, NO_ELEM, OFFSET) \
     copyNoConvert(FROM, TO, (N)*(NREQ), (N)*(NO_ELEM), (N)*(OFFSET))
 
+/* Number of elements that can be converted starting at offset before an
+ * array of no_elements wraps around, limited to nRequest.
+ */
+static long contiguous(long nRequest, long no_elements, long offset)
+{
+    long n = no_elements - offset;
+
+    return (n > 0 && n < nRequest) ? n : nRequest;
+}
+
+/* Helpers for numeric array conversions. The field may be a circular
+ * buffer, so the request is converted in contiguous sections up to and
+ * after the wrap. The inner loops then have no wrap test in them and the
+ * compiler can vectorize them.
+ * GET_ARRAY copies from psrc to pbuffer, PUT_ARRAY from pbuffer to pdest,
+ * CONVERT is applied to each element and TYPE is the type of the field.
+ */
+#define GET_ARRAY(TYPE, CONVERT) \
+    while (nRequest) { \
+        long i, n = contiguous(nRequest, no_elements, offset); \
+        for (i = 0; i < n; i++) \
+            pbuffer[i] = CONVERT(psrc[i]); \
+        pbuffer += n; \
+        nRequest -= n; \
+        offset = 0; \
+        psrc = (TYPE *) paddr->pfield; \
+    }
+
+#define PUT_ARRAY(TYPE, CONVERT) \
+    while (nRequest) { \
+        long i, n = contiguous(nRequest, no_elements, offset); \
+        for (i = 0; i < n; i++) \
+            pdest[i] = CONVERT(pbuffer[i]); \
+        pbuffer += n; \
+        nRequest -= n; \
+        offset = 0; \
+        pdest = (TYPE *) paddr->pfield; \
+    }
+
+/* Same result as epicsConvertDoubleToFloat(), but computing both
+ * limits up front and selecting between them so that array loops
+ * using it can vectorize. abs == abs is false for a NaN.
+ */
+static float doubleToFloat(double value)
+{
+    double abs = fabs(value);
+    float rtnvalue = (float)value;
+    float big = value < 0 ? -FLT_MAX : FLT_MAX;
+    float tiny = value < 0 ? -FLT_MIN : FLT_MIN;
+
+    if (abs == abs && abs >= FLT_MAX && abs <= DBL_MAX)
+        rtnvalue = big;
+    if (abs == abs && abs <= FLT_MIN)
+        rtnvalue = tiny;
+    if (value == 0)
+        rtnvalue = 0;
+    return rtnvalue;
+}
+
 /* DATABASE ACCESS GET CONVERSION SUPPORT */
 
 static long getStringString (
@@ -490,12 +549,7 @@ static long getCharShort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (char *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(char, (epicsInt16));
     return 0;
 }
 
@@ -511,12 +565,7 @@ static long getCharUshort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (char *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(char, (epicsUInt16));
     return 0;
 }
 
@@ -532,12 +581,7 @@ static long getCharLong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (char *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(char, (epicsInt32));
     return 0;
 }
 
@@ -553,12 +597,7 @@ static long getCharUlong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (char *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(char, (epicsUInt32));
     return 0;
 }
 
@@ -574,12 +613,7 @@ static long getCharFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (char *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(char, (float));
     return 0;
 }
 
@@ -595,12 +629,7 @@ static long getCharDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (char *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(char, (double));
     return 0;
 }
 
@@ -616,12 +645,7 @@ static long getCharEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (char *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(char, (epicsEnum16));
     return 0;
 }
 
@@ -691,12 +715,7 @@ static long getUcharShort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt8, (epicsInt16));
     return 0;
 }
 
@@ -712,12 +731,7 @@ static long getUcharUshort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt8, (epicsUInt16));
     return 0;
 }
 
@@ -733,12 +747,7 @@ static long getUcharLong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt8, (epicsInt32));
     return 0;
 }
 
@@ -754,12 +763,7 @@ static long getUcharUlong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt8, (epicsUInt32));
     return 0;
 }
 
@@ -775,12 +779,7 @@ static long getUcharFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt8, (float));
     return 0;
 }
 
@@ -796,12 +795,7 @@ static long getUcharDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt8, (double));
     return 0;
 }
 
@@ -817,12 +811,7 @@ static long getUcharEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt8, (epicsEnum16));
     return 0;
 }
 
@@ -862,12 +851,7 @@ static long getShortChar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (char)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt16, (char));
     return 0;
 }
 
@@ -883,12 +867,7 @@ static long getShortUchar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt8)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt16, (epicsUInt8));
     return 0;
 }
 
@@ -934,12 +913,7 @@ static long getShortLong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt16, (epicsInt32));
     return 0;
 }
 
@@ -955,12 +929,7 @@ static long getShortUlong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt16, (epicsUInt32));
     return 0;
 }
 
@@ -976,12 +945,7 @@ static long getShortFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt16, (float));
     return 0;
 }
 
@@ -997,12 +961,7 @@ static long getShortDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt16, (double));
     return 0;
 }
 
@@ -1018,12 +977,7 @@ static long getShortEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt16, (epicsEnum16));
     return 0;
 }
 
@@ -1063,12 +1017,7 @@ static long getUshortChar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (char)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt16, (char));
     return 0;
 }
 
@@ -1084,12 +1033,7 @@ static long getUshortUchar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt8)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt16, (epicsUInt8));
     return 0;
 }
 static long getUshortShort(
@@ -1134,12 +1078,7 @@ static long getUshortLong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt16, (epicsInt32));
     return 0;
 }
 
@@ -1155,12 +1094,7 @@ static long getUshortUlong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt16, (epicsUInt32));
     return 0;
 }
 
@@ -1176,12 +1110,7 @@ static long getUshortFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt16, (float));
     return 0;
 }
 
@@ -1197,12 +1126,7 @@ static long getUshortDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt16, (double));
     return 0;
 }
 
@@ -1218,12 +1142,7 @@ static long getUshortEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt16, (epicsEnum16));
     return 0;
 }
 
@@ -1263,12 +1182,7 @@ static long getLongChar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt32, (char));
     return 0;
 }
 
@@ -1284,12 +1198,7 @@ static long getLongUchar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt32, (epicsUInt8));
     return 0;
 }
 
@@ -1305,12 +1214,7 @@ static long getLongShort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt32, (epicsInt16));
     return 0;
 }
 
@@ -1326,12 +1230,7 @@ static long getLongUshort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt32, (epicsUInt16));
     return 0;
 }
 
@@ -1377,12 +1276,7 @@ static long getLongFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (float)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt32, (float));
     return 0;
 }
 
@@ -1398,12 +1292,7 @@ static long getLongDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt32, (double));
     return 0;
 }
 
@@ -1419,12 +1308,7 @@ static long getLongEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsInt32, (epicsEnum16));
     return 0;
 }
 
@@ -1464,12 +1348,7 @@ static long getUlongChar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt32, (char));
     return 0;
 }
 
@@ -1485,12 +1364,7 @@ static long getUlongUchar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt32, (epicsUInt8));
     return 0;
 }
 
@@ -1506,12 +1380,7 @@ static long getUlongShort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt32, (epicsInt16));
     return 0;
 }
 
@@ -1527,12 +1396,7 @@ static long getUlongUshort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt32, (epicsUInt16));
     return 0;
 }
 
@@ -1578,12 +1442,7 @@ static long getUlongFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (float)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt32, (float));
     return 0;
 }
 
@@ -1599,12 +1458,7 @@ static long getUlongDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt32, (double));
     return 0;
 }
 
@@ -1620,12 +1474,7 @@ static long getUlongEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsUInt32, (epicsEnum16));
     return 0;
 }
 
@@ -1671,12 +1520,7 @@ static long getFloatChar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (char)*psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (char));
     return 0;
 }
 
@@ -1692,12 +1536,7 @@ static long getFloatUchar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt8)*psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (epicsUInt8));
     return 0;
 }
 
@@ -1713,12 +1552,7 @@ static long getFloatShort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsInt16)*psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (epicsInt16));
     return 0;
 }
 
@@ -1734,12 +1568,7 @@ static long getFloatUshort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt16)*psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (epicsUInt16));
     return 0;
 }
 
@@ -1755,12 +1584,7 @@ static long getFloatLong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsInt32)*psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (epicsInt32));
     return 0;
 }
 
@@ -1776,12 +1600,7 @@ static long getFloatUlong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt32)*psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (epicsUInt32));
     return 0;
 }
 
@@ -1812,12 +1631,7 @@ static long getFloatDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (double));
     return 0;
 }
 
@@ -1833,12 +1647,7 @@ static long getFloatEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsEnum16)*psrc++;
-        if (++offset == no_elements)
-            psrc = (float *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(float, (epicsEnum16));
     return 0;
 }
 
@@ -1884,12 +1693,7 @@ static long getDoubleChar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (char)*psrc++;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, (char));
     return 0;
 }
 
@@ -1905,12 +1709,7 @@ static long getDoubleUchar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt8)*psrc++;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, (epicsUInt8));
     return 0;
 }
 
@@ -1926,12 +1725,7 @@ static long getDoubleShort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsInt16)*psrc++;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, (epicsInt16));
     return 0;
 }
 
@@ -1947,12 +1741,7 @@ static long getDoubleUshort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt16)*psrc++;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, (epicsUInt16));
     return 0;
 }
 
@@ -1968,12 +1757,7 @@ static long getDoubleLong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsInt32)*psrc++;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, (epicsInt32));
     return 0;
 }
 
@@ -1989,12 +1773,7 @@ static long getDoubleUlong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt32)*psrc++;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, (epicsUInt32));
     return 0;
 }
 
@@ -2010,13 +1789,7 @@ static long getDoubleFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer = epicsConvertDoubleToFloat(*psrc);
-        ++psrc; ++pbuffer;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, doubleToFloat);
     return 0;
 }
 
@@ -2047,12 +1820,7 @@ static long getDoubleEnum(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsEnum16)*psrc++;
-        if (++offset == no_elements)
-            psrc = (double *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(double, (epicsEnum16));
     return 0;
 }
 
@@ -2083,12 +1851,7 @@ static long getEnumChar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (char)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (char));
     return 0;
 }
 
@@ -2104,12 +1867,7 @@ static long getEnumUchar(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = (epicsUInt8)*psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (epicsUInt8));
     return 0;
 }
 
@@ -2125,12 +1883,7 @@ static long getEnumShort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (epicsInt16));
     return 0;
 }
 
@@ -2146,12 +1899,7 @@ static long getEnumUshort(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (epicsUInt16));
     return 0;
 }
 
@@ -2167,12 +1915,7 @@ static long getEnumLong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (epicsInt32));
     return 0;
 }
 
@@ -2188,12 +1931,7 @@ static long getEnumUlong(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (epicsUInt32));
     return 0;
 }
 
@@ -2209,12 +1947,7 @@ static long getEnumFloat(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (float));
     return 0;
 }
 
@@ -2230,12 +1963,7 @@ static long getEnumDouble(
         return 0;
     }
     psrc += offset;
-    while (nRequest) {
-        *pbuffer++ = *psrc++;
-        if (++offset == no_elements)
-            psrc = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    GET_ARRAY(epicsEnum16, (double));
     return 0;
 }
 
@@ -2782,12 +2510,7 @@ static long putCharShort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt16, (epicsInt16));
     return 0;
 }
 
@@ -2803,12 +2526,7 @@ static long putCharUshort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt16, (epicsUInt16));
     return 0;
 }
 
@@ -2824,12 +2542,7 @@ static long putCharLong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt32, (epicsInt32));
     return 0;
 }
 
@@ -2845,12 +2558,7 @@ static long putCharUlong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt32, (epicsUInt32));
     return 0;
 }
 
@@ -2866,12 +2574,7 @@ static long putCharFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, (float));
     return 0;
 }
 
@@ -2887,12 +2590,7 @@ static long putCharDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
@@ -2908,12 +2606,7 @@ static long putCharEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -2985,12 +2678,7 @@ static long putUcharShort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt16, (epicsInt16));
     return 0;
 }
 
@@ -3006,12 +2694,7 @@ static long putUcharUshort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt16, (epicsUInt16));
     return 0;
 }
 
@@ -3027,12 +2710,7 @@ static long putUcharLong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt32, (epicsInt32));
     return 0;
 }
 
@@ -3048,12 +2726,7 @@ static long putUcharUlong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt32, (epicsUInt32));
     return 0;
 }
 
@@ -3069,12 +2742,7 @@ static long putUcharFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, (float));
     return 0;
 }
 
@@ -3090,12 +2758,7 @@ static long putUcharDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
@@ -3111,12 +2774,7 @@ static long putUcharEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -3158,12 +2816,7 @@ static long putShortChar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (char) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (char *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(char, (char));
     return 0;
 }
 
@@ -3179,12 +2832,7 @@ static long putShortUchar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt8) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt8, (epicsUInt8));
     return 0;
 }
 
@@ -3230,12 +2878,7 @@ static long putShortLong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt32, (epicsInt32));
     return 0;
 }
 
@@ -3251,12 +2894,7 @@ static long putShortUlong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt32, (epicsUInt32));
     return 0;
 }
 
@@ -3272,12 +2910,7 @@ static long putShortFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, (float));
     return 0;
 }
 
@@ -3293,12 +2926,7 @@ static long putShortDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
@@ -3314,12 +2942,7 @@ static long putShortEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -3361,12 +2984,7 @@ static long putUshortChar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (char) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (char *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(char, (char));
     return 0;
 }
 
@@ -3382,12 +3000,7 @@ static long putUshortUchar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt8) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt8, (epicsUInt8));
     return 0;
 }
 
@@ -3433,12 +3046,7 @@ static long putUshortLong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt32, (epicsInt32));
     return 0;
 }
 
@@ -3454,12 +3062,7 @@ static long putUshortUlong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt32, (epicsUInt32));
     return 0;
 }
 
@@ -3475,12 +3078,7 @@ static long putUshortFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, (float));
     return 0;
 }
 
@@ -3496,12 +3094,7 @@ static long putUshortDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
@@ -3517,12 +3110,7 @@ static long putUshortEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -3564,12 +3152,7 @@ static long putLongChar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (char *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(char, (char));
     return 0;
 }
 
@@ -3585,12 +3168,7 @@ static long putLongUchar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt8, (epicsUInt8));
     return 0;
 }
 
@@ -3606,12 +3184,7 @@ static long putLongShort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt16, (epicsInt16));
     return 0;
 }
 
@@ -3627,12 +3200,7 @@ static long putLongUshort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt16, (epicsUInt16));
     return 0;
 }
 
@@ -3678,12 +3246,7 @@ static long putLongFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (float) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, (float));
     return 0;
 }
 
@@ -3699,12 +3262,7 @@ static long putLongDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
@@ -3720,12 +3278,7 @@ static long putLongEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -3767,12 +3320,7 @@ static long putUlongChar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (char *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(char, (char));
     return 0;
 }
 
@@ -3788,12 +3336,7 @@ static long putUlongUchar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt8, (epicsUInt8));
     return 0;
 }
 
@@ -3809,12 +3352,7 @@ static long putUlongShort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt16, (epicsInt16));
     return 0;
 }
 
@@ -3830,12 +3368,7 @@ static long putUlongUshort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt16, (epicsUInt16));
     return 0;
 }
 
@@ -3881,12 +3414,7 @@ static long putUlongFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (float) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, (float));
     return 0;
 }
 
@@ -3902,12 +3430,7 @@ static long putUlongDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
@@ -3923,12 +3446,7 @@ static long putUlongEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -3974,12 +3492,7 @@ static long putFloatChar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (char) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (char *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(char, (char));
     return 0;
 }
 
@@ -3995,12 +3508,7 @@ static long putFloatUchar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt8) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt8, (epicsUInt8));
     return 0;
 }
 
@@ -4016,12 +3524,7 @@ static long putFloatShort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsInt16) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt16, (epicsInt16));
     return 0;
 }
 
@@ -4037,12 +3540,7 @@ static long putFloatUshort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt16) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt16, (epicsUInt16));
     return 0;
 }
 
@@ -4058,12 +3556,7 @@ static long putFloatLong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsInt32) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt32, (epicsInt32));
     return 0;
 }
 
@@ -4079,12 +3572,7 @@ static long putFloatUlong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt32) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt32, (epicsUInt32));
     return 0;
 }
 
@@ -4115,12 +3603,7 @@ static long putFloatDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
@@ -4136,12 +3619,7 @@ static long putFloatEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsEnum16) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -4187,12 +3665,7 @@ static long putDoubleChar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (char) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (char *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(char, (char));
     return 0;
 }
 
@@ -4208,12 +3681,7 @@ static long putDoubleUchar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt8) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt8, (epicsUInt8));
     return 0;
 }
 
@@ -4229,12 +3697,7 @@ static long putDoubleShort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsInt16) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt16, (epicsInt16));
     return 0;
 }
 
@@ -4250,12 +3713,7 @@ static long putDoubleUshort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt16) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt16, (epicsUInt16));
     return 0;
 }
 
@@ -4271,12 +3729,7 @@ static long putDoubleLong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsInt32) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt32, (epicsInt32));
     return 0;
 }
 
@@ -4292,12 +3745,7 @@ static long putDoubleUlong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt32) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt32, (epicsUInt32));
     return 0;
 }
 
@@ -4313,13 +3761,7 @@ static long putDoubleFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest = epicsConvertDoubleToFloat(*pbuffer);
-        ++pbuffer; ++pdest;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, doubleToFloat);
     return 0;
 }
 
@@ -4350,12 +3792,7 @@ static long putDoubleEnum(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsEnum16) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsEnum16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsEnum16, (epicsEnum16));
     return 0;
 }
 
@@ -4397,12 +3834,7 @@ static long putEnumChar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (char) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (char *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(char, (char));
     return 0;
 }
 
@@ -4418,12 +3850,7 @@ static long putEnumUchar(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = (epicsUInt8) *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt8 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt8, (epicsUInt8));
     return 0;
 }
 
@@ -4439,12 +3866,7 @@ static long putEnumShort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt16, (epicsInt16));
     return 0;
 }
 
@@ -4460,12 +3882,7 @@ static long putEnumUshort(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt16 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt16, (epicsUInt16));
     return 0;
 }
 
@@ -4481,12 +3898,7 @@ static long putEnumLong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsInt32, (epicsInt32));
     return 0;
 }
 
@@ -4502,12 +3914,7 @@ static long putEnumUlong(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (epicsUInt32 *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(epicsUInt32, (epicsUInt32));
     return 0;
 }
 
@@ -4523,12 +3930,7 @@ static long putEnumFloat(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (float *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(float, (float));
     return 0;
 }
 
@@ -4544,12 +3946,7 @@ static long putEnumDouble(
         return 0;
     }
     pdest += offset;
-    while (nRequest) {
-        *pdest++ = *pbuffer++;
-        if (++offset == no_elements)
-            pdest = (double *) paddr->pfield;
-        nRequest--;
-    }
+    PUT_ARRAY(double, (double));
     return 0;
 }
 
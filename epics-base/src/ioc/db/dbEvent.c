@@ -63,6 +63,8 @@ struct event_que {
     epicsMutexId            writelock;
     db_field_log            *valque[EVENTQUESIZE];
     struct evSubscrip       *evque[EVENTQUESIZE];
+    /* value storage for monitors of scalar fields without filters */
+    db_field_log            inlineLog[EVENTQUESIZE];
     struct event_que        *nextque;       /* in case que quota exceeded */
     struct event_user       *evUser;        /* event user parent struct */
     unsigned short          putix;
@@ -92,6 +94,8 @@ struct event_user {
     unsigned char       extraLaborBusy;
     void                (*init_func)();
     epicsThreadId       init_func_arg;
+    void                (*wakeup_func)(void *); /* no event task */
+    void                *wakeup_arg;
 };
 
 /*
@@ -117,8 +121,21 @@ static char *EVENT_PEND_NAME = "eventTask";
 
 static struct evSubscrip canceledEvent;
 
+static void event_free_queues ( struct event_user *evUser );
+
 static epicsMutexId stopSync;
 
+/*
+ * Logs in the inlineLog array of an event_que belong to the queue entry with
+ * the same index and must not be passed to db_delete_field_log()
+ */
+static int isInlineLog ( const struct event_que *ev_que,
+    const db_field_log *pLog )
+{
+    return pLog >= ev_que->inlineLog &&
+        pLog < ev_que->inlineLog + EVENTQUESIZE;
+}
+
 static unsigned short ringSpace ( const struct event_que *pevq )
 {
     if ( pevq->evque[pevq->putix] == EVENTQEMPTY ) {
@@ -132,6 +149,26 @@ static unsigned short ringSpace ( const struct event_que *pevq )
     return 0;
 }
 
+/*
+ * EVENT_WAKEUP()
+ *
+ * Tell the event task, or the owner running the queues
+ * with db_process_events(), that there is work to do
+ */
+static void event_wakeup ( struct event_user *evUser )
+{
+    if ( evUser->wakeup_func ) {
+        epicsMutexMustLock ( evUser->lock );
+        if ( ! evUser->pendexit ) {
+            ( *evUser->wakeup_func ) ( evUser->wakeup_arg );
+        }
+        epicsMutexUnlock ( evUser->lock );
+    }
+    else {
+        epicsEventSignal ( evUser->ppendsem );
+    }
+}
+
 /*
  *  db_event_list ()
  */
@@ -350,7 +387,15 @@ void db_close_events (dbEventCtx ctx)
      * hazardous to the system's health.
      */
     epicsMutexMustLock ( evUser->lock );
-    if(!evUser->pendexit) { /* event task running */
+    if(!evUser->pendexit && evUser->wakeup_func) { /* run by the owner */
+        evUser->pendexit = TRUE;
+        epicsMutexUnlock ( evUser->lock );
+
+        event_free_queues(evUser);
+
+        epicsMutexMustLock ( evUser->lock );
+    }
+    else if(!evUser->pendexit) { /* event task running */
         evUser->pendexit = TRUE;
         epicsMutexUnlock ( evUser->lock );
 
@@ -658,12 +703,39 @@ int db_post_extra_labor (dbEventCtx ctx)
     epicsMutexUnlock ( evUser->lock );
 
     if ( doit ) {
-        epicsEventSignal(evUser->ppendsem);
+        event_wakeup(evUser);
     }
 
     return DB_EVENT_OK;
 }
 
+/*
+ *  FILL_EVENT_VALUE()
+ *
+ *  Copies the value and meta-data of a scalar field into a log,
+ *  with the record locked
+ */
+static void fill_event_value (struct evSubscrip *pevent, db_field_log *pLog)
+{
+    struct dbChannel *chan = pevent->chan;
+    struct dbCommon  *prec = dbChannelRecord(chan);
+
+    pLog->type = dbfl_type_val;
+    pLog->stat = prec->stat;
+    pLog->sevr = prec->sevr;
+    pLog->time = prec->time;
+    pLog->field_type  = dbChannelFieldType(chan);
+    pLog->no_elements = dbChannelElements(chan);
+    /*
+     * use memcpy to avoid a bus error on
+     * union copy of char in the db at an odd
+     * address
+     */
+    memcpy(&pLog->u.v.field,
+           dbChannelField(chan),
+           dbChannelFieldSize(chan));
+}
+
 /*
  *  DB_CREATE_EVENT_LOG()
  *
@@ -675,24 +747,9 @@ db_field_log* db_create_event_log (struct evSubscrip *pevent)
     db_field_log *pLog = (db_field_log *) freeListCalloc(dbevFieldLogFreeList);
 
     if (pLog) {
-        struct dbChannel *chan = pevent->chan;
-        struct dbCommon  *prec = dbChannelRecord(chan);
         pLog->ctx = dbfl_context_event;
         if (pevent->useValque) {
-            pLog->type = dbfl_type_val;
-            pLog->stat = prec->stat;
-            pLog->sevr = prec->sevr;
-            pLog->time = prec->time;
-            pLog->field_type  = dbChannelFieldType(chan);
-            pLog->no_elements = dbChannelElements(chan);
-            /*
-             * use memcpy to avoid a bus error on
-             * union copy of char in the db at an odd
-             * address
-             */
-            memcpy(&pLog->u.v.field,
-                   dbChannelField(chan),
-                   dbChannelFieldSize(chan));
+            fill_event_value(pevent, pLog);
         } else {
             pLog->type = dbfl_type_rec;
         }
@@ -715,9 +772,28 @@ db_field_log* db_create_read_log (struct dbChannel *chan)
     return pLog;
 }
 
+/*
+ *  SET_EVENT_LOG()
+ *
+ *  Stores pLog in a queue entry, or when pLog is NULL copies the
+ *  current value into the entry's inline log
+ */
+static void set_event_log (struct event_que *ev_que, unsigned short index,
+    evSubscrip *pevent, db_field_log *pLog)
+{
+    if (!pLog) {
+        pLog = &ev_que->inlineLog[index];
+        pLog->ctx = dbfl_context_event;
+        fill_event_value(pevent, pLog);
+    }
+    ev_que->valque[index] = pLog;
+}
+
 /*
  *  DB_QUEUE_EVENT_LOG()
  *
+ *  A NULL pLog queues the current value of a scalar field
+ *  without allocating a log
  */
 static void db_queue_event_log (evSubscrip *pevent, db_field_log *pLog)
 {
@@ -739,7 +815,7 @@ static void db_queue_event_log (evSubscrip *pevent, db_field_log *pLog)
      * (i.e. of type dbfl_type_rec), simply ignore duplicate
      * events (saving empty events serves no purpose)
      */
-    if (pevent->npend > 0u &&
+    if (pevent->npend > 0u && pLog &&
         (*pevent->pLastLog)->type == dbfl_type_rec &&
         pLog->type == dbfl_type_rec) {
         db_delete_field_log(pLog);
@@ -763,8 +839,11 @@ static void db_queue_event_log (evSubscrip *pevent, db_field_log *pLog)
          * replace last event if no space is left
          */
         if (*pevent->pLastLog) {
-            db_delete_field_log(*pevent->pLastLog);
-            *pevent->pLastLog = pLog;
+            if (!isInlineLog(ev_que, *pevent->pLastLog))
+                db_delete_field_log(*pevent->pLastLog);
+            set_event_log(ev_que,
+                (unsigned short) (pevent->pLastLog - ev_que->valque),
+                pevent, pLog);
         }
         pevent->nreplace++;
         /*
@@ -780,7 +859,7 @@ static void db_queue_event_log (evSubscrip *pevent, db_field_log *pLog)
     else {
         assert ( ev_que->evque[ev_que->putix] == EVENTQEMPTY );
         ev_que->evque[ev_que->putix] = pevent;
-        ev_que->valque[ev_que->putix] = pLog;
+        set_event_log(ev_que, ev_que->putix, pevent, pLog);
         pevent->pLastLog = &ev_que->valque[ev_que->putix];
         if (pevent->npend>0u) {
             ev_que->nDuplicates++;
@@ -811,10 +890,21 @@ static void db_queue_event_log (evSubscrip *pevent, db_field_log *pLog)
         /*
          * notify the event handler
          */
-        epicsEventSignal(ev_que->evUser->ppendsem);
+        event_wakeup(ev_que->evUser);
     }
 }
 
+/*
+ * Values of scalar fields are stored in the queue itself unless a filter
+ * could keep or replace the log
+ */
+static int useInlineLog (const evSubscrip *pevent)
+{
+    return pevent->useValque &&
+        ellCount(&pevent->chan->pre_chain) == 0 &&
+        ellCount(&pevent->chan->post_chain) == 0;
+}
+
 /*
  *  DB_POST_EVENTS()
  *
@@ -843,9 +933,14 @@ unsigned int    caEventMask
          */
         if ( (dbChannelField(pevent->chan) == (void *)pField || pField==NULL) &&
             (caEventMask & pevent->select)) {
-            db_field_log *pLog = db_create_event_log(pevent);
-            pLog = dbChannelRunPreChain(pevent->chan, pLog);
-            if (pLog) db_queue_event_log(pevent, pLog);
+            if (useInlineLog(pevent)) {
+                db_queue_event_log(pevent, NULL);
+            }
+            else {
+                db_field_log *pLog = db_create_event_log(pevent);
+                pLog = dbChannelRunPreChain(pevent->chan, pLog);
+                if (pLog) db_queue_event_log(pevent, pLog);
+            }
         }
     }
 
@@ -865,9 +960,14 @@ void db_post_single_event (dbEventSubscription event)
 
     dbScanLock (prec);
 
-    pLog = db_create_event_log(pevent);
-    pLog = dbChannelRunPreChain(pevent->chan, pLog);
-    if(pLog) db_queue_event_log(pevent, pLog);
+    if (useInlineLog(pevent)) {
+        db_queue_event_log(pevent, NULL);
+    }
+    else {
+        pLog = db_create_event_log(pevent);
+        pLog = dbChannelRunPreChain(pevent->chan, pLog);
+        if(pLog) db_queue_event_log(pevent, pLog);
+    }
 
     dbScanUnlock (prec);
 }
@@ -878,6 +978,7 @@ void db_post_single_event (dbEventSubscription event)
 static int event_read ( struct event_que *ev_que )
 {
     db_field_log *pfl;
+    db_field_log inlineCopy;
     void ( *user_sub ) ( void *user_arg, struct dbChannel *chan,
             int eventsRemaining, db_field_log *pfl );
 
@@ -903,7 +1004,8 @@ static int event_read ( struct event_que *ev_que )
         pfl = ev_que->valque[ev_que->getix];
         if ( pevent == &canceledEvent ) {
             ev_que->evque[ev_que->getix] = EVENTQEMPTY;
-            if (ev_que->valque[ev_que->getix]) {
+            if (ev_que->valque[ev_que->getix] &&
+                !isInlineLog(ev_que, ev_que->valque[ev_que->getix])) {
                 db_delete_field_log(ev_que->valque[ev_que->getix]);
                 ev_que->valque[ev_que->getix] = NULL;
             }
@@ -919,6 +1021,14 @@ static int event_read ( struct event_que *ev_que )
          * to be there upon wakeup)
          */
 
+        /*
+         * an inline log is reused once its entry has been removed
+         */
+        if ( isInlineLog ( ev_que, pfl ) ) {
+            inlineCopy = *pfl;
+            pfl = &inlineCopy;
+        }
+
         event_remove ( ev_que, ev_que->getix, EVENTQEMPTY );
         ev_que->getix = RNGINC ( ev_que->getix );
 
@@ -977,7 +1087,9 @@ static int event_read ( struct event_que *ev_que )
                 }
             }
         }
-        db_delete_field_log(pfl);
+        if ( pfl != &inlineCopy ) {
+            db_delete_field_log(pfl);
+        }
     }
 
     UNLOCKEVQUE (ev_que);
@@ -985,13 +1097,80 @@ static int event_read ( struct event_que *ev_que )
     return DB_EVENT_OK;
 }
 
+/*
+ * EVENT_FREE_QUEUES()
+ *
+ * Once the queues are no longer being read
+ */
+static void event_free_queues ( struct event_user *evUser )
+{
+    struct event_que    *ev_que;
+    struct event_que    *nextque;
+
+    epicsMutexDestroy(evUser->firstque.writelock);
+
+    ev_que = evUser->firstque.nextque;
+    while (ev_que) {
+        nextque = ev_que->nextque;
+        epicsMutexDestroy(ev_que->writelock);
+        freeListFree(dbevEventQueueFreeList, ev_que);
+        ev_que = nextque;
+    }
+}
+
+/*
+ * EVENT_PROCESS()
+ *
+ * Run any extra labor and drain the event queues once,
+ * returns pendexit
+ */
+static unsigned char event_process ( struct event_user *evUser )
+{
+    struct event_que * ev_que;
+    unsigned char pendexit;
+    void (*pExtraLaborSub) (void *);
+    void *pExtraLaborArg;
+
+    /*
+     * check to see if the caller has offloaded
+     * labor to this task
+     */
+    epicsMutexMustLock ( evUser->lock );
+    evUser->extraLaborBusy = TRUE;
+    if ( evUser->extra_labor && evUser->extralabor_sub ) {
+        evUser->extra_labor = FALSE;
+        pExtraLaborSub = evUser->extralabor_sub;
+        pExtraLaborArg = evUser->extralabor_arg;
+    }
+    else {
+        pExtraLaborSub = NULL;
+        pExtraLaborArg = NULL;
+    }
+    if ( pExtraLaborSub ) {
+        epicsMutexUnlock ( evUser->lock );
+        (*pExtraLaborSub)(pExtraLaborArg);
+        epicsMutexMustLock ( evUser->lock );
+    }
+    evUser->extraLaborBusy = FALSE;
+
+    for ( ev_que = &evUser->firstque; ev_que;
+            ev_que = ev_que->nextque ) {
+        epicsMutexUnlock ( evUser->lock );
+        event_read (ev_que);
+        epicsMutexMustLock ( evUser->lock );
+    }
+    pendexit = evUser->pendexit;
+    epicsMutexUnlock ( evUser->lock );
+
+    return pendexit;
+}
+
 /*
  * EVENT_TASK()
  */
 static void event_task (void *pParm)
 {
     struct event_user * const evUser = (struct event_user *) pParm;
-    struct event_que * ev_que;
     unsigned char pendexit;
 
     /* init hook */
@@ -1002,56 +1181,11 @@ static void event_task (void *pParm)
     taskwdInsert ( epicsThreadGetIdSelf(), NULL, NULL );
 
     do {
-        void (*pExtraLaborSub) (void *);
-        void *pExtraLaborArg;
         epicsEventMustWait(evUser->ppendsem);
-
-        /*
-         * check to see if the caller has offloaded
-         * labor to this task
-         */
-        epicsMutexMustLock ( evUser->lock );
-        evUser->extraLaborBusy = TRUE;
-        if ( evUser->extra_labor && evUser->extralabor_sub ) {
-            evUser->extra_labor = FALSE;
-            pExtraLaborSub = evUser->extralabor_sub;
-            pExtraLaborArg = evUser->extralabor_arg;
-        }
-        else {
-            pExtraLaborSub = NULL;
-            pExtraLaborArg = NULL;
-        }
-        if ( pExtraLaborSub ) {
-            epicsMutexUnlock ( evUser->lock );
-            (*pExtraLaborSub)(pExtraLaborArg);
-            epicsMutexMustLock ( evUser->lock );
-        }
-        evUser->extraLaborBusy = FALSE;
-
-        for ( ev_que = &evUser->firstque; ev_que;
-                ev_que = ev_que->nextque ) {
-            epicsMutexUnlock ( evUser->lock );
-            event_read (ev_que);
-            epicsMutexMustLock ( evUser->lock );
-        }
-        pendexit = evUser->pendexit;
-        epicsMutexUnlock ( evUser->lock );
-
+        pendexit = event_process(evUser);
     } while( ! pendexit );
 
-    epicsMutexDestroy(evUser->firstque.writelock);
-
-    {
-        struct event_que    *nextque;
-
-        ev_que = evUser->firstque.nextque;
-        while (ev_que) {
-            nextque = ev_que->nextque;
-            epicsMutexDestroy(ev_que->writelock);
-            freeListFree(dbevEventQueueFreeList, ev_que);
-            ev_que = nextque;
-        }
-    }
+    event_free_queues(evUser);
 
     taskwdRemove(epicsThreadGetIdSelf());
 
@@ -1087,6 +1221,12 @@ int db_start_events (
          return DB_EVENT_OK;
      }
 
+     /* a polled queue is run by db_process_events() */
+     if (evUser->wakeup_func) {
+         epicsMutexUnlock ( evUser->lock );
+         return DB_EVENT_ERROR;
+     }
+
      evUser->init_func = init_func;
      evUser->init_func_arg = init_func_arg;
      if (!taskname) {
@@ -1105,6 +1245,49 @@ int db_start_events (
      return DB_EVENT_OK;
 }
 
+/*
+ * DB_START_EVENTS_POLLED()
+ *
+ * Instead of starting an event task, wakeup_func(wakeup_arg) is
+ * called whenever there is work, and the owner must then call
+ * db_process_events() from a thread of its choosing.
+ */
+int db_start_events_polled (
+    dbEventCtx ctx, void (*wakeup_func)(void *), void *wakeup_arg )
+{
+    struct event_user * const evUser = (struct event_user *) ctx;
+
+    if (!wakeup_func)
+        return DB_EVENT_ERROR;
+
+    epicsMutexMustLock ( evUser->lock );
+    if (evUser->taskid || evUser->wakeup_func) {
+        epicsMutexUnlock ( evUser->lock );
+        return DB_EVENT_ERROR;
+    }
+    evUser->wakeup_func = wakeup_func;
+    evUser->wakeup_arg = wakeup_arg;
+    evUser->pendexit = FALSE;
+    epicsMutexUnlock ( evUser->lock );
+    return DB_EVENT_OK;
+}
+
+/*
+ * DB_PROCESS_EVENTS()
+ *
+ * Only one thread at a time may run the queues of a context,
+ * and never after db_close_events() has been called.
+ */
+void db_process_events (dbEventCtx ctx)
+{
+    struct event_user * const evUser = (struct event_user *) ctx;
+
+    /* lets db_cancel_event() know it is called from a callback */
+    evUser->taskid = epicsThreadGetIdSelf();
+    event_process(evUser);
+    evUser->taskid = 0;
+}
+
 /*
  * db_event_change_priority()
  */
@@ -1112,7 +1295,10 @@ void db_event_change_priority ( dbEventCtx ctx,
                                         unsigned epicsPriority )
 {
     struct event_user * const evUser = ( struct event_user * ) ctx;
-    epicsThreadSetPriority ( evUser->taskid, epicsPriority );
+
+    if ( ! evUser->wakeup_func ) {
+        epicsThreadSetPriority ( evUser->taskid, epicsPriority );
+    }
 }
 
 /*
@@ -1128,7 +1314,7 @@ void db_event_flow_ctrl_mode_on (dbEventCtx ctx)
     /*
      * notify the event handler task
      */
-    epicsEventSignal(evUser->ppendsem);
+    event_wakeup(evUser);
 #ifdef DEBUG
     printf("fc on %lu\n", tickGet());
 #endif
@@ -1147,7 +1333,7 @@ void db_event_flow_ctrl_mode_off (dbEventCtx ctx)
     /*
      * notify the event handler task
      */
-    epicsEventSignal (evUser->ppendsem);
+    event_wakeup(evUser);
 #ifdef DEBUG
     printf("fc off %lu\n", tickGet());
 #endif
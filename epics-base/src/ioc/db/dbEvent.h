@@ -54,6 +54,9 @@ epicsShareFunc dbEventCtx db_init_events (void);
 epicsShareFunc int db_start_events (
     dbEventCtx ctx, const char *taskname, void (*init_func)(void *),
     void *init_func_arg, unsigned osiPriority );
+epicsShareFunc int db_start_events_polled (
+    dbEventCtx ctx, void (*wakeup_func)(void *), void *wakeup_arg );
+epicsShareFunc void db_process_events (dbEventCtx ctx);
 epicsShareFunc void db_close_events (dbEventCtx ctx);
 epicsShareFunc void db_event_flow_ctrl_mode_on (dbEventCtx ctx);
 epicsShareFunc void db_event_flow_ctrl_mode_off (dbEventCtx ctx);
@@ -18,6 +18,7 @@
 #include "dbIocRegister.h"
 #include "dbLock.h"
 #include "dbNotify.h"
+#include "dbProfile.h"
 #include "dbScan.h"
 #include "dbServer.h"
 #include "dbState.h"
@@ -307,6 +308,28 @@ static void postEventCallFunc(const iocshArgBuf *args)
 static const iocshFuncDef scanpiolFuncDef = {"scanpiol",0};
 static void scanpiolCallFunc(const iocshArgBuf *args) { scanpiol();}
 
+/* dbProfile */
+static const iocshArg dbProfileArg0 = { "enable",iocshArgInt};
+static const iocshArg * const dbProfileArgs[1] = {&dbProfileArg0};
+static const iocshFuncDef dbProfileFuncDef = {"dbProfile",1,dbProfileArgs};
+static void dbProfileCallFunc(const iocshArgBuf *args)
+{ dbProfileEnable(args[0].ival);}
+
+/* dbProfileReport */
+static const iocshArg dbProfileReportArg0 = { "count",iocshArgInt};
+static const iocshArg dbProfileReportArg1 = { "sort by",iocshArgString};
+static const iocshArg * const dbProfileReportArgs[2] =
+    {&dbProfileReportArg0,&dbProfileReportArg1};
+static const iocshFuncDef dbProfileReportFuncDef =
+    {"dbProfileReport",2,dbProfileReportArgs};
+static void dbProfileReportCallFunc(const iocshArgBuf *args)
+{ dbProfileReport(args[0].ival, args[1].sval);}
+
+/* dbProfileReset */
+static const iocshFuncDef dbProfileResetFuncDef = {"dbProfileReset",0};
+static void dbProfileResetCallFunc(const iocshArgBuf *args)
+{ dbProfileReset();}
+
 /* callbackSetQueueSize */
 static const iocshArg callbackSetQueueSizeArg0 = { "bufsize",iocshArgInt};
 static const iocshArg * const callbackSetQueueSizeArgs[1] =
@@ -427,6 +450,10 @@ void dbIocRegister(void)
     iocshRegister(&postEventFuncDef,postEventCallFunc);
     iocshRegister(&scanpiolFuncDef,scanpiolCallFunc);
 
+    iocshRegister(&dbProfileFuncDef,dbProfileCallFunc);
+    iocshRegister(&dbProfileReportFuncDef,dbProfileReportCallFunc);
+    iocshRegister(&dbProfileResetFuncDef,dbProfileResetCallFunc);
+
     iocshRegister(&callbackSetQueueSizeFuncDef,callbackSetQueueSizeCallFunc);
     iocshRegister(&callbackParallelThreadsFuncDef,callbackParallelThreadsCallFunc);
 
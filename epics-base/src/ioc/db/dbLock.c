@@ -35,6 +35,12 @@ solution:
 2) lockSetModifyLock is locked whenever any fields in lockSet are being accessed
 or lockRecord.plockSet is being accessed.
 
+4) A thread reading a scalar field with dbLockReadBegin/dbLockReadEnd
+does not take any lock. Each lockSet has a readSeq which is given a new
+value whenever the set leaves lockSetStateFree. A read is only valid if
+the set was free before it started and is still free with the same readSeq
+when it ends, so nothing in the set was modified in between.
+
 NOTE:
 
 dblsr may crash if executed while lock sets are being modified.
@@ -51,6 +57,7 @@ since this will delay all other threads.
 #include "dbDefs.h"
 #include "ellLib.h"
 #include "epicsAssert.h"
+#include "epicsAtomic.h"
 #include "epicsExit.h"
 #include "epicsMutex.h"
 #include "epicsPrint.h"
@@ -66,11 +73,16 @@ since this will delay all other threads.
 #include "dbFldTypes.h"
 #include "dbLock.h"
 #include "dbStaticLib.h"
+#include "epicsExport.h"
 #include "link.h"
+#include "special.h"
 
 
 static int dbLockIsInitialized = FALSE;
 
+epicsShareDef int dbLockFreeReads = 1;
+epicsExportAddress(int, dbLockFreeReads);
+
 typedef enum {
     listTypeScanLock = 0,
     listTypeRecordLock = 1,
@@ -83,6 +95,7 @@ static ELLLIST lockSetList[nlistType];
 static epicsMutexId globalLock;
 static epicsMutexId lockSetModifyLock;
 static unsigned long id = 0;
+static unsigned long readSeq = 0;
 static char *msstring[4]={"NMS","MS","MSI","MSS"};
 
 typedef enum {
@@ -101,6 +114,7 @@ typedef struct lockSet {
     int			nRecursion;
     int			nWaiting;
     int                 trace; /*For field TPRO*/
+    unsigned long       readSeq; /*Changed when state leaves Free*/
 } lockSet;
 
 /* dbCommon.LSET is a plockRecord */
@@ -111,6 +125,15 @@ typedef struct lockRecord {
 } lockRecord;
 
 /*private routines */
+/*Caller holds lockSetModifyLock*/
+static void newReadSeq(lockSet *plockSet)
+{
+    if(++readSeq == 0) readSeq = 1;
+    plockSet->readSeq = readSeq;
+    /*Readers must see the new value before any record is modified*/
+    epicsAtomicWriteMemoryBarrier();
+}
+
 static void dbLockInitialize(void)
 {
     int i;
@@ -146,6 +169,7 @@ static lockSet * allocLockSet(
     plockSet->precord = 0;
     plockSet->nRecursion = 0;
     plockSet->nWaiting = 0;
+    newReadSeq(plockSet);
     ellAdd(&plockSet->lockRecordList,&plockRecord->node);
     ellAdd(&lockSetList[type],&plockSet->node);
     return(plockSet);
@@ -209,6 +233,7 @@ void dbLockSetRecordLock(dbCommon *precord)
         return;
     }
     assert(plockSet->thread_id!=epicsThreadGetIdSelf());
+    newReadSeq(plockSet);
     plockSet->state = lockSetStateRecordLock;
     /*Wait until owner finishes and all waiting get to change state*/
     while(1) {
@@ -252,6 +277,7 @@ void dbScanLock(dbCommon *precord)
             case lockSetStateFree:
                 status = epicsMutexTryLock(plockSet->lock);
                 assert(status==epicsMutexLockOK);
+                newReadSeq(plockSet);
                 plockSet->nRecursion = 1;
                 plockSet->thread_id = idSelf;
                 plockSet->precord = precord;
@@ -308,6 +334,8 @@ void dbScanUnlock(dbCommon *precord)
     assert(plockSet->nRecursion>=1);
     plockSet->nRecursion -= 1;
     if(plockSet->nRecursion==0) {
+        /*Record changes must be visible before the set can become free*/
+        epicsAtomicWriteMemoryBarrier();
         plockSet->thread_id = 0;
         plockSet->precord = 0;
         if((plockSet->state == lockSetStateScanLock)
@@ -318,6 +346,35 @@ void dbScanUnlock(dbCommon *precord)
     return;
 }
 
+unsigned long dbLockReadBegin(const DBADDR *paddr)
+{
+    lockRecord  *plockRecord = paddr->precord->lset;
+    lockSet     *plockSet;
+    unsigned long seq;
+
+    if(!dbLockFreeReads || !plockRecord) return 0;
+    /*Only scalar fields that are stored in the record*/
+    if(paddr->no_elements!=1 || paddr->special==SPC_DBADDR
+    || paddr->field_type>DBF_DEVICE) return 0;
+    plockSet = plockRecord->plockSet;
+    if(!plockSet) return 0;
+    seq = plockSet->readSeq;
+    epicsAtomicReadMemoryBarrier();
+    if(plockSet->state!=lockSetStateFree) return 0;
+    return seq;
+}
+
+int dbLockReadEnd(const DBADDR *paddr, unsigned long seq)
+{
+    lockRecord  *plockRecord = paddr->precord->lset;
+    lockSet     *plockSet;
+
+    epicsAtomicReadMemoryBarrier();
+    plockSet = plockRecord->plockSet;
+    return plockSet && plockSet->state==lockSetStateFree
+        && plockSet->readSeq==seq;
+}
+
 static lockRecord *lockRecordAlloc;
 
 void dbLockInitRecords(dbBase *pdbbase)
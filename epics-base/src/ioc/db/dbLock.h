@@ -21,12 +21,24 @@ extern "C" {
 
 struct dbCommon;
 struct dbBase;
+struct dbAddr;
 
 epicsShareFunc void dbScanLock(struct dbCommon *precord);
 epicsShareFunc void dbScanUnlock(struct dbCommon *precord);
 epicsShareFunc unsigned long dbLockGetLockId(
     struct dbCommon *precord);
 
+/* Reading a scalar field without the lock:
+ *     seq = dbLockReadBegin(paddr);
+ *     if (seq) { read the field; if (dbLockReadEnd(paddr, seq)) done; }
+ *     otherwise take the lock and read it again.
+ * dbLockReadBegin returns 0 if this isn't possible.
+ */
+epicsShareExtern int dbLockFreeReads;
+epicsShareFunc unsigned long dbLockReadBegin(const struct dbAddr *paddr);
+epicsShareFunc int dbLockReadEnd(const struct dbAddr *paddr,
+    unsigned long seq);
+
 epicsShareFunc void dbLockInitRecords(struct dbBase *pdbbase);
 epicsShareFunc void dbLockCleanupRecords(struct dbBase *pdbbase);
 epicsShareFunc void dbLockSetMerge(
@@ -0,0 +1,375 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+/* dbProfile.c */
+/* record processing time profiler */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ellLib.h"
+#include "epicsAtomic.h"
+#include "epicsMutex.h"
+#include "epicsStdio.h"
+#include "epicsString.h"
+#include "epicsThread.h"
+#include "epicsTime.h"
+#include "errlog.h"
+
+#define epicsExportSharedSymbols
+#include "dbAccessDefs.h"
+#include "dbCommon.h"
+#include "dbLock.h"
+#include "dbProfile.h"
+#include "dbStaticLib.h"
+
+/* The profiles are found through a hash table keyed by the record address,
+ * created when the first record is profiled. Profiles are added with
+ * profileLock held and only freed by dbProfileCleanup(), so they can be
+ * found without taking the lock.
+ */
+
+typedef struct dbProfile {
+    ELLNODE             node;
+    struct dbProfile    *next;      /* in the same hash bucket */
+    struct dbCommon     *precord;
+    unsigned long       count;
+    double              total;
+    double              max;
+    unsigned long       waits;
+    double              wait;
+    epicsTimeStamp      asyncStart;
+    int                 asyncActive;
+} dbProfile;
+
+/* A copy of the data for reporting */
+typedef struct profileEntry {
+    const char          *name;
+    unsigned long       count;
+    double              total;
+    double              max;
+    unsigned long       waits;
+    double              wait;
+} profileEntry;
+
+epicsShareDef volatile int dbProfileEnabled = 0;
+
+static ELLLIST profileList = ELLLIST_INIT;
+static epicsMutexId profileLock;
+static dbProfile **profileTable;
+static unsigned int profileMask;
+
+static void profileOnce(void *arg)
+{
+    profileLock = epicsMutexMustCreate();
+}
+
+static void profileInit(void)
+{
+    static epicsThreadOnceId onceId = EPICS_THREAD_ONCE_INIT;
+
+    epicsThreadOnce(&onceId, profileOnce, NULL);
+}
+
+void dbProfileEnable(int enable)
+{
+    profileInit();
+    dbProfileEnabled = enable;
+}
+
+static unsigned int profileHash(const struct dbCommon *precord)
+{
+    size_t h = (size_t) precord;
+
+    h ^= h >> 16;
+    return (unsigned int) h * 0x45d9f3bu;
+}
+
+/* Returns the profile for precord, or NULL */
+static dbProfile * profileFind(const struct dbCommon *precord)
+{
+    dbProfile **ptable = (dbProfile **)
+        epicsAtomicGetPtrT((EpicsAtomicPtrT *) &profileTable);
+    dbProfile *pprf;
+
+    if (!ptable) return NULL;
+    epicsAtomicReadMemoryBarrier();
+    pprf = (dbProfile *) epicsAtomicGetPtrT((EpicsAtomicPtrT *)
+        &ptable[profileHash(precord) & profileMask]);
+    while (pprf && pprf->precord != precord) {
+        epicsAtomicReadMemoryBarrier();
+        pprf = pprf->next;
+    }
+    epicsAtomicReadMemoryBarrier();
+    return pprf;
+}
+
+/* One bucket per record, caller holds profileLock */
+static void profileTableCreate(void)
+{
+    DBENTRY dbentry;
+    unsigned int size = 256;
+    long nRecords = 0;
+    long status;
+
+    dbInitEntry(pdbbase, &dbentry);
+    for (status = dbFirstRecordType(&dbentry); !status;
+         status = dbNextRecordType(&dbentry))
+        nRecords += dbGetNRecords(&dbentry);
+    dbFinishEntry(&dbentry);
+
+    while (size < nRecords && size < (1u << 20))
+        size <<= 1;
+    profileMask = size - 1;
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetPtrT((EpicsAtomicPtrT *) &profileTable,
+        calloc(size, sizeof(dbProfile *)));
+}
+
+static dbProfile * profileAdd(struct dbCommon *precord)
+{
+    dbProfile *pprf;
+    unsigned int i;
+
+    profileInit();
+    epicsMutexMustLock(profileLock);
+    if (!profileTable)
+        profileTableCreate();
+    pprf = profileFind(precord);
+    if (!pprf && profileTable) {
+        pprf = calloc(1, sizeof(dbProfile));
+        if (pprf) {
+            i = profileHash(precord) & profileMask;
+            pprf->precord = precord;
+            pprf->next = profileTable[i];
+            ellAdd(&profileList, &pprf->node);
+            epicsAtomicWriteMemoryBarrier();
+            epicsAtomicSetPtrT((EpicsAtomicPtrT *) &profileTable[i], pprf);
+        }
+    }
+    epicsMutexUnlock(profileLock);
+    return pprf;
+}
+
+void dbProfileProcessed(struct dbCommon *precord, const epicsTimeStamp *start)
+{
+    dbProfile *pprf = profileFind(precord);
+    epicsTimeStamp now;
+    double time;
+
+    epicsTimeGetCurrent(&now);
+    time = epicsTimeDiffInSeconds(&now, start);
+    if (time < 0.0) time = 0.0;
+
+    if (!pprf) {
+        pprf = profileAdd(precord);
+        if (!pprf) return;
+    }
+
+    /* An asynchronous record is processed twice per cycle, count it once */
+    if (!precord->pact)
+        pprf->count++;
+    pprf->total += time;
+    if (time > pprf->max)
+        pprf->max = time;
+    if (precord->pact) {
+        pprf->asyncStart = now;
+        pprf->asyncActive = TRUE;
+    }
+}
+
+void dbProfileAsyncDone(struct dbCommon *precord)
+{
+    dbProfile *pprf = profileFind(precord);
+    epicsTimeStamp now;
+    double wait;
+
+    if (!pprf || !pprf->asyncActive) return;
+
+    epicsTimeGetCurrent(&now);
+    wait = epicsTimeDiffInSeconds(&now, &pprf->asyncStart);
+    if (wait > 0.0)
+        pprf->wait += wait;
+    pprf->waits++;
+    pprf->asyncActive = FALSE;
+}
+
+/* Returns an array of the profiles, which can then be used without
+ * holding profileLock. Profiles are only freed by dbProfileCleanup().
+ */
+static dbProfile ** profileSnapshot(int *pcount)
+{
+    dbProfile **papprf;
+    ELLNODE *node;
+    int n = 0;
+
+    profileInit();
+    epicsMutexMustLock(profileLock);
+    papprf = calloc(ellCount(&profileList) + 1, sizeof(dbProfile *));
+    if (papprf) {
+        for (node = ellFirst(&profileList); node; node = ellNext(node))
+            papprf[n++] = CONTAINER(node, dbProfile, node);
+    }
+    epicsMutexUnlock(profileLock);
+    *pcount = n;
+    return papprf;
+}
+
+void dbProfileReset(void)
+{
+    dbProfile **papprf;
+    int i, n;
+
+    papprf = profileSnapshot(&n);
+    if (!papprf) return;
+
+    for (i = 0; i < n; i++) {
+        dbProfile *pprf = papprf[i];
+
+        dbScanLock(pprf->precord);
+        pprf->count = 0;
+        pprf->total = pprf->max = 0.0;
+        pprf->waits = 0;
+        pprf->wait = 0.0;
+        dbScanUnlock(pprf->precord);
+    }
+    free(papprf);
+}
+
+static int compareTotal(const void *a, const void *b)
+{
+    const profileEntry *pa = (const profileEntry *)a;
+    const profileEntry *pb = (const profileEntry *)b;
+
+    return (pa->total < pb->total) - (pa->total > pb->total);
+}
+
+static int compareMax(const void *a, const void *b)
+{
+    const profileEntry *pa = (const profileEntry *)a;
+    const profileEntry *pb = (const profileEntry *)b;
+
+    return (pa->max < pb->max) - (pa->max > pb->max);
+}
+
+static int compareMean(const void *a, const void *b)
+{
+    const profileEntry *pa = (const profileEntry *)a;
+    const profileEntry *pb = (const profileEntry *)b;
+    double ma = pa->count ? pa->total / pa->count : 0.0;
+    double mb = pb->count ? pb->total / pb->count : 0.0;
+
+    return (ma < mb) - (ma > mb);
+}
+
+static int compareCount(const void *a, const void *b)
+{
+    const profileEntry *pa = (const profileEntry *)a;
+    const profileEntry *pb = (const profileEntry *)b;
+
+    return (pa->count < pb->count) - (pa->count > pb->count);
+}
+
+static int compareWait(const void *a, const void *b)
+{
+    const profileEntry *pa = (const profileEntry *)a;
+    const profileEntry *pb = (const profileEntry *)b;
+
+    return (pa->wait < pb->wait) - (pa->wait > pb->wait);
+}
+
+static const struct {
+    const char *name;
+    int (*compare)(const void *, const void *);
+} sortKeys[] = {
+    {"total", compareTotal},
+    {"max", compareMax},
+    {"mean", compareMean},
+    {"count", compareCount},
+    {"wait", compareWait},
+};
+
+long dbProfileReport(int count, const char *sort)
+{
+    int (*compare)(const void *, const void *) = compareTotal;
+    const char *key = "total";
+    dbProfile **papprf;
+    profileEntry *pentries;
+    int i, n;
+
+    if (sort && *sort) {
+        for (i = 0; i < NELEMENTS(sortKeys); i++) {
+            if (!epicsStrCaseCmp(sort, sortKeys[i].name))
+                break;
+        }
+        if (i == NELEMENTS(sortKeys)) {
+            printf("dbProfileReport: Unknown sort key '%s', "
+                "use total, max, mean, count or wait\n", sort);
+            return -1;
+        }
+        key = sortKeys[i].name;
+        compare = sortKeys[i].compare;
+    }
+    if (count <= 0) count = 20;
+
+    papprf = profileSnapshot(&n);
+    if (!papprf) return -1;
+    pentries = calloc(n + 1, sizeof(profileEntry));
+    if (!pentries) {
+        free(papprf);
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        dbProfile *pprf = papprf[i];
+        profileEntry *pentry = &pentries[i];
+
+        dbScanLock(pprf->precord);
+        pentry->name = pprf->precord->name;
+        pentry->count = pprf->count;
+        pentry->total = pprf->total;
+        pentry->max = pprf->max;
+        pentry->waits = pprf->waits;
+        pentry->wait = pprf->wait;
+        dbScanUnlock(pprf->precord);
+    }
+    free(papprf);
+
+    qsort(pentries, n, sizeof(profileEntry), compare);
+
+    /* A record's times include the records it processed through links,
+     * so they are not added up.
+     */
+    printf("Record processing profile (%s), %d records, sorted by %s.\n"
+        "Times are inclusive of records processed synchronously "
+        "through links:\n", dbProfileEnabled ? "enabled" : "disabled",
+        n, key);
+    printf("    %-28s %10s %11s %10s %10s %8s %11s\n", "Record",
+        "Count", "Total(ms)", "Mean(us)", "Max(us)", "Waits", "Wait(ms)");
+    for (i = 0; i < n && i < count; i++) {
+        profileEntry *pentry = &pentries[i];
+
+        printf("    %-28s %10lu %11.3f %10.1f %10.1f %8lu %11.3f\n",
+            pentry->name, pentry->count, pentry->total * 1e3,
+            pentry->count ? pentry->total * 1e6 / pentry->count : 0.0,
+            pentry->max * 1e6, pentry->waits, pentry->wait * 1e3);
+    }
+    free(pentries);
+    return 0;
+}
+
+void dbProfileCleanup(void)
+{
+    ELLNODE *node;
+
+    dbProfileEnabled = 0;
+    profileInit();
+    epicsMutexMustLock(profileLock);
+    while ((node = ellGet(&profileList)))
+        free(CONTAINER(node, dbProfile, node));
+    free(profileTable);
+    profileTable = NULL;
+    epicsMutexUnlock(profileLock);
+}
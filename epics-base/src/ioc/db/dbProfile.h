@@ -0,0 +1,73 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#ifndef INCdbProfileH
+#define INCdbProfileH
+
+#include "epicsTime.h"
+#include "shareLib.h"
+
+/** @file dbProfile.h
+ * @brief Record processing time profiler
+ *
+ * When enabled, dbProcess() times the record support process() routine of
+ * every record it processes and accumulates a per-record count, total and
+ * maximum time. Times are inclusive of any records processed synchronously
+ * through links. For asynchronous records the time from process() returning
+ * with PACT set until the record's forward link is processed is accumulated
+ * separately as the device support wait time.
+ *
+ * The count is of completed processing cycles. An asynchronous record is
+ * counted once, when process() returns with PACT clear, and its total
+ * includes the time spent in both of its process() calls.
+ *
+ * The profile data is only updated with the record locked.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dbCommon;
+
+/** @brief Non-zero while profiling is enabled; use dbProfileEnable() */
+epicsShareExtern volatile int dbProfileEnabled;
+
+/** @brief Start or stop profiling.
+ *
+ * <em>Also provided as an IOC Shell command.</em>
+ *
+ * @param enable Zero to stop, non-zero to start.
+ */
+epicsShareFunc void dbProfileEnable(int enable);
+
+/** @brief Discard the data accumulated so far.
+ *
+ * <em>Also provided as an IOC Shell command.</em>
+ */
+epicsShareFunc void dbProfileReset(void);
+
+/** @brief Print the most expensive records.
+ *
+ * <em>Also provided as an IOC Shell command.</em>
+ *
+ * @param count Number of records to show, 0 shows 20.
+ * @param sort One of "total" (default), "max", "mean", "count" or "wait".
+ */
+epicsShareFunc long dbProfileReport(int count, const char *sort);
+
+/** @brief Free all profile data, called by iocShutdown(). */
+epicsShareFunc void dbProfileCleanup(void);
+
+/* Used by dbProcess() and recGblFwdLink() */
+epicsShareFunc void dbProfileProcessed(struct dbCommon *precord,
+    const epicsTimeStamp *start);
+epicsShareFunc void dbProfileAsyncDone(struct dbCommon *precord);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCdbProfileH */
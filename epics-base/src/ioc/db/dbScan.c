@@ -24,6 +24,7 @@
 #include "cantProceed.h"
 #include "dbDefs.h"
 #include "ellLib.h"
+#include "epicsAtomic.h"
 #include "epicsEvent.h"
 #include "epicsExit.h"
 #include "epicsInterrupt.h"
@@ -48,6 +49,7 @@
 #include "dbScan.h"
 #include "dbStaticLib.h"
 #include "devSup.h"
+#include "epicsExport.h"
 #include "link.h"
 #include "recGbl.h"
 
@@ -87,6 +89,35 @@ typedef struct scan_element{
 
 #define OVERRUN_REPORT_DELAY 10.0   /* Time between initial reports */
 #define OVERRUN_REPORT_MAX 3600.0   /* Maximum time between reports */
+
+/* Number of threads sharing each periodic scan list, 0 = serial scanning.
+ * Negative values are relative to the number of CPUs.
+ */
+epicsShareDef int scanParallelThreads = 0;
+epicsExportAddress(int, scanParallelThreads);
+
+/* Spread the processing of each periodic list evenly over its period */
+epicsShareDef int scanPhaseStagger = 0;
+epicsExportAddress(int, scanPhaseStagger);
+
+/* Time each record of the periodic lists to find the slowest one */
+epicsShareDef int scanStatsSlowest = 0;
+epicsExportAddress(int, scanStatsSlowest);
+
+static double scanQuantum;
+
+/* Parallel mode: the list is partitioned by lock set each pass */
+typedef struct scan_work {
+    scan_element        *pse;
+    unsigned long       lockId;
+    size_t              order;
+} scan_work;
+
+typedef struct scan_helper {
+    struct periodic_scan_list *ppsl;
+    epicsEventId        wakeEvent;
+} scan_helper;
+
 typedef struct periodic_scan_list {
     scan_list           scan_list;
     double              period;
@@ -94,6 +125,24 @@ typedef struct periodic_scan_list {
     unsigned long       overruns;
     volatile enum ctl   scanCtl;
     epicsEventId        loopEvent;
+    epicsEventId        paceEvent;  /* waited on by scanPace() */
+    /* Parallel mode */
+    int                 nHelpers;
+    scan_helper         *helpers;
+    epicsEventId        doneEvent;
+    epicsTimeStamp      passStart;
+    scan_work           *work;
+    size_t              *partStart; /* nParts+1 indices into work */
+    size_t              workSize;
+    size_t              nParts;
+    size_t              nextPart;
+    int                 nBusy;
+    /* Statistics, protected by scan_list.lock */
+    struct dbCommon     *passSlowest;
+    double              passSlowestTime;
+    double              total;
+    scanStats           stats;
+    IOSCANPVT           statsScan;
 } periodic_scan_list;
 
 static int nPeriodic = 0;
@@ -138,6 +187,9 @@ static epicsMutexId ioscan_lock;
 static void onceTask(void *);
 static void initOnce(void);
 static void periodicTask(void *arg);
+static void scanParallel(periodic_scan_list *ppsl);
+static void scanPartitions(periodic_scan_list *ppsl);
+static void scanHelperStop(periodic_scan_list *ppsl);
 static void initPeriodic(void);
 static void deletePeriodic(void);
 static void spawnPeriodic(int ind);
@@ -146,7 +198,7 @@ static void ioscanInit(void);
 static void ioscanCallback(epicsCallback *pcallback);
 static void ioscanDestroy(void);
 static void printList(scan_list *psl, char *message);
-static void scanList(scan_list *psl);
+static void scanList(scan_list *psl, periodic_scan_list *ppsl);
 static void buildScanLists(void);
 static void addToList(struct dbCommon *precord, scan_list *psl);
 static void deleteFromList(struct dbCommon *precord, scan_list *psl);
@@ -165,6 +217,7 @@ void scanStop(void)
 
         if (!ppsl) continue;
         ppsl->scanCtl = ctlExit;
+        epicsEventSignal(ppsl->paceEvent);
         epicsEventSignal(ppsl->loopEvent);
         epicsEventWait(startStopEvent);
     }
@@ -372,10 +425,51 @@ double scanPeriod(int scan) {
     return ppsl ? ppsl->period : 0.0;
 }
 
+static periodic_scan_list *scanStatsList(int scan)
+{
+    scan -= SCAN_1ST_PERIODIC;
+    if (scan < 0 || scan >= nPeriodic || !papPeriodic)
+        return NULL;
+    return papPeriodic[scan];
+}
+
+int scanStatsGet(int scan, scanStats *pstats)
+{
+    periodic_scan_list *ppsl = scanStatsList(scan);
+
+    if (!ppsl) return -1;
+
+    epicsMutexMustLock(ppsl->scan_list.lock);
+    *pstats = ppsl->stats;
+    epicsMutexUnlock(ppsl->scan_list.lock);
+    return 0;
+}
+
+int scanStatsReset(int scan)
+{
+    periodic_scan_list *ppsl = scanStatsList(scan);
+
+    if (!ppsl) return -1;
+
+    epicsMutexMustLock(ppsl->scan_list.lock);
+    memset(&ppsl->stats, 0, sizeof(scanStats));
+    ppsl->stats.period = ppsl->period;
+    ppsl->total = 0.0;
+    epicsMutexUnlock(ppsl->scan_list.lock);
+    return 0;
+}
+
+IOSCANPVT scanStatsIoScan(int scan)
+{
+    periodic_scan_list *ppsl = scanStatsList(scan);
+
+    return ppsl ? ppsl->statsScan : NULL;
+}
+
 int scanppl(double period)      /* print periodic scan list(s) */
 {
     dbMenu *pmenu = dbFindMenu(pdbbase, "menuScan");
-    char message[80];
+    char message[120];
     int i;
 
     if (!pmenu || !papPeriodic) {
@@ -397,8 +491,13 @@ int scanppl(double period)      /* print periodic scan list(s) */
             (fabs(period - ppsl->period) > 0.05))
             continue;
 
-        sprintf(message, "Records with SCAN = '%s' (%lu over-runs):",
-            ppsl->name, ppsl->overruns);
+        if (ppsl->nHelpers)
+            sprintf(message, "Records with SCAN = '%s' (%lu over-runs, "
+                "%lu lock sets on %d threads):", ppsl->name, ppsl->overruns,
+                (unsigned long)ppsl->nParts, ppsl->nHelpers + 1);
+        else
+            sprintf(message, "Records with SCAN = '%s' (%lu over-runs):",
+                ppsl->name, ppsl->overruns);
         printList(&ppsl->scan_list, message);
     }
     return 0;
@@ -453,7 +552,7 @@ static void eventCallback(epicsCallback *pcallback)
     scan_list *psl;
 
     callbackGetUser(psl, pcallback);
-    scanList(psl);
+    scanList(psl, NULL);
 }
 
 static void eventOnce(void *arg)
@@ -692,6 +791,79 @@ static void initOnce(void)
     epicsEventWait(startStopEvent);
 }
 
+/* Wait until the index'th of count equal steps through the period,
+ * returns TRUE if it had to wait.
+ */
+static int scanPace(periodic_scan_list *ppsl, size_t index, size_t count)
+{
+    epicsTimeStamp due, now;
+    double delay;
+
+    if (index == 0 || index >= count || ppsl->scanCtl != ctlRun)
+        return FALSE;
+
+    due = ppsl->passStart;
+    epicsTimeAddSeconds(&due, ppsl->period * index / count);
+    epicsTimeGetCurrent(&now);
+    delay = epicsTimeDiffInSeconds(&due, &now);
+    if (delay < scanQuantum)
+        return FALSE;
+
+    /* periodicTask and its helpers may all be pacing */
+    epicsEventWaitWithTimeout(ppsl->paceEvent, delay);
+    if (ppsl->scanCtl == ctlExit)   /* pass it on to the next one */
+        epicsEventSignal(ppsl->paceEvent);
+    return TRUE;
+}
+
+/* Remember the slowest record of the current pass */
+static void scanNoteSlowest(periodic_scan_list *ppsl,
+    struct dbCommon *precord, double time)
+{
+    epicsMutexMustLock(ppsl->scan_list.lock);
+    if (time > ppsl->passSlowestTime) {
+        ppsl->passSlowest = precord;
+        ppsl->passSlowestTime = time;
+    }
+    epicsMutexUnlock(ppsl->scan_list.lock);
+}
+
+static void scanStatsUpdate(periodic_scan_list *ppsl,
+    const epicsTimeStamp *end, int overrun)
+{
+    scanStats *pstats = &ppsl->stats;
+    double pass = epicsTimeDiffInSeconds(end, &ppsl->passStart);
+    int bin;
+
+    if (pass < 0.0) pass = 0.0;
+    bin = (int)(pass * (SCAN_STATS_BINS - 1) / ppsl->period);
+    if (bin >= SCAN_STATS_BINS) bin = SCAN_STATS_BINS - 1;
+
+    epicsMutexMustLock(ppsl->scan_list.lock);
+    pstats->last = pass;
+    pstats->passes++;
+    ppsl->total += pass;
+    pstats->mean = ppsl->total / pstats->passes;
+    if (pass > pstats->max)
+        pstats->max = pass;
+    if (overrun)
+        pstats->overruns++;
+    pstats->histogram[bin]++;
+    if (ppsl->passSlowest) {
+        strcpy(pstats->slowest, ppsl->passSlowest->name);
+        pstats->slowestTime = ppsl->passSlowestTime;
+    }
+    else {
+        pstats->slowest[0] = '\0';
+        pstats->slowestTime = 0.0;
+    }
+    ppsl->passSlowest = NULL;
+    ppsl->passSlowestTime = 0.0;
+    epicsMutexUnlock(ppsl->scan_list.lock);
+
+    scanIoRequest(ppsl->statsScan);
+}
+
 static void periodicTask(void *arg)
 {
     periodic_scan_list *ppsl = (periodic_scan_list *)arg;
@@ -712,13 +884,22 @@ static void periodicTask(void *arg)
     while (ppsl->scanCtl != ctlExit) {
         double delay;
         epicsTimeStamp now;
-
-        if (ppsl->scanCtl == ctlRun)
-            scanList(&ppsl->scan_list);
+        int scanned = FALSE;
+
+        if (ppsl->scanCtl == ctlRun) {
+            epicsTimeGetCurrent(&ppsl->passStart);
+            if (ppsl->nHelpers)
+                scanParallel(ppsl);
+            else
+                scanList(&ppsl->scan_list, ppsl);
+            scanned = TRUE;
+        }
 
         epicsTimeAddSeconds(&next, ppsl->period);
         epicsTimeGetCurrent(&now);
         delay = epicsTimeDiffInSeconds(&next, &now);
+        if (scanned)
+            scanStatsUpdate(ppsl, &now, delay <= 0.0);
         if (delay <= 0.0) {
             if (overtime == 0.0) {
                 overtime = over_min = over_max = -delay;
@@ -759,21 +940,208 @@ static void periodicTask(void *arg)
         epicsEventWaitWithTimeout(ppsl->loopEvent, delay);
     }
 
+    scanHelperStop(ppsl);
     taskwdRemove(0);
     epicsEventSignal(startStopEvent);
 }
 
+static void scanHelperTask(void *arg)
+{
+    scan_helper *psh = (scan_helper *)arg;
+    periodic_scan_list *ppsl = psh->ppsl;
+
+    taskwdInsert(0, NULL, NULL);
+
+    while (TRUE) {
+        epicsEventMustWait(psh->wakeEvent);
+        if (ppsl->scanCtl == ctlExit) break;
+
+        scanPartitions(ppsl);
+        if (epicsAtomicDecrIntT(&ppsl->nBusy) == 0)
+            epicsEventSignal(ppsl->doneEvent);
+    }
+
+    taskwdRemove(0);
+    epicsEventSignal(ppsl->doneEvent);
+}
+
+static void scanHelperStart(periodic_scan_list *ppsl)
+{
+    unsigned int priority = epicsThreadGetPrioritySelf();
+    int i;
+
+    ppsl->doneEvent = epicsEventMustCreate(epicsEventEmpty);
+    ppsl->helpers = dbCalloc(ppsl->nHelpers, sizeof(scan_helper));
+    for (i = 0; i < ppsl->nHelpers; i++) {
+        scan_helper *psh = &ppsl->helpers[i];
+        char taskName[40];
+
+        psh->ppsl = ppsl;
+        psh->wakeEvent = epicsEventMustCreate(epicsEventEmpty);
+        sprintf(taskName, "scan-%g-%d", ppsl->period, i + 1);
+        if (!epicsThreadCreate(taskName, priority,
+                epicsThreadGetStackSize(epicsThreadStackBig),
+                scanHelperTask, psh)) {
+            errlogPrintf("dbScan: Can't create helper thread '%s', "
+                "scanning '%s' with %d threads\n", taskName, ppsl->name, i + 1);
+            epicsEventDestroy(psh->wakeEvent);
+            ppsl->nHelpers = i;
+            break;
+        }
+    }
+}
+
+static void scanHelperStop(periodic_scan_list *ppsl)
+{
+    int i;
+
+    if (!ppsl->helpers) return;
+
+    for (i = 0; i < ppsl->nHelpers; i++) {
+        epicsEventSignal(ppsl->helpers[i].wakeEvent);
+        epicsEventWait(ppsl->doneEvent);
+    }
+}
+
+static int scanWorkCompare(const void *a, const void *b)
+{
+    const scan_work *pa = (const scan_work *)a;
+    const scan_work *pb = (const scan_work *)b;
+
+    if (pa->lockId != pb->lockId)
+        return pa->lockId < pb->lockId ? -1 : 1;
+    return pa->order < pb->order ? -1 : pa->order > pb->order;
+}
+
+/* Snapshot the scan list and group its elements by lock set, keeping the
+ * PHAS order inside each group. Records joined by database links always
+ * share a lock set, so groups can be processed concurrently.
+ */
+static void partitionList(periodic_scan_list *ppsl)
+{
+    scan_list *psl = &ppsl->scan_list;
+    scan_element *pse;
+    size_t count, i, n = 0;
+
+    epicsMutexMustLock(psl->lock);
+    count = ellCount(&psl->list);
+    if (count > ppsl->workSize) {
+        free(ppsl->work);
+        free(ppsl->partStart);
+        ppsl->workSize = count + count / 4;
+        ppsl->work = dbCalloc(ppsl->workSize, sizeof(scan_work));
+        ppsl->partStart = dbCalloc(ppsl->workSize + 1, sizeof(size_t));
+    }
+    for (pse = (scan_element *)ellFirst(&psl->list); pse;
+         pse = (scan_element *)ellNext(&pse->node)) {
+        ppsl->work[n].pse = pse;
+        ppsl->work[n].order = n;
+        n++;
+    }
+    psl->modified = FALSE;
+    epicsMutexUnlock(psl->lock);
+
+    ppsl->nParts = 0;
+    if (n == 0) return;
+
+    for (i = 0; i < n; i++)
+        ppsl->work[i].lockId = dbLockGetLockId(ppsl->work[i].pse->precord);
+    qsort(ppsl->work, n, sizeof(scan_work), scanWorkCompare);
+
+    for (i = 0; i < n; i++) {
+        if (i == 0 || ppsl->work[i].lockId != ppsl->work[i - 1].lockId)
+            ppsl->partStart[ppsl->nParts++] = i;
+    }
+    ppsl->partStart[ppsl->nParts] = n;
+}
+
+static void scanPartitions(periodic_scan_list *ppsl)
+{
+    scan_list *psl = &ppsl->scan_list;
+    struct dbCommon *pslowest = NULL;
+    double slowestTime = 0.0;
+    int timeRecords = scanStatsSlowest;
+    size_t part;
+
+    while ((part = epicsAtomicIncrSizeT(&ppsl->nextPart) - 1) < ppsl->nParts) {
+        epicsTimeStamp before, after;
+        size_t i;
+
+        if (scanPhaseStagger)
+            scanPace(ppsl, part, ppsl->nParts);
+
+        if (timeRecords)
+            epicsTimeGetCurrent(&before);
+        for (i = ppsl->partStart[part]; i < ppsl->partStart[part + 1]; i++) {
+            scan_element *pse = ppsl->work[i].pse;
+            struct dbCommon *precord = pse->precord;
+            double time;
+
+            /* SCAN changes are made with the record locked */
+            dbScanLock(precord);
+            if (pse->pscan_list == psl)
+                dbProcess(precord);
+            dbScanUnlock(precord);
+
+            if (!timeRecords) continue;
+
+            epicsTimeGetCurrent(&after);
+            time = epicsTimeDiffInSeconds(&after, &before);
+            if (time > slowestTime) {
+                pslowest = precord;
+                slowestTime = time;
+            }
+            before = after;
+        }
+    }
+    if (pslowest)
+        scanNoteSlowest(ppsl, pslowest, slowestTime);
+}
+
+static void scanParallel(periodic_scan_list *ppsl)
+{
+    int i, nWake;
+
+    partitionList(ppsl);
+    if (ppsl->nParts == 0) return;
+
+    nWake = ppsl->nHelpers;
+    if ((size_t)nWake > ppsl->nParts - 1)
+        nWake = ppsl->nParts - 1;
+    if (nWake && !ppsl->helpers) {
+        scanHelperStart(ppsl);
+        if (nWake > ppsl->nHelpers)
+            nWake = ppsl->nHelpers;
+    }
+
+    epicsAtomicSetSizeT(&ppsl->nextPart, 0);
+    epicsAtomicSetIntT(&ppsl->nBusy, nWake + 1);
+    for (i = 0; i < nWake; i++)
+        epicsEventSignal(ppsl->helpers[i].wakeEvent);
+
+    scanPartitions(ppsl);
+    if (epicsAtomicDecrIntT(&ppsl->nBusy) != 0)
+        epicsEventMustWait(ppsl->doneEvent);
+}
+
 
 static void initPeriodic(void)
 {
     dbMenu *pmenu = dbFindMenu(pdbbase, "menuScan");
     double quantum = epicsThreadSleepQuantum();
+    int nThreads = scanParallelThreads;
     int i;
 
+    scanQuantum = quantum;
+
     if (!pmenu) {
         errlogPrintf("initPeriodic: menuScan not present\n");
         return;
     }
+    if (nThreads < 0)
+        nThreads = epicsThreadGetCPUs() + nThreads;
+    if (nThreads < 1)
+        nThreads = 1;
     nPeriodic = pmenu->nChoice - SCAN_1ST_PERIODIC;
     papPeriodic = dbCalloc(nPeriodic, sizeof(periodic_scan_list*));
     periodicTaskId = dbCalloc(nPeriodic, sizeof(void *));
@@ -817,6 +1185,10 @@ static void initPeriodic(void)
         ppsl->name = choice;
         ppsl->scanCtl = ctlPause;
         ppsl->loopEvent = epicsEventMustCreate(epicsEventEmpty);
+        ppsl->paceEvent = epicsEventMustCreate(epicsEventEmpty);
+        ppsl->stats.period = ppsl->period;
+        scanIoInit(&ppsl->statsScan);
+        ppsl->nHelpers = nThreads - 1;
 
         number = ppsl->period / quantum;
         if ((ppsl->period < 2 * quantum) ||
@@ -838,7 +1210,18 @@ static void deletePeriodic(void)
 
         if (!ppsl) continue;
         ellFree(&ppsl->scan_list.list);
+        if (ppsl->helpers) {
+            int j;
+
+            for (j = 0; j < ppsl->nHelpers; j++)
+                epicsEventDestroy(ppsl->helpers[j].wakeEvent);
+            free(ppsl->helpers);
+            epicsEventDestroy(ppsl->doneEvent);
+        }
+        free(ppsl->work);
+        free(ppsl->partStart);
         epicsEventDestroy(ppsl->loopEvent);
+        epicsEventDestroy(ppsl->paceEvent);
         epicsMutexDestroy(ppsl->scan_list.lock);
         free(ppsl);
     }
@@ -868,7 +1251,7 @@ static void ioscanCallback(epicsCallback *pcallback)
     ioscan_head *piosh = (ioscan_head *) pcallback->user;
     int prio = pcallback->priority;
 
-    scanList(&piosh->iosl[prio].scan_list);
+    scanList(&piosh->iosl[prio].scan_list, NULL);
     if (piosh->cb)
         piosh->cb(piosh->arg, piosh, prio);
 }
@@ -898,20 +1281,31 @@ static void printList(scan_list *psl, char *message)
     }
 }
 
-static void scanList(scan_list *psl)
+static void scanList(scan_list *psl, periodic_scan_list *ppsl)
 {
     /* When reading this code remember that the call to dbProcess can result
      * in the SCAN field being changed in an arbitrary number of records.
+     * Periodic lists also time each record, and may be spread over their
+     * period keeping the records in PHAS order.
      */
 
     scan_element *pse;
     scan_element *prev = NULL;
     scan_element *next = NULL;
+    struct dbCommon *pslowest = NULL;
+    double slowestTime = 0.0;
+    epicsTimeStamp before, after;
+    int timeRecords = ppsl && scanStatsSlowest;
+    size_t count;
+    size_t index = 0;
+
+    if (ppsl) before = ppsl->passStart;
 
     epicsMutexMustLock(psl->lock);
     psl->modified = FALSE;
     pse = (scan_element *)ellFirst(&psl->list);
     if (pse) next = (scan_element *)ellNext(&pse->node);
+    count = ellCount(&psl->list);
     epicsMutexUnlock(psl->lock);
 
     while (pse) {
@@ -921,6 +1315,21 @@ static void scanList(scan_list *psl)
         dbProcess(precord);
         dbScanUnlock(precord);
 
+        if (timeRecords) {
+            double time;
+
+            epicsTimeGetCurrent(&after);
+            time = epicsTimeDiffInSeconds(&after, &before);
+            if (time > slowestTime) {
+                pslowest = precord;
+                slowestTime = time;
+            }
+            before = after;
+        }
+        if (ppsl && scanPhaseStagger && scanPace(ppsl, ++index, count) &&
+            timeRecords)
+            epicsTimeGetCurrent(&before);
+
         epicsMutexMustLock(psl->lock);
         if (!psl->modified) {
             prev = pse;
@@ -949,10 +1358,12 @@ static void scanList(scan_list *psl)
         } else {
             /*Too many changes. Just wait till next period*/
             epicsMutexUnlock(psl->lock);
-            return;
+            break;
         }
         epicsMutexUnlock(psl->lock);
     }
+    if (pslowest)
+        scanNoteSlowest(ppsl, pslowest, slowestTime);
 }
 
 static void buildScanLists(void)
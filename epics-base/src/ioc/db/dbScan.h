@@ -16,6 +16,7 @@
 
 #include <limits.h>
 
+#include "dbDefs.h"
 #include "menuScan.h"
 #include "shareLib.h"
 #include "compilerDependencies.h"
@@ -40,8 +41,34 @@ typedef struct event_list *EVENTPVT;
 
 typedef void (*io_scan_complete)(void *usr, IOSCANPVT, int prio);
 
+/* Periodic scan list statistics, times are in seconds.
+ * Pass times are histogrammed in tenths of the period,
+ * the last bin counts passes that took longer than the period.
+ * The slowest record is only found while scanStatsSlowest is set.
+ */
+#define SCAN_STATS_BINS 11
+
+typedef struct scanStats {
+    double period;
+    double last;
+    double mean;
+    double max;
+    unsigned long passes;
+    unsigned long overruns;
+    unsigned long histogram[SCAN_STATS_BINS];
+    char slowest[PVNAME_STRINGSZ];  /* slowest record in the last pass */
+    double slowestTime;
+} scanStats;
+
 struct dbCommon;
 
+/* Threads sharing each periodic scan list, read by scanInit() */
+epicsShareExtern int scanParallelThreads;
+/* Spread the processing of each periodic list over its period */
+epicsShareExtern int scanPhaseStagger;
+/* Time each periodically scanned record to find the slowest */
+epicsShareExtern int scanStatsSlowest;
+
 epicsShareFunc long scanInit(void);
 epicsShareFunc void scanRun(void);
 epicsShareFunc void scanPause(void);
@@ -66,6 +93,11 @@ epicsShareFunc int scanpel(const char *event_name);
 /*print io_event list*/
 epicsShareFunc int scanpiol(void);
 
+/*periodic list statistics, scan is a menuScan index*/
+epicsShareFunc int scanStatsGet(int scan, scanStats *pstats);
+epicsShareFunc int scanStatsReset(int scan);
+epicsShareFunc IOSCANPVT scanStatsIoScan(int scan);
+
 epicsShareFunc void scanIoInit(IOSCANPVT *ppios);
 epicsShareFunc unsigned int scanIoRequest(IOSCANPVT pios);
 epicsShareFunc void scanIoSetComplete(IOSCANPVT, io_scan_complete, void *usr);
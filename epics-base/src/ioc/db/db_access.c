@@ -137,10 +137,8 @@ int dbChannel_get(struct dbChannel *chan,
     return result;
 }
 
-/* Performs the work of the public db_get_field API, but also returns the number
- * of elements actually copied to the buffer.  The caller is responsible for
- * zeroing the remaining part of the buffer. */
-int dbChannel_get_count(
+/* Copies the field into the buffer for dbChannel_get_count() */
+static int channelGet(
     struct dbChannel *chan, int buffer_type,
     void *pbuffer, long *nRequest, void *pfl)
 {
@@ -154,8 +152,6 @@ int dbChannel_get_count(
     * in the dbAccess.c dbGet() and getOptions() routines.
     */
 
-    dbScanLock(dbChannelRecord(chan));
-
     switch(buffer_type) {
     case(oldDBR_STRING):
         status = dbChannelGet(chan, DBR_STRING, pbuffer, &zero, nRequest, pfl);
@@ -798,12 +794,39 @@ int dbChannel_get_count(
         break;
     }
 
-    dbScanUnlock(dbChannelRecord(chan));
-
     if (status) return -1;
     return 0;
 }
 
+/* Performs the work of the public db_get_field API, but also returns the number
+ * of elements actually copied to the buffer.  The caller is responsible for
+ * zeroing the remaining part of the buffer. */
+int dbChannel_get_count(
+    struct dbChannel *chan, int buffer_type,
+    void *pbuffer, long *nRequest, void *pfl)
+{
+    dbCommon *precord = dbChannelRecord(chan);
+    db_field_log *plog = (db_field_log *)pfl;
+    unsigned long seq;
+    int status;
+
+    /* Try reading a scalar without the lock first */
+    if ((!plog || plog->type != dbfl_type_ref) &&
+        (seq = dbLockReadBegin(&chan->addr))) {
+        long nReq = nRequest ? *nRequest : 0;
+
+        status = channelGet(chan, buffer_type, pbuffer, nRequest, pfl);
+        if (dbLockReadEnd(&chan->addr, seq))
+            return status;
+        if (nRequest) *nRequest = nReq;
+    }
+
+    dbScanLock(precord);
+    status = channelGet(chan, buffer_type, pbuffer, nRequest, pfl);
+    dbScanUnlock(precord);
+    return status;
+}
+
 int dbChannel_put(struct dbChannel *chan, int src_type,
     const void *psrc, long no_elements)
 {
@@ -38,6 +38,7 @@
 #include "dbFldTypes.h"
 #include "dbLink.h"
 #include "dbNotify.h"
+#include "dbProfile.h"
 #include "dbScan.h"
 #include "devSup.h"
 #include "link.h"
@@ -228,6 +229,7 @@ void recGblFwdLink(void *precord)
 {
     dbCommon *pdbc = precord;
 
+    if (dbProfileEnabled) dbProfileAsyncDone(pdbc);
     dbScanFwdLink(&pdbc->flnk);
     /*Handle dbPutFieldNotify record completions*/
     if(pdbc->ppn) dbNotifyCompletion(pdbc);
@@ -5,6 +5,7 @@
 #include "string.h"
 
 #include "cantProceed.h"
+#include "dbAccessDefs.h"
 #include "dbAddr.h"
 #include "dbConvert.h"
 #include "dbDefs.h"
@@ -15,13 +16,15 @@
 #include "epicsUnitTest.h"
 #include "testMain.h"
 
+/* The field and buffer are allocated large enough for any numeric type */
 typedef struct {
-    size_t nelem, niter;
+    size_t nelem, niter, offset;
 
-    short *output;
-    short *input;
+    epicsFloat64 *output;
+    epicsFloat64 *input;
 
     GETCONVERTFUNC getter;
+    PUTCONVERTFUNC putter;
 
     DBADDR addr;
 } testData;
@@ -31,17 +34,28 @@ static long runRep(testData *D)
     size_t i;
 
     for(i=0; i<D->niter; i++) {
-        D->getter(&D->addr, D->output, D->nelem, D->nelem, 0);
+        if(D->getter)
+            D->getter(&D->addr, D->output, D->nelem, D->nelem, D->offset);
+        else
+            D->putter(&D->addr, D->output, D->nelem, D->nelem, D->offset);
     }
     return 0;
 }
 
-static void runBench(size_t nelem, size_t niter, size_t nrep)
+/* Times a get conversion from a field of type dbf to a buffer of type dbr,
+ * or a put conversion from dbr to dbf. A non-zero offset makes the field
+ * a circular buffer that wraps in the middle of every request.
+ */
+static void runBench(int put, short dbf, short dbr,
+    size_t nelem, size_t offset, size_t niter, size_t nrep)
 {
     size_t i;
     testData tdat;
     double *reptimes;
-    testDiag("Using %lu element arrays.",(unsigned long)nelem);
+    testDiag("%s DBF_%s %s DBR_%s, %lu element arrays%s.",
+             put ? "Put" : "Get", pamapdbfType[dbf].strvalue + 4,
+             put ? "from" : "to", pamapdbfType[dbr].strvalue + 4,
+             (unsigned long)nelem, offset ? " with wrap" : "");
     testDiag("run %lu reps with %lu iterations each",
              (unsigned long)nrep, (unsigned long)niter);
 
@@ -51,17 +65,19 @@ static void runBench(size_t nelem, size_t niter, size_t nrep)
 
     tdat.nelem = nelem;
     tdat.niter = niter;
+    tdat.offset = offset;
 
-    tdat.getter = dbGetConvertRoutine[DBF_SHORT][DBF_SHORT];
+    tdat.getter = put ? NULL : dbGetConvertRoutine[dbf][dbr];
+    tdat.putter = put ? dbPutConvertRoutine[dbr][dbf] : NULL;
 
     memset(&tdat.addr, 0, sizeof(tdat.addr));
-    tdat.addr.field_type = DBF_SHORT;
-    tdat.addr.field_size = nelem*sizeof(*tdat.input);
+    tdat.addr.field_type = dbf;
+    tdat.addr.field_size = nelem*dbValueSize(dbf);
     tdat.addr.no_elements = nelem;
     tdat.addr.pfield = (void*)tdat.input;
 
     for(i=0; i<nelem; i++)
-        tdat.input[i] = (short)i;
+        tdat.input[i] = (epicsFloat64)i;
 
     for(i=0; i<nrep; i++)
     {
@@ -82,7 +98,7 @@ static void runBench(size_t nelem, size_t niter, size_t nrep)
 
         reptimes[i] = epicsTimeDiffInSeconds(&stop, &start);
 
-        testDiag("%lu bytes in %.03f ms.  %.1f MB/s",
+        testDiag("%lu elements in %.03f ms.  %.1f M/s",
                  (unsigned long)(nelem*niter),
                  reptimes[i]*1e3,
                  (nelem*niter)/reptimes[i]/1e6);
@@ -96,7 +112,7 @@ static void runBench(size_t nelem, size_t niter, size_t nrep)
         }
 
         mean = sum/nrep;
-        testDiag("Final: %.04f ms +- %.05f ms.  %.1f MB/s  (for %lu elements)",
+        testDiag("Final: %.04f ms +- %.05f ms.  %.1f M/s  (for %lu elements)",
                  mean*1e3,
                  sqrt(sum2/nrep - mean*mean)*1e3,
                  (nelem*niter)/mean/1e6,
@@ -112,13 +128,25 @@ done:
 MAIN(benchdbConvert)
 {
     testPlan(0);
-    runBench(1, 10000000, 10);
-    runBench(2,  5000000, 10);
-    runBench(10, 1000000, 10);
-    runBench(100, 100000, 10);
-    runBench(10000, 1000, 10);
-    runBench(100000, 100, 10);
-    runBench(1000000, 10, 10);
-    runBench(10000000, 1, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 1, 0, 10000000, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 2, 0,  5000000, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 10, 0, 1000000, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 100, 0, 100000, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 10000, 0, 1000, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 100000, 0, 100, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 1000000, 0, 10, 10);
+    runBench(0, DBF_SHORT, DBR_SHORT, 10000000, 0, 1, 10);
+
+    /* Conversions commonly used for large waveforms */
+    runBench(0, DBF_SHORT, DBR_DOUBLE, 100000, 0, 100, 10);
+    runBench(0, DBF_SHORT, DBR_DOUBLE, 1000000, 0, 10, 10);
+    runBench(0, DBF_LONG, DBR_DOUBLE, 1000000, 0, 10, 10);
+    runBench(0, DBF_FLOAT, DBR_DOUBLE, 1000000, 0, 10, 10);
+    runBench(0, DBF_DOUBLE, DBR_FLOAT, 1000000, 0, 10, 10);
+    runBench(0, DBF_DOUBLE, DBR_FLOAT, 1000000, 300000, 10, 10);
+    runBench(0, DBF_DOUBLE, DBR_LONG, 1000000, 0, 10, 10);
+    runBench(1, DBF_LONG, DBR_DOUBLE, 1000000, 0, 10, 10);
+    runBench(1, DBF_FLOAT, DBR_DOUBLE, 1000000, 0, 10, 10);
+    runBench(1, DBF_DOUBLE, DBR_SHORT, 1000000, 300000, 10, 10);
     return testDone();
 }
@@ -95,6 +95,61 @@ static void printStats(double *stats, const char* tag) {
             tag, stats[0], stats[2]/stats[4], stats[1],
             sqrt(stats[4]*stats[3]-pow(stats[2], 2.0))/stats[4]);
 }
+#define NGROW 50
+
+static epicsEventId blockEvent;
+static int growOrder[NGROW], growCount;
+
+static void blockCallback(epicsCallback *pCallback)
+{
+    epicsEventMustWait(blockEvent);
+}
+
+static void growCallback(epicsCallback *pCallback)
+{
+    int i = (int)(size_t)pCallback->user;
+
+    growOrder[growCount++] = i;
+    if (growCount == NGROW)
+        epicsEventSignal(finished);
+}
+
+/* A queue which fills up while its thread is busy grows */
+static void testQueueGrowth(void)
+{
+    epicsCallback block, cb[NGROW];
+    int i, fails = 0, order = 0;
+
+    testDiag("Queue growth");
+    testOk1(callbackSetQueueSize(4) == 0);
+    callbackInit();
+    blockEvent = epicsEventMustCreate(epicsEventEmpty);
+
+    callbackSetCallback(blockCallback, &block);
+    callbackSetPriority(priorityLow, &block);
+    callbackRequest(&block);
+
+    for (i = 0; i < NGROW; i++) {
+        callbackSetCallback(growCallback, &cb[i]);
+        callbackSetPriority(priorityLow, &cb[i]);
+        callbackSetUser((void *)(size_t)i, &cb[i]);
+        if (callbackRequest(&cb[i]))
+            fails++;
+    }
+    testOk(fails == 0, "%d of %d requests failed", fails, NGROW);
+
+    epicsEventSignal(blockEvent);
+    testOk1(epicsEventWaitWithTimeout(finished, 10.0) == epicsEventWaitOK);
+    for (i = 0; i < NGROW; i++)
+        if (growOrder[i] != i)
+            order++;
+    testOk(order == 0, "Callbacks run in order (%d out of place)", order);
+
+    callbackStop();
+    callbackCleanup();
+    epicsEventDestroy(blockEvent);
+    callbackSetQueueSize(2000);
+}
 
 MAIN(callbackTest)
 {
@@ -110,7 +165,7 @@ MAIN(callbackTest)
         for (j = 0; j < 5; j++)
             setupError[i][j] = timeError[i][j] = defaultError[j];
 
-    testPlan(2);
+    testPlan(6);
 
     callbackInit();
     epicsThreadSleep(1.0);
@@ -202,5 +257,7 @@ MAIN(callbackTest)
     callbackStop();
     callbackCleanup();
 
+    testQueueGrowth();
+
     return testDone();
 }
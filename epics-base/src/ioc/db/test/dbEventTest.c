@@ -0,0 +1,222 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/* Tests delivery of monitors of scalar fields through the event queue */
+
+#include <string.h>
+
+#include "caeventmask.h"
+#include "dbAccess.h"
+#include "dbChannel.h"
+#include "dbEvent.h"
+#include "dbLock.h"
+#include "dbStaticLib.h"
+#include "dbUnitTest.h"
+#include "db_field_log.h"
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "errlog.h"
+#include "testMain.h"
+
+#include "xRecord.h"
+
+#define NPOSTS 20
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+typedef struct monitor {
+    epicsMutexId lock;
+    epicsEventId done;
+    int last;
+    int count;
+    int ordered;
+    int badType;
+} monitor;
+
+static void monitorCallback(void *user_arg, struct dbChannel *chan,
+    int eventsRemaining, struct db_field_log *pfl)
+{
+    monitor *mon = (monitor *)user_arg;
+    int val;
+
+    epicsMutexMustLock(mon->lock);
+    if (pfl->type != dbfl_type_val) {
+        mon->badType++;
+        epicsMutexUnlock(mon->lock);
+        return;
+    }
+    val = pfl->u.v.field.dbf_long;
+    if (mon->count && val <= mon->last)
+        mon->ordered = 0;
+    mon->last = val;
+    mon->count++;
+    epicsMutexUnlock(mon->lock);
+    epicsEventSignal(mon->done);
+}
+
+static void resetMonitor(monitor *mon)
+{
+    epicsMutexMustLock(mon->lock);
+    mon->count = 0;
+    mon->last = -1;
+    mon->ordered = 1;
+    mon->badType = 0;
+    epicsMutexUnlock(mon->lock);
+}
+
+static void postValue(xRecord *prec, int val)
+{
+    dbScanLock((dbCommon *)prec);
+    prec->val = val;
+    db_post_events(prec, &prec->val, DBE_VALUE);
+    dbScanUnlock((dbCommon *)prec);
+}
+
+/* Wait for the monitor to deliver val, returns the number of updates */
+static int waitFor(monitor *mon, int val)
+{
+    int i, count = -1;
+
+    for (i = 0; i < 100; i++) {
+        epicsMutexMustLock(mon->lock);
+        if (mon->last == val)
+            count = mon->count;
+        epicsMutexUnlock(mon->lock);
+        if (count >= 0)
+            break;
+        epicsEventWaitWithTimeout(mon->done, 0.1);
+    }
+    return count;
+}
+
+static void wakeup(void *arg)
+{
+    epicsEventSignal((epicsEventId)arg);
+}
+
+/* Without an event thread, run the queue when woken */
+static int processUntil(dbEventCtx ctx, epicsEventId woken, monitor *mon,
+    int val)
+{
+    int i, count = -1;
+
+    for (i = 0; i < 100 && count < 0; i++) {
+        if (epicsEventWaitWithTimeout(woken, 0.1) != epicsEventWaitOK)
+            continue;
+        db_process_events(ctx);
+        epicsMutexMustLock(mon->lock);
+        if (mon->last == val)
+            count = mon->count;
+        epicsMutexUnlock(mon->lock);
+    }
+    return count;
+}
+
+static void testPolled(xRecord *prec, monitor *mon)
+{
+    epicsEventId woken = epicsEventMustCreate(epicsEventEmpty);
+    dbEventCtx ctx;
+    dbChannel *chan;
+    dbEventSubscription sub;
+    int count, i;
+
+    testDiag("Run the event queue from a wakeup function");
+    resetMonitor(mon);
+
+    ctx = db_init_events();
+    testOk1(db_start_events_polled(ctx, wakeup, woken) == DB_EVENT_OK);
+    testOk(db_start_events(ctx, "dbEventTest", NULL, NULL,
+        epicsThreadPriorityLow) != DB_EVENT_OK,
+        "No event thread for a polled queue");
+
+    chan = dbChannelCreate("x.VAL");
+    testOk1(chan && !dbChannelOpen(chan));
+    sub = db_add_event(ctx, chan, monitorCallback, mon, DBE_VALUE);
+    db_event_enable(sub);
+
+    for (i = 200; i < 200 + NPOSTS; i++)
+        postValue(prec, i);
+    count = processUntil(ctx, woken, mon, 200 + NPOSTS - 1);
+    testOk(count > 0, "Last value received after %d updates", count);
+    testOk1(mon->ordered && !mon->badType);
+
+    db_cancel_event(sub);
+    db_close_events(ctx);
+    dbChannelDelete(chan);
+    epicsEventDestroy(woken);
+}
+
+MAIN(dbEventTest)
+{
+    dbEventCtx ctx;
+    dbChannel *chan;
+    dbEventSubscription sub;
+    xRecord *prec;
+    monitor mon;
+    int logs, count, i;
+
+    testPlan(14);
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("xRecord.db", NULL, NULL);
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    prec = (xRecord *)testdbRecordPtr("x");
+
+    mon.lock = epicsMutexMustCreate();
+    mon.done = epicsEventMustCreate(epicsEventEmpty);
+    resetMonitor(&mon);
+
+    ctx = db_init_events();
+    testOk1(ctx != NULL);
+    testOk1(db_start_events(ctx, "dbEventTest", NULL, NULL,
+        epicsThreadPriorityLow) == DB_EVENT_OK);
+
+    chan = dbChannelCreate("x.VAL");
+    testOk1(chan && !dbChannelOpen(chan));
+    sub = db_add_event(ctx, chan, monitorCallback, &mon, DBE_VALUE);
+    testOk1(sub != NULL);
+    db_event_enable(sub);
+
+    testDiag("Post %d values", NPOSTS);
+    logs = db_available_logs();
+    for (i = 0; i < NPOSTS; i++)
+        postValue(prec, i);
+    count = waitFor(&mon, NPOSTS - 1);
+    testOk(count > 0, "Last value received after %d updates", count);
+    testOk1(mon.ordered && !mon.badType);
+    testOk(db_available_logs() == logs,
+        "No field logs allocated (%d available, was %d)",
+        db_available_logs(), logs);
+
+    testDiag("Replace queued values in flow control mode");
+    resetMonitor(&mon);
+    db_event_flow_ctrl_mode_on(ctx);
+    for (i = 100; i < 100 + NPOSTS; i++)
+        postValue(prec, i);
+    db_event_flow_ctrl_mode_off(ctx);
+    count = waitFor(&mon, 100 + NPOSTS - 1);
+    testOk(count == 1, "Received only the last value (%d updates)", count);
+    testOk1(!mon.badType);
+
+    db_cancel_event(sub);
+    db_close_events(ctx);
+    dbChannelDelete(chan);
+
+    testPolled(prec, &mon);
+
+    epicsEventDestroy(mon.done);
+    epicsMutexDestroy(mon.lock);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -34,6 +34,46 @@ void compareSets(int match, const char *A, const char *B)
            A, match?'=':'!', B);
 }
 
+static
+void testLockFreeReads(void)
+{
+    DBADDR addr, linkAddr;
+    dbCommon *reca = testdbRecordPtr("reca");
+    dbCommon *recc = testdbRecordPtr("recc");
+    unsigned long seq;
+
+    testDiag("Check reads without the lock");
+
+    testOk1(!dbNameToAddr("recb.VAL", &addr));
+    testOk1(!dbNameToAddr("recb.SDIS", &linkAddr));
+
+    seq = dbLockReadBegin(&addr);
+    testOk(seq!=0, "Free lock set can be read");
+    testOk1(dbLockReadEnd(&addr, seq));
+
+    /* locking any record in the set invalidates a read */
+    seq = dbLockReadBegin(&addr);
+    dbScanLock(recc);
+    testOk(dbLockReadBegin(&addr)==0, "Locked set can't be read");
+    dbScanUnlock(recc);
+    testOk(!dbLockReadEnd(&addr, seq), "Read invalidated by lock");
+
+    /* other sets don't */
+    seq = dbLockReadBegin(&addr);
+    dbScanLock(reca);
+    dbScanUnlock(reca);
+    testOk(dbLockReadEnd(&addr, seq), "Read valid after locking other set");
+
+    testOk(dbLockReadBegin(&linkAddr)==0, "Link fields need the lock");
+
+    dbLockFreeReads = 0;
+    testOk(dbLockReadBegin(&addr)==0, "dbLockFreeReads=0 disables");
+    dbLockFreeReads = 1;
+
+    testdbPutFieldOk("recb.VAL", DBF_LONG, 42);
+    testdbGetFieldEqual("recb.VAL", DBF_LONG, 42);
+}
+
 static
 void testSets(void) {
     testDiag("Check initial creation of DB links");
@@ -71,6 +111,8 @@ void testSets(void) {
 
     compareSets(1, "rece", "recf");
 
+    testLockFreeReads();
+
     testIocShutdownOk();
 
     testdbCleanup();
@@ -78,7 +120,7 @@ void testSets(void) {
 
 MAIN(dbLockTest)
 {
-    testPlan(15);
+    testPlan(26);
     testSets();
     return testDone();
 }
@@ -0,0 +1,150 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests the record processing profiler through its report
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dbAccess.h"
+#include "dbProfile.h"
+#include "dbUnitTest.h"
+#include "epicsStdio.h"
+#include "errlog.h"
+#include "testMain.h"
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+#define NO_OF_RECORDS 3
+
+static struct {
+    const char *name;
+    long count;         /* -1 if not listed */
+} report[NO_OF_RECORDS] = {
+    {"a"}, {"b"}, {"c"}
+};
+static int listed;
+
+/* Runs dbProfileReport() and collects the counts it lists */
+static long runReport(int count, const char *sort)
+{
+    FILE *stream = epicsTempFile();
+    FILE *save = epicsGetStdout();
+    char line[256], name[64];
+    long n, status;
+    int i;
+
+    if (!stream)
+        testAbort("Can't create a temporary file");
+    epicsSetThreadStdout(stream);
+    status = dbProfileReport(count, sort);
+    epicsSetThreadStdout(save);
+
+    for (i = 0; i < NO_OF_RECORDS; i++)
+        report[i].count = -1;
+    listed = 0;
+    rewind(stream);
+    while (fgets(line, sizeof(line), stream)) {
+        if (sscanf(line, " %63s %ld", name, &n) != 2)
+            continue;
+        for (i = 0; i < NO_OF_RECORDS; i++) {
+            if (!strcmp(name, report[i].name)) {
+                report[i].count = n;
+                listed++;
+            }
+        }
+    }
+    fclose(stream);
+    return status;
+}
+
+static void processRecord(const char *name, int times)
+{
+    char field[64];
+    DBADDR addr;
+    epicsInt32 one = 1;
+
+    sprintf(field, "%s.PROC", name);
+    if (dbNameToAddr(field, &addr))
+        testAbort("Can't find %s", field);
+    while (times--)
+        dbPutField(&addr, DBR_LONG, &one, 1);
+}
+
+MAIN(dbProfileTest)
+{
+    long status;
+
+    testPlan(11);
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("dbProfileTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testDiag("Profiling is off");
+    processRecord("a", 2);
+    testOk(runReport(0, NULL) == 0 && listed == 0, "No records profiled");
+
+    testDiag("Profile a, which processes b through its FLNK");
+    dbProfileEnable(1);
+    processRecord("a", 3);
+    processRecord("b", 2);
+    status = runReport(0, NULL);
+    testOk(status == 0 && listed == 2, "%d records listed", listed);
+    testOk(report[0].count == 3 && report[1].count == 5,
+        "a processed %ld times, b %ld times",
+        report[0].count, report[1].count);
+    testOk(report[2].count == -1, "c is not listed");
+
+    testOk(runReport(1, "count") == 0 && listed == 1 &&
+        report[1].count == 5, "The top record by count is b");
+    testOk(runReport(0, "mean") == 0 && listed == 2,
+        "Sorted by mean");
+    testOk(runReport(0, "bogus") == -1, "Unknown sort key rejected");
+
+    testDiag("Reset");
+    dbProfileReset();
+    testOk(runReport(0, "total") == 0 && listed == 2 &&
+        report[0].count == 0 && report[1].count == 0,
+        "Counts are cleared");
+    processRecord("c", 1);
+    status = runReport(0, NULL);
+    testOk(status == 0 && listed == 3 && report[2].count == 1,
+        "c processed %ld times", report[2].count);
+
+    testDiag("An asynchronous cycle calls process() twice");
+    {
+        DBADDR addr;
+        epicsTimeStamp start;
+
+        if (dbNameToAddr("c", &addr))
+            testAbort("Can't find c");
+        epicsTimeGetCurrent(&start);
+        addr.precord->pact = TRUE;
+        dbProfileProcessed(addr.precord, &start);
+        addr.precord->pact = FALSE;
+        dbProfileAsyncDone(addr.precord);
+        dbProfileProcessed(addr.precord, &start);
+    }
+    runReport(0, NULL);
+    testOk(report[2].count == 2, "c counted once more, %ld times",
+        report[2].count);
+
+    dbProfileEnable(0);
+    processRecord("c", 1);
+    runReport(0, NULL);
+    testOk(report[2].count == 2, "Not counted while off");
+
+    testIocShutdownOk();
+    testdbCleanup();
+    return testDone();
+}
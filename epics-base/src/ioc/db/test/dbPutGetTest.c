@@ -3,6 +3,7 @@
 
 #include <errlog.h>
 #include <dbAccess.h>
+#include <dbChannel.h>
 #include <dbStaticLib.h>
 #include <dbStaticPvt.h>
 #include <dbUnitTest.h>
@@ -119,11 +120,61 @@ void testLongField(void)
     testdbGetArrFieldEqual("lnktest.NAME$", DBR_CHAR, 8, 8, "lnktest");
 }
 
+static
+void testChannelGet(void)
+{
+    dbChannel *chan;
+    db_field_log fl;
+    epicsFloat64 dval;
+    char sval[MAX_STRING_SIZE];
+    long nReq;
+
+    testDiag("testChannelGet()");
+
+    chan = dbChannelCreate("recmax.DISA");
+    testOk1(chan && !dbChannelOpen(chan) && chan->get_convert);
+
+    dbScanLock(dbChannelRecord(chan));
+    nReq = 1;
+    testOk1(!dbChannelGet(chan, DBR_DOUBLE, &dval, NULL, &nReq, NULL));
+    testOk(dval == -1.0 && nReq == 1, "Scalar get from record -> %g", dval);
+
+    memset(&fl, 0, sizeof(fl));
+    fl.type = dbfl_type_val;
+    fl.field_type = DBF_SHORT;
+    fl.no_elements = 1;
+    fl.u.v.field.dbf_short = 42;
+    testOk1(!dbChannelGet(chan, DBR_STRING, sval, NULL, NULL, &fl));
+    testOk(!strcmp(sval, "42"), "Scalar get from field log -> \"%s\"", sval);
+
+    nReq = 0;
+    dval = 0.0;
+    testOk(!dbChannelGet(chan, DBR_DOUBLE, &dval, NULL, &nReq, NULL) &&
+        dval == 0.0 && nReq == 0, "Zero element get is a no-op");
+    dbScanUnlock(dbChannelRecord(chan));
+    dbChannelDelete(chan);
+
+    chan = dbChannelCreate("lnktest.NAME$");
+    testOk(chan && !dbChannelOpen(chan) && !chan->get_convert,
+        "No scalar converter for an array field");
+    if (chan) dbChannelDelete(chan);
+
+    chan = dbChannelCreate("lnktest.RTYP");
+    testOk(chan && !dbChannelOpen(chan) && !chan->get_convert,
+        "No scalar converter for an attribute");
+    if (chan) dbChannelDelete(chan);
+
+    chan = dbChannelCreate("lnktest.INP");
+    testOk(chan && !dbChannelOpen(chan) && !chan->get_convert,
+        "No scalar converter for a link field");
+    if (chan) dbChannelDelete(chan);
+}
+
 void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
 
 MAIN(dbPutGet)
 {
-    testPlan(41);
+    testPlan(50);
     testdbPrepare();
 
     testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
@@ -141,6 +192,7 @@ MAIN(dbPutGet)
     testLongLink();
     testLongAttr();
     testLongField();
+    testChannelGet();
 
     testIocShutdownOk();
 
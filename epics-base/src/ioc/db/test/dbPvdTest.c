@@ -0,0 +1,191 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests the record name directory: growth, lookups while the table is
+ * being copied, and deletion
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dbAccess.h"
+#include "dbStaticLib.h"
+#include "dbStaticPvt.h"
+#include "dbUnitTest.h"
+#include "epicsEvent.h"
+#include "epicsThread.h"
+#include "testMain.h"
+
+#define NO_OF_RECORDS 2000  /* several resizes from 256 slots */
+#define NO_OF_STABLE 100    /* records the reader looks for */
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static volatile int readerStop;
+static int readerLookups;
+static int readerMisses;
+static epicsEventId readerDone;
+
+static void createRecord(const char *name)
+{
+    DBENTRY entry;
+
+    dbInitEntry(pdbbase, &entry);
+    if (dbFindRecordType(&entry, "x") || dbCreateRecord(&entry, name))
+        testAbort("Can't create record %s", name);
+    dbFinishEntry(&entry);
+}
+
+static int deleteRecord(const char *name)
+{
+    DBENTRY entry;
+    long status;
+
+    dbInitEntry(pdbbase, &entry);
+    status = dbFindRecord(&entry, name);
+    if (!status)
+        status = dbDeleteRecord(&entry);
+    dbFinishEntry(&entry);
+    return !status;
+}
+
+static int findRecord(const char *name)
+{
+    DBENTRY entry;
+    long status;
+
+    dbInitEntry(pdbbase, &entry);
+    status = dbFindRecord(&entry, name);
+    if (!status && strcmp(dbGetRecordName(&entry), name))
+        status = -1;
+    dbFinishEntry(&entry);
+    return !status;
+}
+
+/* Looks up records that are never deleted while others come and go */
+static void reader(void *arg)
+{
+    char name[20];
+    int i;
+
+    while (!readerStop) {
+        for (i = 0; i < NO_OF_STABLE; i++) {
+            sprintf(name, "r%d", i);
+            if (!findRecord(name))
+                readerMisses++;
+            readerLookups++;
+        }
+    }
+    epicsEventMustTrigger(readerDone);
+}
+
+static void testGrowth(void)
+{
+    char name[20];
+    int i, missing = 0;
+
+    testDiag("Add %d records to a 256 slot table", NO_OF_RECORDS);
+
+    for (i = 0; i < NO_OF_RECORDS; i++) {
+        sprintf(name, "r%d", i);
+        createRecord(name);
+        /* The first and middle records move to a new table in turn */
+        sprintf(name, "r%d", i / 2);
+        missing += !findRecord(name) + !findRecord("r0");
+    }
+    testOk(missing == 0, "Records found while the table grows (%d missing)",
+        missing);
+
+    for (i = 0; i < NO_OF_RECORDS; i++) {
+        sprintf(name, "r%d", i);
+        missing += !findRecord(name);
+    }
+    testOk(missing == 0, "All %d records found (%d missing)",
+        NO_OF_RECORDS, missing);
+    testOk(!findRecord("r") && !findRecord("r2000") && !findRecord("r00"),
+        "Other names are not found");
+}
+
+static void testDelete(void)
+{
+    char name[20];
+    int i, wrong = 0;
+
+    testDiag("Delete the even records");
+
+    for (i = 0; i < NO_OF_RECORDS; i += 2) {
+        sprintf(name, "r%d", i);
+        wrong += !deleteRecord(name);
+    }
+    testOk(wrong == 0, "Records deleted (%d failed)", wrong);
+    testOk(!deleteRecord("r0"), "Deleting r0 again fails");
+
+    for (i = 0; i < NO_OF_RECORDS; i++) {
+        sprintf(name, "r%d", i);
+        wrong += findRecord(name) != (i & 1);
+    }
+    testOk(wrong == 0, "Only the odd records are found (%d wrong)", wrong);
+
+    for (i = 0; i < NO_OF_RECORDS; i += 2) {
+        sprintf(name, "r%d", i);
+        createRecord(name);
+    }
+    for (i = 0; i < NO_OF_RECORDS; i++) {
+        sprintf(name, "r%d", i);
+        wrong += !findRecord(name);
+    }
+    testOk(wrong == 0, "Deleted names can be added again (%d missing)",
+        wrong);
+}
+
+static void testConcurrent(void)
+{
+    char name[20];
+    int i;
+
+    testDiag("Look up records while others are added and deleted");
+
+    readerStop = 0;
+    readerLookups = readerMisses = 0;
+    readerDone = epicsEventMustCreate(epicsEventEmpty);
+    epicsThreadMustCreate("pvdReader", epicsThreadPriorityMedium,
+        epicsThreadGetStackSize(epicsThreadStackSmall), reader, NULL);
+
+    for (i = 0; i < 2 * NO_OF_RECORDS; i++) {
+        sprintf(name, "s%d", i);
+        createRecord(name);
+        if (i & 1) {
+            sprintf(name, "s%d", i / 2);
+            deleteRecord(name);
+        }
+        if (i % 100 == 0)
+            epicsThreadSleep(0.0);
+    }
+
+    readerStop = 1;
+    epicsEventMustWait(readerDone);
+    epicsEventDestroy(readerDone);
+    testOk(readerLookups > 0 && readerMisses == 0,
+        "%d lookups, %d missed", readerLookups, readerMisses);
+}
+
+MAIN(dbPvdTest)
+{
+    testPlan(8);
+
+    dbPvdTableSize(256);
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    testGrowth();
+    testDelete();
+    testConcurrent();
+
+    testdbCleanup();
+    dbPvdTableSize(512);
+    return testDone();
+}
@@ -23,8 +23,12 @@ int dbStateTest(void);
 int dbCaStatsTest(void);
 int dbShutdownTest(void);
 int scanIoTest(void);
+int scanPeriodicTest(void);
 int dbLockTest(void);
 int dbPutLinkTest(void);
+int dbPvdTest(void);
+int dbProfileTest(void);
+int dbEventTest(void);
 int testDbChannel(void);
 int chfPluginTest(void);
 int arrShorthandTest(void);
@@ -41,8 +45,12 @@ void epicsRunDbTests(void)
     runTest(dbCaStatsTest);
     runTest(dbShutdownTest);
     runTest(scanIoTest);
+    runTest(scanPeriodicTest);
     runTest(dbLockTest);
     runTest(dbPutLinkTest);
+    runTest(dbPvdTest);
+    runTest(dbProfileTest);
+    runTest(dbEventTest);
     runTest(testDbChannel);
     runTest(arrShorthandTest);
     runTest(recGblCheckDeadbandTest);
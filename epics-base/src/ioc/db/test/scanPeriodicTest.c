@@ -0,0 +1,370 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests periodic scanning, serial and with several threads per list
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dbAccessDefs.h"
+#include "dbAddr.h"
+#include "dbScan.h"
+#include "dbStaticLib.h"
+#include "dbUnitTest.h"
+#include "devSup.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "epicsTime.h"
+#include "menuScan.h"
+#include "recSup.h"
+#include "testMain.h"
+
+#define GEN_SIZE_OFFSET
+#include "zRecord.h"
+
+#include "epicsExport.h"
+
+#define NO_OF_GROUPS 5      /* lock sets */
+#define NO_OF_MEMBERS 3     /* records in each lock set */
+#define NO_OF_RECORDS (NO_OF_GROUPS * NO_OF_MEMBERS)
+#define MAX_PASSES 200
+#define PERIOD 0.1          /* the ".1 second" list */
+
+void scanPeriodicTest_registerRecordDeviceDriver(struct dbBase *);
+
+struct pvtZ {
+    int group;
+    int member;
+    int count;                  /* times processed */
+    double when[MAX_PASSES];    /* seconds from startIoc() */
+};
+
+/* Protected by pvtLock */
+static struct pvtZ pvts[NO_OF_RECORDS];
+static int groupBusy[NO_OF_GROUPS];
+static int nBusy;
+static int maxBusy;
+static int concurrent;
+static epicsMutexId pvtLock;
+static epicsTimeStamp started;
+
+static double holdTime;         /* time spent in process() */
+static struct pvtZ *pslow;      /* this record takes slowTime longer */
+static double slowTime;
+static int movePass = -1;       /* g0m0 makes g0m2 Passive in this pass */
+static DBADDR moveAddr;
+
+/*************************************************************************\
+* zRecord: records the time of each processing
+\*************************************************************************/
+
+struct zdset {
+    long      number;
+    DEVSUPFUN report;
+    DEVSUPFUN init;
+    DEVSUPFUN init_record;
+    DEVSUPFUN get_ioint_info;
+    DEVSUPFUN process;
+} devZ = {
+    5,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+epicsExportAddress(dset, devZ);
+
+static long init_record(zRecord *prec, int pass)
+{
+    int group, member;
+
+    if (pass == 0) return 0;
+
+    if (sscanf(prec->name, "g%dm%d", &group, &member) != 2)
+        return -1;
+    prec->dpvt = &pvts[group * NO_OF_MEMBERS + member];
+    pvts[group * NO_OF_MEMBERS + member].group = group;
+    pvts[group * NO_OF_MEMBERS + member].member = member;
+    return 0;
+}
+
+static long process(zRecord *prec)
+{
+    struct pvtZ *pvt = (struct pvtZ *)prec->dpvt;
+    epicsTimeStamp now;
+    int move;
+
+    epicsTimeGetCurrent(&now);
+    epicsMutexMustLock(pvtLock);
+    if (groupBusy[pvt->group]++)
+        concurrent = 1;
+    if (++nBusy > maxBusy)
+        maxBusy = nBusy;
+    move = pvt->group == 0 && pvt->member == 0 && pvt->count == movePass;
+    if (pvt->count < MAX_PASSES)
+        pvt->when[pvt->count] = epicsTimeDiffInSeconds(&now, &started);
+    pvt->count++;
+    epicsMutexUnlock(pvtLock);
+
+    if (move) {
+        /* g0m2 shares our lock set, so it is already locked */
+        epicsEnum16 passive = menuScanPassive;
+
+        dbPut(&moveAddr, DBR_ENUM, &passive, 1);
+    }
+    if (holdTime > 0)
+        epicsThreadSleep(holdTime);
+    if (pvt == pslow)
+        epicsThreadSleep(slowTime);
+
+    epicsMutexMustLock(pvtLock);
+    groupBusy[pvt->group]--;
+    nBusy--;
+    epicsMutexUnlock(pvtLock);
+    return 0;
+}
+
+rset zRSET={
+    4,
+    NULL, /* report */
+    NULL, /* initialize */
+    init_record,
+    process
+};
+epicsExportAddress(rset, zRSET);
+
+static void startIoc(int threads)
+{
+    char substitutions[64];
+    int i, j;
+
+    memset(pvts, 0, sizeof(pvts));
+    holdTime = 0.0;
+    pslow = NULL;
+    movePass = -1;
+    scanParallelThreads = threads;
+    scanPhaseStagger = 0;
+    scanStatsSlowest = 0;
+
+    testdbPrepare();
+    testdbReadDatabase("scanPeriodicTest.dbd", NULL, NULL);
+    scanPeriodicTest_registerRecordDeviceDriver(pdbbase);
+    for (i = 0; i < NO_OF_GROUPS; i++) {
+        for (j = 0; j < NO_OF_MEMBERS; j++) {
+            sprintf(substitutions, "GROUP=%d,MEMBER=%d", i, j);
+            testdbReadDatabase("scanPeriodicTest.db", NULL, substitutions);
+        }
+    }
+    epicsTimeGetCurrent(&started);
+    testIocInitOk();
+    if (dbNameToAddr("g0m2.SCAN", &moveAddr))
+        testAbort("g0m2.SCAN not found");
+}
+
+static void stopIoc(void)
+{
+    testIocShutdownOk();
+    testdbCleanup();
+}
+
+/* Every record processes once per pass, so its n'th processing
+ * belongs to pass n. Returns the first pass not yet complete.
+ */
+static int passesDone(void)
+{
+    int i, done = MAX_PASSES;
+
+    epicsMutexMustLock(pvtLock);
+    for (i = 0; i < NO_OF_RECORDS; i++) {
+        if (pvts[i].count < done)
+            done = pvts[i].count;
+    }
+    epicsMutexUnlock(pvtLock);
+    return done;
+}
+
+/* The smallest and largest time between the first and last record
+ * processed in the completed passes from first on.
+ */
+static int passSpread(int first, double *pmin, double *pmax)
+{
+    int last = passesDone();
+    int pass, i, n = 0;
+
+    *pmin = *pmax = 0.0;
+    epicsMutexMustLock(pvtLock);
+    for (pass = first; pass < last; pass++) {
+        double lo = pvts[0].when[pass];
+        double hi = lo;
+
+        for (i = 1; i < NO_OF_RECORDS; i++) {
+            double when = pvts[i].when[pass];
+
+            if (when < lo) lo = when;
+            if (when > hi) hi = when;
+        }
+        if (n == 0 || hi - lo < *pmin) *pmin = hi - lo;
+        if (n == 0 || hi - lo > *pmax) *pmax = hi - lo;
+        n++;
+    }
+    epicsMutexUnlock(pvtLock);
+    return n;
+}
+
+static void testStagger(void)
+{
+    double lo, hi;
+    int first, n;
+
+    /* passes in progress may have seen either setting */
+    first = passesDone() + 1;
+    epicsThreadSleep(8 * PERIOD);
+    n = passSpread(first, &lo, &hi);
+    testOk(n > 0 && lo < PERIOD / 4,
+        "Unstaggered passes take %.3f .. %.3f sec", lo, hi);
+
+    scanPhaseStagger = 1;
+    first = passesDone() + 1;
+    epicsThreadSleep(8 * PERIOD);
+    n = passSpread(first, &lo, &hi);
+    testOk(n > 0 && lo > PERIOD / 2,
+        "Staggered passes take %.3f .. %.3f sec", lo, hi);
+    scanPhaseStagger = 0;
+}
+
+/* Records processed once per pass are never more than one pass apart */
+static int countsInStep(int skip)
+{
+    int i, lo = -1, hi = -1;
+
+    epicsMutexMustLock(pvtLock);
+    for (i = 0; i < NO_OF_RECORDS; i++) {
+        if (i == skip) continue;
+        if (lo < 0 || pvts[i].count < lo) lo = pvts[i].count;
+        if (hi < 0 || pvts[i].count > hi) hi = pvts[i].count;
+    }
+    epicsMutexUnlock(pvtLock);
+    if (hi - lo > 1)
+        testDiag("Records processed %d .. %d times", lo, hi);
+    return hi - lo <= 1;
+}
+
+static void testPasses(int parallel)
+{
+    int i, inStep = 1;
+
+    epicsMutexMustLock(pvtLock);
+    concurrent = 0;
+    maxBusy = 0;
+    epicsMutexUnlock(pvtLock);
+    holdTime = 0.002;
+
+    for (i = 0; i < 10; i++) {
+        epicsThreadSleep(PERIOD);
+        inStep &= countsInStep(-1);
+    }
+    holdTime = 0.0;
+
+    testOk(inStep, "Each record processed once per pass");
+    testOk(!concurrent, "Records in the same lock set never processed together");
+    if (parallel)
+        testOk(maxBusy > 1, "Up to %d records processed together", maxBusy);
+}
+
+static void testScanChange(void)
+{
+    struct pvtZ *pm0 = &pvts[0];
+    struct pvtZ *pm2 = &pvts[2];
+    int count;
+
+    testDiag("Make g0m2 Passive from g0m0 during a pass");
+    epicsMutexMustLock(pvtLock);
+    movePass = pm0->count + 2;
+    epicsMutexUnlock(pvtLock);
+    epicsThreadSleep(6 * PERIOD);
+
+    epicsMutexMustLock(pvtLock);
+    count = pm2->count;
+    epicsMutexUnlock(pvtLock);
+    testOk(count == movePass,
+        "g0m2 processed in %d passes, not in pass %d", count, movePass);
+    testOk(countsInStep(2), "Other records processed once per pass");
+
+    testdbPutFieldOk("g0m2.SCAN", DBR_STRING, ".1 second");
+    epicsThreadSleep(4 * PERIOD);
+    epicsMutexMustLock(pvtLock);
+    testOk(pm2->count > count + 1, "g0m2 scanned again, %d passes",
+        pm2->count);
+    movePass = -1;
+    epicsMutexUnlock(pvtLock);
+}
+
+static void testStats(void)
+{
+    scanStats stats;
+    unsigned long sum;
+    int i;
+
+    testOk(scanStatsGet(menuScanPassive, &stats) == -1,
+        "No statistics for Passive");
+
+    scanStatsReset(menuScan_1_second);
+    epicsThreadSleep(5 * PERIOD);
+    scanStatsGet(menuScan_1_second, &stats);
+    testOk(stats.passes >= 3 && fabs(stats.period - PERIOD) < 1e-9,
+        "%lu passes of period %g", stats.passes, stats.period);
+    for (sum = 0, i = 0; i < SCAN_STATS_BINS; i++)
+        sum += stats.histogram[i];
+    testOk(sum == stats.passes, "Histogram holds %lu passes", sum);
+    testOk(stats.slowest[0] == '\0',
+        "No slowest record while scanStatsSlowest is 0");
+
+    testDiag("Make g2m1 the slowest record");
+    pslow = &pvts[2 * NO_OF_MEMBERS + 1];
+    slowTime = 0.01;
+    scanStatsSlowest = 1;
+    epicsThreadSleep(3 * PERIOD);
+    scanStatsGet(menuScan_1_second, &stats);
+    testOk(!strcmp(stats.slowest, "g2m1") && stats.slowestTime >= 0.009,
+        "Slowest record is '%s', %.4f sec", stats.slowest, stats.slowestTime);
+    scanStatsSlowest = 0;
+    pslow = NULL;
+
+    scanStatsReset(menuScan_1_second);
+    scanStatsGet(menuScan_1_second, &stats);
+    testOk(stats.passes <= 1 && stats.overruns == 0,
+        "Reset leaves %lu passes", stats.passes);
+}
+
+MAIN(scanPeriodicTest)
+{
+    testPlan(29);
+
+    pvtLock = epicsMutexMustCreate();
+
+    testDiag("Serial scanning, %d records", NO_OF_RECORDS);
+    startIoc(0);
+    testStagger();
+    testPasses(0);
+    testScanChange();
+    testStats();
+    stopIoc();
+
+    testDiag("Parallel scanning, %d lock sets of %d records",
+        NO_OF_GROUPS, NO_OF_MEMBERS);
+    startIoc(3);
+    testStagger();
+    testPasses(1);
+    testScanChange();
+    testStats();
+    stopIoc();
+
+    epicsMutexDestroy(pvtLock);
+    return testDone();
+}
@@ -3,11 +3,13 @@
 *     National Laboratory.
 \*************************************************************************/
 #include "string.h"
+#include "float.h"
 
 #include "cantProceed.h"
 #include "dbConvert.h"
 #include "dbDefs.h"
 #include "epicsAssert.h"
+#include "epicsTypes.h"
 
 #include "epicsUnitTest.h"
 #include "testMain.h"
@@ -146,10 +148,62 @@ static void testBasicPut(void)
     free(scratch);
 }
 
+static void testConvertWrap(void)
+{
+    double dbuf[NELEMENTS(s_input)];
+    epicsInt32 lbuf[NELEMENTS(s_input)];
+    float fbuf[NELEMENTS(s_input)];
+    static const double d_input[] = {1e39, -1e39, -1e-50, 0.0, 2.5, -2.5, 7.0};
+    DBADDR addr;
+    long i;
+    int ok;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.field_type = DBF_SHORT;
+    addr.field_size = sizeof(short);
+    addr.no_elements = s_input_len;
+    addr.pfield = (void*)s_input;
+
+    testDiag("Test dbGetConvertRoutine[DBF_SHORT][DBF_DOUBLE] with wrap");
+
+    memset(dbuf, 0, sizeof(dbuf));
+    dbGetConvertRoutine[DBF_SHORT][DBF_DOUBLE](&addr, dbuf,
+        s_input_len, s_input_len, 4);
+    for (ok = 1, i = 0; i < s_input_len; i++)
+        ok &= dbuf[i] == s_input[(i + 4) % s_input_len];
+    testOk(ok, "All elements converted in order");
+
+    testDiag("Test dbPutConvertRoutine[DBF_DOUBLE][DBF_LONG] with wrap");
+
+    memset(lbuf, 0x42, sizeof(lbuf));
+    addr.field_type = DBF_LONG;
+    addr.field_size = sizeof(epicsInt32);
+    addr.pfield = (void*)lbuf;
+    dbPutConvertRoutine[DBF_DOUBLE][DBF_LONG](&addr, dbuf, 5, s_input_len, 3);
+    for (ok = 1, i = 0; i < 5; i++)
+        ok &= lbuf[(i + 3) % s_input_len] == (epicsInt32)dbuf[i];
+    testOk(ok, "Elements written around the end of the array");
+    testOk1(lbuf[1] == 0x42424242);
+
+    testDiag("Test dbGetConvertRoutine[DBF_DOUBLE][DBF_FLOAT] limits");
+
+    addr.field_type = DBF_DOUBLE;
+    addr.field_size = sizeof(double);
+    addr.pfield = (void*)d_input;
+    dbGetConvertRoutine[DBF_DOUBLE][DBF_FLOAT](&addr, fbuf,
+        s_input_len, s_input_len, 2);
+    testOk1(fbuf[0] == -FLT_MIN);
+    testOk1(fbuf[1] == 0.0f);
+    testOk1(fbuf[2] == 2.5f && fbuf[3] == -2.5f && fbuf[4] == 7.0f);
+    testOk1(fbuf[5] == FLT_MAX);
+    testOk1(fbuf[6] == -FLT_MAX);
+}
+
 MAIN(testdbConvert)
 {
-    testPlan(15);
+    testPlan(23);
     testBasicGet();
     testBasicPut();
+    testConvertWrap();
     return testDone();
 }
@@ -15,6 +15,7 @@
 #include <string.h>
 
 #include "dbDefs.h"
+#include "epicsAtomic.h"
 #include "ellLib.h"
 #include "epicsMutex.h"
 #include "epicsStdio.h"
@@ -25,15 +26,40 @@
 #include "dbStaticLib.h"
 #include "dbStaticPvt.h"
 
+/* Record names are kept in an open-addressing hash table with linear
+ * probing. Each slot holds the hash of the name as well as the entry, so
+ * a probe only has to look at the name when the hashes match.
+ *
+ * When the table gets half full a table twice the size is allocated and
+ * the entries are copied into it a few slots at a time by each following
+ * dbPvdAdd(), while dbPvdFind() searches both tables. Entries are not
+ * removed from the old table while copying, so lookups don't need a lock.
+ * Tables that have been replaced and entries that have been deleted are
+ * kept until dbPvdFreeMem() in case a lookup is still using them. Changes
+ * are serialized by the lock.
+ */
+
 typedef struct {
-    ELLLIST      list;
-    epicsMutexId lock;
-} dbPvdBucket;
+    unsigned int hash;
+    PVDENTRY     *entry;
+} dbPvdSlot;
 
-typedef struct dbPvd {
+typedef struct dbPvdTable {
+    struct dbPvdTable *next;    /* replaced tables */
     unsigned int size;
     unsigned int mask;
-    dbPvdBucket **buckets;
+    unsigned int used;          /* slots with an entry or deleted marker */
+    dbPvdSlot    *slots;
+} dbPvdTable;
+
+typedef struct dbPvd {
+    epicsMutexId lock;
+    dbPvdTable   *table;
+    dbPvdTable   *old;          /* being copied into table */
+    unsigned int copied;        /* slots of old copied so far */
+    unsigned int count;         /* number of records */
+    dbPvdTable   *replaced;
+    ELLLIST      deleted;       /* entries removed by dbPvdDelete() */
 } dbPvd;
 
 unsigned int dbPvdHashTableSize = 0;
@@ -42,6 +68,13 @@ unsigned int dbPvdHashTableSize = 0;
 #define DEFAULT_SIZE 512
 #define MAX_SIZE 65536
 
+/* Slots of the old table copied per dbPvdAdd() while resizing */
+#define COPY_SLOTS 16
+
+/* Marks the slot of a deleted entry, probes continue past it */
+static PVDENTRY deletedEntry;
+#define DELETED (&deletedEntry)
+
 
 int dbPvdTableSize(int size)
 {
@@ -60,6 +93,114 @@ int dbPvdTableSize(int size)
     return 0;
 }
 
+static unsigned int pvdHash(const char *name, size_t lenName)
+{
+    unsigned int h = epicsMemHash(name, lenName, 0);
+
+    /* Spread the bits used by the mask */
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h;
+}
+
+static dbPvdTable * pvdTableCreate(unsigned int size)
+{
+    dbPvdTable *ptable = dbCalloc(1, sizeof(dbPvdTable));
+
+    ptable->size  = size;
+    ptable->mask  = size - 1;
+    ptable->slots = dbCalloc(size, sizeof(dbPvdSlot));
+    return ptable;
+}
+
+static void pvdTableFree(dbPvdTable *ptable)
+{
+    free(ptable->slots);
+    free(ptable);
+}
+
+/* Returns the entry for name and optionally its slot, or NULL */
+static PVDENTRY * pvdTableFind(dbPvdTable *ptable, unsigned int hash,
+    const char *name, size_t lenName, dbPvdSlot **ppslot)
+{
+    unsigned int i = hash & ptable->mask;
+
+    for (;;) {
+        dbPvdSlot *pslot = &ptable->slots[i];
+        PVDENTRY *ppvdNode = (PVDENTRY *)
+            epicsAtomicGetPtrT((EpicsAtomicPtrT *) &pslot->entry);
+
+        if (!ppvdNode)
+            return NULL;
+        epicsAtomicReadMemoryBarrier();
+        if (ppvdNode != DELETED && pslot->hash == hash) {
+            const char *recordname = ppvdNode->precnode->recordname;
+
+            if (strncmp(name, recordname, lenName) == 0 &&
+                recordname[lenName] == '\0') {
+                if (ppslot)
+                    *ppslot = pslot;
+                return ppvdNode;
+            }
+        }
+        i = (i + 1) & ptable->mask;
+    }
+}
+
+/* Caller holds the lock and has checked name isn't in ptable */
+static void pvdTableInsert(dbPvdTable *ptable, unsigned int hash,
+    PVDENTRY *ppvdNode)
+{
+    unsigned int i = hash & ptable->mask;
+
+    while (ptable->slots[i].entry)
+        i = (i + 1) & ptable->mask;
+
+    ptable->slots[i].hash = hash;
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetPtrT((EpicsAtomicPtrT *) &ptable->slots[i].entry, ppvdNode);
+    ptable->used++;
+}
+
+/* Copy up to nSlots slots of the old table, caller holds the lock */
+static void pvdCopy(dbPvd *ppvd, unsigned int nSlots)
+{
+    dbPvdTable *old = ppvd->old;
+
+    while (nSlots-- && ppvd->copied < old->size) {
+        dbPvdSlot *pslot = &old->slots[ppvd->copied++];
+
+        if (pslot->entry && pslot->entry != DELETED)
+            pvdTableInsert(ppvd->table, pslot->hash, pslot->entry);
+    }
+    if (ppvd->copied == old->size) {
+        epicsAtomicSetPtrT((EpicsAtomicPtrT *) &ppvd->old, NULL);
+        old->next = ppvd->replaced;
+        ppvd->replaced = old;
+    }
+}
+
+/* Start using a larger table, caller holds the lock */
+static void pvdGrow(dbPvd *ppvd)
+{
+    dbPvdTable *ptable;
+    unsigned int size = ppvd->table->size;
+
+    /* Finish any previous resize first */
+    if (ppvd->old)
+        pvdCopy(ppvd, ppvd->old->size);
+
+    while (size < 4 * (ppvd->count + 1))
+        size <<= 1;
+    ptable = pvdTableCreate(size);
+
+    ppvd->copied = 0;
+    epicsAtomicSetPtrT((EpicsAtomicPtrT *) &ppvd->old, ppvd->table);
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetPtrT((EpicsAtomicPtrT *) &ppvd->table, ptable);
+}
+
 void dbPvdInitPvt(dbBase *pdbbase)
 {
     dbPvd *ppvd;
@@ -70,10 +211,9 @@ void dbPvdInitPvt(dbBase *pdbbase)
         dbPvdHashTableSize = DEFAULT_SIZE;
     }
 
-    ppvd = (dbPvd *)dbMalloc(sizeof(dbPvd));
-    ppvd->size    = dbPvdHashTableSize;
-    ppvd->mask    = dbPvdHashTableSize - 1;
-    ppvd->buckets = dbCalloc(ppvd->size, sizeof(dbPvdBucket *));
+    ppvd = (dbPvd *)dbCalloc(1, sizeof(dbPvd));
+    ppvd->lock  = epicsMutexMustCreate();
+    ppvd->table = pvdTableCreate(dbPvdHashTableSize);
 
     pdbbase->ppvd = ppvd;
     return;
@@ -82,118 +222,124 @@ void dbPvdInitPvt(dbBase *pdbbase)
 PVDENTRY *dbPvdFind(dbBase *pdbbase, const char *name, size_t lenName)
 {
     dbPvd *ppvd = pdbbase->ppvd;
-    dbPvdBucket *pbucket;
+    unsigned int hash = pvdHash(name, lenName);
+    dbPvdTable *ptable, *old;
     PVDENTRY *ppvdNode;
-    
-    pbucket = ppvd->buckets[epicsMemHash(name, lenName, 0) & ppvd->mask];
-    if (pbucket == NULL) return NULL;
-
-    epicsMutexMustLock(pbucket->lock);
-    ppvdNode = (PVDENTRY *) ellFirst(&pbucket->list);
-    while (ppvdNode) {
-        const char *recordname = ppvdNode->precnode->recordname;
-
-        if (strncmp(name, recordname, lenName) == 0 &&
-            strlen(recordname) == lenName)
-            break;
-        ppvdNode = (PVDENTRY *) ellNext((ELLNODE *)ppvdNode);
-    }
-    epicsMutexUnlock(pbucket->lock);
+
+    /* Read table before old, pvdGrow() sets them the other way round */
+    ptable = (dbPvdTable *) epicsAtomicGetPtrT((EpicsAtomicPtrT *) &ppvd->table);
+    epicsAtomicReadMemoryBarrier();
+    old = (dbPvdTable *) epicsAtomicGetPtrT((EpicsAtomicPtrT *) &ppvd->old);
+    epicsAtomicReadMemoryBarrier();
+
+    ppvdNode = pvdTableFind(ptable, hash, name, lenName, NULL);
+    if (!ppvdNode && old)
+        ppvdNode = pvdTableFind(old, hash, name, lenName, NULL);
     return ppvdNode;
 }
-
+
 PVDENTRY *dbPvdAdd(dbBase *pdbbase, dbRecordType *precordType,
     dbRecordNode *precnode)
 {
     dbPvd *ppvd = pdbbase->ppvd;
-    dbPvdBucket *pbucket;
     PVDENTRY *ppvdNode;
     char *name = precnode->recordname;
-    unsigned int h;
-
-    h = epicsStrHash(name, 0) & ppvd->mask;
-    pbucket = ppvd->buckets[h];
-    if (pbucket == NULL) {
-        pbucket = dbCalloc(1, sizeof(dbPvdBucket));
-        ellInit(&pbucket->list);
-        pbucket->lock = epicsMutexCreate();
-        ppvd->buckets[h] = pbucket;
+    size_t lenName = strlen(name);
+    unsigned int hash = pvdHash(name, lenName);
+
+    epicsMutexMustLock(ppvd->lock);
+    if (pvdTableFind(ppvd->table, hash, name, lenName, NULL) ||
+        (ppvd->old && pvdTableFind(ppvd->old, hash, name, lenName, NULL))) {
+        epicsMutexUnlock(ppvd->lock);
+        return NULL;
     }
 
-    epicsMutexMustLock(pbucket->lock);
-    ppvdNode = (PVDENTRY *) ellFirst(&pbucket->list);
-    while (ppvdNode) {
-        if (strcmp(name, ppvdNode->precnode->recordname) == 0) {
-            epicsMutexUnlock(pbucket->lock);
-            return NULL;
-        }
-        ppvdNode = (PVDENTRY *) ellNext((ELLNODE *)ppvdNode);
-    }
+    if (ppvd->old)
+        pvdCopy(ppvd, COPY_SLOTS);
+    if (2 * (ppvd->table->used + 1) > ppvd->table->size)
+        pvdGrow(ppvd);
+
     ppvdNode = dbCalloc(1, sizeof(PVDENTRY));
     ppvdNode->precordType = precordType;
     ppvdNode->precnode = precnode;
-    ellAdd(&pbucket->list, (ELLNODE *)ppvdNode);
-    epicsMutexUnlock(pbucket->lock);
+    pvdTableInsert(ppvd->table, hash, ppvdNode);
+    ppvd->count++;
+    epicsMutexUnlock(ppvd->lock);
     return ppvdNode;
 }
 
 void dbPvdDelete(dbBase *pdbbase, dbRecordNode *precnode)
 {
     dbPvd *ppvd = pdbbase->ppvd;
-    dbPvdBucket *pbucket;
-    PVDENTRY *ppvdNode;
+    PVDENTRY *ppvdNode = NULL;
     char *name = precnode->recordname;
-
-    pbucket = ppvd->buckets[epicsStrHash(name, 0) & ppvd->mask];
-    if (pbucket == NULL) return;
-
-    epicsMutexMustLock(pbucket->lock);
-    ppvdNode = (PVDENTRY *) ellFirst(&pbucket->list);
-    while (ppvdNode) {
-        if (ppvdNode->precnode &&
-            ppvdNode->precnode->recordname &&
-            strcmp(name, ppvdNode->precnode->recordname) == 0) {
-            ellDelete(&pbucket->list, (ELLNODE *)ppvdNode);
-            free(ppvdNode);
-            break;
+    size_t lenName;
+    unsigned int hash;
+    dbPvdSlot *pslot;
+
+    if (!name) return;
+    lenName = strlen(name);
+    hash = pvdHash(name, lenName);
+
+    epicsMutexMustLock(ppvd->lock);
+    ppvdNode = pvdTableFind(ppvd->table, hash, name, lenName, &pslot);
+    if (ppvdNode)
+        epicsAtomicSetPtrT((EpicsAtomicPtrT *) &pslot->entry, DELETED);
+    /* An entry being copied can be in both tables */
+    if (ppvd->old) {
+        PVDENTRY *pold = pvdTableFind(ppvd->old, hash, name, lenName, &pslot);
+
+        if (pold) {
+            ppvdNode = pold;
+            epicsAtomicSetPtrT((EpicsAtomicPtrT *) &pslot->entry, DELETED);
         }
-        ppvdNode = (PVDENTRY *) ellNext((ELLNODE *)ppvdNode);
     }
-    epicsMutexUnlock(pbucket->lock);
+    if (ppvdNode) {
+        /* A lookup may still be using it */
+        ppvd->count--;
+        ellAdd(&ppvd->deleted, &ppvdNode->node);
+    }
+    epicsMutexUnlock(ppvd->lock);
     return;
 }
 
 void dbPvdFreeMem(dbBase *pdbbase)
 {
     dbPvd *ppvd = pdbbase->ppvd;
+    dbPvdTable *ptable;
+    PVDENTRY *ppvdNode;
     unsigned int h;
 
     if (ppvd == NULL) return;
     pdbbase->ppvd = NULL;
 
-    for (h = 0; h < ppvd->size; h++) {
-        dbPvdBucket *pbucket = ppvd->buckets[h];
-        PVDENTRY *ppvdNode;
+    epicsMutexMustLock(ppvd->lock);
+    if (ppvd->old)
+        pvdCopy(ppvd, ppvd->old->size);
+    ptable = ppvd->table;
+    for (h = 0; h < ptable->size; h++) {
+        ppvdNode = ptable->slots[h].entry;
 
-        if (pbucket == NULL) continue;
-        epicsMutexMustLock(pbucket->lock);
-        ppvd->buckets[h] = NULL;
-        while ((ppvdNode = (PVDENTRY *) ellFirst(&pbucket->list))) {
-            ellDelete(&pbucket->list, (ELLNODE *)ppvdNode);
+        if (ppvdNode && ppvdNode != DELETED)
             free(ppvdNode);
-        }
-        epicsMutexUnlock(pbucket->lock);
-        epicsMutexDestroy(pbucket->lock);
-        free(pbucket);
     }
-    free(ppvd->buckets);
+    pvdTableFree(ptable);
+    while ((ppvdNode = (PVDENTRY *) ellGet(&ppvd->deleted)))
+        free(ppvdNode);
+    while ((ptable = ppvd->replaced)) {
+        ppvd->replaced = ptable->next;
+        pvdTableFree(ptable);
+    }
+    epicsMutexUnlock(ppvd->lock);
+    epicsMutexDestroy(ppvd->lock);
     free(ppvd);
 }
 
 void dbPvdDump(dbBase *pdbbase, int verbose)
 {
-    unsigned int empty = 0;
+    unsigned int deleted = 0, probes = 0, maxProbes = 0;
     dbPvd *ppvd;
+    dbPvdTable *ptable;
     unsigned int h;
 
     if (!pdbbase) {
@@ -203,27 +349,37 @@ void dbPvdDump(dbBase *pdbbase, int verbose)
     ppvd = pdbbase->ppvd;
     if (ppvd == NULL) return;
 
-    printf("Process Variable Directory has %u buckets", ppvd->size);
+    epicsMutexMustLock(ppvd->lock);
+    ptable = ppvd->table;
+    printf("Process Variable Directory has %u records in %u slots",
+        ppvd->count, ptable->size);
+    if (ppvd->old)
+        printf(", resizing from %u slots (%u copied)",
+            ppvd->old->size, ppvd->copied);
 
-    for (h = 0; h < ppvd->size; h++) {
-        dbPvdBucket *pbucket = ppvd->buckets[h];
-        PVDENTRY *ppvdNode;
-        int i = 1;
+    for (h = 0; h < ptable->size; h++) {
+        PVDENTRY *ppvdNode = ptable->slots[h].entry;
+        unsigned int probe;
 
-        if (pbucket == NULL) {
-            empty++;
+        if (ppvdNode == NULL)
+            continue;
+        if (ppvdNode == DELETED) {
+            deleted++;
             continue;
         }
-        epicsMutexMustLock(pbucket->lock);
-        ppvdNode = (PVDENTRY *) ellFirst(&pbucket->list);
-        printf("\n [%4u] %4d  ", h, ellCount(&pbucket->list));
-        while (ppvdNode && verbose) {
-            if (!(++i % 4))
-                printf("\n         ");
-            printf("  %s", ppvdNode->precnode->recordname);
-            ppvdNode = (PVDENTRY *) ellNext((ELLNODE*)ppvdNode);
-        }
-        epicsMutexUnlock(pbucket->lock);
+        /* Number of slots examined to find this entry */
+        probe = ((h - ptable->slots[h].hash) & ptable->mask) + 1;
+        probes += probe;
+        if (probe > maxProbes)
+            maxProbes = probe;
+        if (verbose)
+            printf("\n [%6u] %3u  %s", h, probe,
+                ppvdNode->precnode->recordname);
     }
-    printf("\n%u buckets empty.\n", empty);
+    printf("\n%u slots used, %u deleted", ptable->used, deleted);
+    if (ptable->used > deleted)
+        printf(", %.2f probes per lookup, %u maximum",
+            (double) probes / (ptable->used - deleted), maxProbes);
+    printf("\n");
+    epicsMutexUnlock(ppvd->lock);
 }
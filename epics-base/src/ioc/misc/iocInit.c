@@ -52,6 +52,7 @@
 #include "dbFldTypes.h"
 #include "dbLock.h"
 #include "dbNotify.h"
+#include "dbProfile.h"
 #include "dbScan.h"
 #include "dbStaticLib.h"
 #include "dbStaticPvt.h"
@@ -713,6 +714,7 @@ int iocShutdown(void)
         /* free resources */
         scanCleanup();
         callbackCleanup();
+        dbProfileCleanup();
         iterateRecords(doFreeRecord, NULL);
         dbLockCleanupRecords(pdbbase);
         asShutdown();
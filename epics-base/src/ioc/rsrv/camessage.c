@@ -384,6 +384,12 @@ static int tcp_version_action ( caHdrLargeArray *mp, void *pPayload,
         return RSRV_ERROR;
     }
 
+    if ( client->pReactor ) {
+        /* reactor workers serve higher priority clients first */
+        client->priority = mp->m_dataType;
+        return RSRV_OK;
+    }
+
     tmp = mp->m_dataType - CA_PROTO_PRIORITY_MIN;
     tmp *= epicsThreadPriorityCAServerHigh - epicsThreadPriorityCAServerLow;
     tmp /= CA_PROTO_PRIORITY_MAX - CA_PROTO_PRIORITY_MIN;
@@ -1792,7 +1798,9 @@ static int write_notify_action ( caHdrLargeArray *mp, void *pPayload,
         epicsMutexMustLock(client->putNotifyLock);
         while(pciu->pPutNotify->busy){
             epicsMutexUnlock(client->putNotifyLock);
+            casReactorBlocking(client, TRUE);
             status = epicsEventWaitWithTimeout(client->blockSem,60.0);
+            casReactorBlocking(client, FALSE);
             if ( status != epicsEventWaitOK ) {
                 char busyTmp;
                 void * asWritePvtTmp = 0;
@@ -94,63 +94,12 @@ void camsgtask ( void *pParm )
                 continue;
             }
 
-            /*
-             * normal conn lost conditions
-             */
-            if (    ( anerrno != SOCK_ECONNABORTED &&
-                anerrno != SOCK_ECONNRESET &&
-                anerrno != SOCK_ETIMEDOUT ) ||
-                CASDEBUG > 2 ) {
-                char sockErrBuf[64];
-
-                epicsSocketConvertErrorToString(
-                    sockErrBuf, sizeof ( sockErrBuf ), anerrno);
-                errlogPrintf ( "CAS: Client disconnected - %s\n",
-                    sockErrBuf );
-            }
+            casLogRecvError ( anerrno );
             break;
         }
 
-        epicsTimeGetCurrent ( &client->time_at_last_recv );
-        client->recv.cnt += ( unsigned ) nchars;
-
-        status = camessage ( client );
-        if (status == 0) {
-            /*
-             * if there is a partial message
-             * align it with the start of the buffer
-             */
-            if (client->recv.cnt > client->recv.stk) {
-                unsigned bytes_left;
-
-                bytes_left = client->recv.cnt - client->recv.stk;
-
-                /*
-                 * overlapping regions handled
-                 * properly by memmove 
-                 */
-                memmove (client->recv.buf, 
-                    &client->recv.buf[client->recv.stk], bytes_left);
-                client->recv.cnt = bytes_left;
-            }
-            else {
-                client->recv.cnt = 0ul;
-            }
-        }
-        else {
-            char buf[64];
-
-            /* flush any queued messages before shutdown */
-            cas_send_bs_msg(client, 1);
-            
-            client->recv.cnt = 0ul;
-            
-            /*
-             * disconnect when there are severe message errors
-             */
-            ipAddrToDottedIP (&client->addr, buf, sizeof(buf));
-            epicsPrintf ("CAS: forcing disconnect from %s\n", buf);
-                break;
+        if ( casProcessRecv ( client, nchars ) != RSRV_OK ) {
+            break;
         }
     }
 
@@ -162,6 +111,84 @@ void camsgtask ( void *pParm )
 }
 
 
+/*
+ *  casLogRecvError()
+ *
+ *  Report a failed receive unless the connection was simply lost
+ */
+void casLogRecvError ( int anerrno )
+{
+    /*
+     * normal conn lost conditions
+     */
+    if (    ( anerrno != SOCK_ECONNABORTED &&
+        anerrno != SOCK_ECONNRESET &&
+        anerrno != SOCK_ETIMEDOUT ) ||
+        CASDEBUG > 2 ) {
+        char sockErrBuf[64];
+
+        epicsSocketConvertErrorToString(
+            sockErrBuf, sizeof ( sockErrBuf ), anerrno);
+        errlogPrintf ( "CAS: Client disconnected - %s\n",
+            sockErrBuf );
+    }
+}
+
+/*
+ *  casProcessRecv()
+ *
+ *  Process the requests in nchars bytes just received into the
+ *  client's receive buffer. Returns RSRV_ERROR if the client
+ *  must be disconnected.
+ */
+int casProcessRecv ( struct client *client, long nchars )
+{
+    int status;
+
+    epicsTimeGetCurrent ( &client->time_at_last_recv );
+    client->recv.cnt += ( unsigned ) nchars;
+
+    status = camessage ( client );
+    if (status == 0) {
+        /*
+         * if there is a partial message
+         * align it with the start of the buffer
+         */
+        if (client->recv.cnt > client->recv.stk) {
+            unsigned bytes_left;
+
+            bytes_left = client->recv.cnt - client->recv.stk;
+
+            /*
+             * overlapping regions handled
+             * properly by memmove 
+             */
+            memmove (client->recv.buf, 
+                &client->recv.buf[client->recv.stk], bytes_left);
+            client->recv.cnt = bytes_left;
+        }
+        else {
+            client->recv.cnt = 0ul;
+        }
+    }
+    else {
+        char buf[64];
+
+        /* flush any queued messages before shutdown */
+        cas_send_bs_msg(client, 1);
+        
+        client->recv.cnt = 0ul;
+        
+        /*
+         * disconnect when there are severe message errors
+         */
+        ipAddrToDottedIP (&client->addr, buf, sizeof(buf));
+        epicsPrintf ("CAS: forcing disconnect from %s\n", buf);
+        return RSRV_ERROR;
+    }
+    return RSRV_OK;
+}
+
 int casClientInitiatingCurrentThread ( char * pBuf, size_t bufSize )
 {
     struct client * pClient = ( struct client * )
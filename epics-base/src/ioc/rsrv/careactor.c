@@ -0,0 +1,624 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *  CA server event loop
+ *
+ *  Instead of a receive thread and an event thread for every TCP
+ *  client, one thread waits for requests from all clients with epoll
+ *  and a small pool of worker threads parses the requests and runs
+ *  the clients' event queues. Enabled by setting rsrvReactorThreads
+ *  to the number of worker threads before iocInit.
+ *
+ *  Replies are still sent by the worker, but a worker that finds a
+ *  client's socket buffer full counts as blocked while it waits, so
+ *  other clients keep being served, and a client that takes nothing
+ *  for CAS_REACTOR_SEND_TMO seconds is disconnected.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "cantProceed.h"
+#include "dbDefs.h"
+#include "ellLib.h"
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsSignal.h"
+#include "epicsStdio.h"
+#include "epicsThread.h"
+#include "errlog.h"
+#include "osiSock.h"
+#include "taskwd.h"
+
+#define epicsExportSharedSymbols
+#include "dbEvent.h"
+#include "rsrv.h"
+#include "server.h"
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <sys/time.h>
+
+/* Receives from one client before letting other clients in */
+#define CAS_REACTOR_READS 16
+/* Socket events fetched by each epoll_wait() */
+#define CAS_REACTOR_EVENTS 64
+/* Seconds a client may take no replies before it is disconnected */
+#define CAS_REACTOR_SEND_TMO 10
+
+typedef struct casReactorClient casReactorClient;
+
+/*
+ * Work for a client that is run by one worker at a time.
+ * queued, running, again and deferred are guarded by reactor.lock
+ */
+typedef struct casWork {
+    ELLNODE             node;
+    casReactorClient    *pRC;
+    int                 (*run) ( casReactorClient *pRC );
+    char                queued;     /* on reactor.workQ */
+    char                running;    /* being run by a worker */
+    char                again;      /* queued again while running */
+    char                deferred;   /* dequeued while the client stalled */
+} casWork;
+
+struct casReactorClient {
+    struct client       *client;
+    casWork             recvWork;   /* requests from the socket */
+    casWork             eventWork;  /* monitors and extra labor */
+    char                closing;    /* no more event work */
+    char                stalled;    /* waiting in casReactorSend() */
+};
+
+static struct {
+    epicsMutexId        lock;
+    epicsEventId        workAvail;
+    epicsEventId        workDone;
+    ELLLIST             workQ;
+    int                 epfd;
+    unsigned            nThreads;   /* configured workers */
+    unsigned            nWorkers;   /* running workers */
+    unsigned            nIdle;
+    unsigned            nBlocked;   /* see casReactorBlocking() */
+} reactor;
+
+/*
+ * Add work to the queue, higher priority clients first.
+ * Returns TRUE if a worker should be woken.
+ */
+static int workQueue ( casWork *pWork )
+{
+    unsigned priority = pWork->pRC->client->priority;
+    ELLNODE *pnode;
+
+    if ( pWork->running ) {
+        pWork->again = TRUE;
+        return FALSE;
+    }
+    if ( pWork->queued ) {
+        return FALSE;
+    }
+    for ( pnode = ellLast ( &reactor.workQ ); pnode;
+            pnode = ellPrevious ( pnode ) ) {
+        casWork *pOther = CONTAINER ( pnode, casWork, node );
+
+        if ( pOther->pRC->client->priority >= priority ) {
+            break;
+        }
+    }
+    ellInsert ( &reactor.workQ, pnode, &pWork->node );
+    pWork->queued = TRUE;
+    return TRUE;
+}
+
+/*
+ * Queue work that was put aside while its client stalled.
+ * Returns TRUE if a worker should be woken.
+ */
+static int workResume ( casWork *pWork )
+{
+    if ( ! pWork->deferred ) {
+        return FALSE;
+    }
+    pWork->deferred = FALSE;
+    return workQueue ( pWork );
+}
+
+static int startWorker ( void );
+
+/*
+ *  casWorker()
+ */
+static void casWorker ( void *pParm )
+{
+    epicsSignalInstallSigAlarmIgnore ();
+    epicsSignalInstallSigPipeIgnore ();
+    taskwdInsert ( epicsThreadGetIdSelf (), NULL, NULL );
+
+    epicsMutexMustLock ( reactor.lock );
+    while ( TRUE ) {
+        casWork *pWork = (casWork *) ellGet ( &reactor.workQ );
+        int gone;
+
+        if ( ! pWork ) {
+            /* extra workers exit once nobody is blocked */
+            if ( reactor.nWorkers > reactor.nThreads + reactor.nBlocked ) {
+                break;
+            }
+            reactor.nIdle++;
+            epicsMutexUnlock ( reactor.lock );
+            epicsEventMustWait ( reactor.workAvail );
+            epicsMutexMustLock ( reactor.lock );
+            reactor.nIdle--;
+            continue;
+        }
+
+        pWork->queued = FALSE;
+        if ( pWork->pRC->stalled ) {
+            /* it would only wait for the send lock */
+            pWork->deferred = TRUE;
+            continue;
+        }
+        pWork->running = TRUE;
+        if ( reactor.nIdle && ellCount ( &reactor.workQ ) ) {
+            epicsEventSignal ( reactor.workAvail );
+        }
+
+        do {
+            pWork->again = FALSE;
+            epicsMutexUnlock ( reactor.lock );
+
+            epicsThreadPrivateSet ( rsrvCurrentClient, pWork->pRC->client );
+            gone = ( *pWork->run ) ( pWork->pRC );
+            epicsThreadPrivateSet ( rsrvCurrentClient, NULL );
+
+            epicsMutexMustLock ( reactor.lock );
+        } while ( ! gone && pWork->again );
+
+        /* the client and its work are freed if gone */
+        if ( ! gone ) {
+            pWork->running = FALSE;
+            if ( pWork->pRC->closing ) {
+                epicsEventSignal ( reactor.workDone );
+            }
+        }
+    }
+    reactor.nWorkers--;
+    epicsMutexUnlock ( reactor.lock );
+
+    taskwdRemove ( epicsThreadGetIdSelf () );
+}
+
+static int startWorker ( void )
+{
+    return epicsThreadCreate ( "CAS-worker", epicsThreadPriorityCAServerLow,
+        epicsThreadGetStackSize ( epicsThreadStackBig ),
+        casWorker, NULL ) != 0;
+}
+
+/*
+ *  casClose()
+ *
+ *  Disconnect a client, from its receive work
+ */
+static int casClose ( casReactorClient *pRC )
+{
+    struct client *client = pRC->client;
+
+    if ( client->sock != INVALID_SOCKET ) {
+        epoll_ctl ( reactor.epfd, EPOLL_CTL_DEL, client->sock, NULL );
+    }
+
+    LOCK_CLIENTQ;
+    ellDelete ( &clientQ, &client->node );
+    UNLOCK_CLIENTQ;
+
+    /* frees pRC */
+    destroy_tcp_client ( client );
+    return TRUE;
+}
+
+/*
+ *  casRecvRun()
+ *
+ *  Read and process requests until the socket is empty, then send
+ *  the replies and wait for more. Returns TRUE if the client was
+ *  disconnected.
+ */
+static int casRecvRun ( casReactorClient *pRC )
+{
+    struct client *client = pRC->client;
+    struct epoll_event ev;
+    int nreads = 0;
+
+    while ( nreads < CAS_REACTOR_READS ) {
+        long nchars;
+
+        if ( castcp_ctl != ctlRun || client->disconnect ) {
+            return casClose ( pRC );
+        }
+
+        client->recv.stk = 0;
+        assert ( client->recv.maxstk >= client->recv.cnt );
+        nchars = recv ( client->sock, &client->recv.buf[client->recv.cnt],
+                (int) ( client->recv.maxstk - client->recv.cnt ), MSG_DONTWAIT );
+        if ( nchars == 0 ) {
+            if ( CASDEBUG > 0 ) {
+                errlogPrintf ( "CAS: nill message disconnect\n" );
+            }
+            return casClose ( pRC );
+        }
+        else if ( nchars < 0 ) {
+            int anerrno = SOCKERRNO;
+
+            if ( anerrno == SOCK_EINTR ) {
+                continue;
+            }
+            if ( anerrno == SOCK_EWOULDBLOCK || anerrno == SOCK_ENOBUFS ) {
+                break;
+            }
+            casLogRecvError ( anerrno );
+            return casClose ( pRC );
+        }
+
+        if ( casProcessRecv ( client, nchars ) != RSRV_OK ) {
+            return casClose ( pRC );
+        }
+        nreads++;
+    }
+
+    cas_send_bs_msg ( client, TRUE );
+    if ( client->disconnect ) {
+        return casClose ( pRC );
+    }
+
+    memset ( &ev, 0, sizeof ( ev ) );
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = pRC;
+    if ( epoll_ctl ( reactor.epfd, EPOLL_CTL_MOD, client->sock, &ev ) < 0 ) {
+        char sockErrBuf[64];
+
+        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+        errlogPrintf ( "CAS: epoll_ctl error: %s\n", sockErrBuf );
+        return casClose ( pRC );
+    }
+    return FALSE;
+}
+
+/*
+ *  casEventRun()
+ */
+static int casEventRun ( casReactorClient *pRC )
+{
+    db_process_events ( pRC->client->evuser );
+    return FALSE;
+}
+
+/*
+ *  casEventWakeup()
+ *
+ *  Called by the event facility when a client has monitors or
+ *  extra labor waiting
+ */
+static void casEventWakeup ( void *pArg )
+{
+    struct client *pClient = (struct client *) pArg;
+    int wake = FALSE;
+
+    epicsMutexMustLock ( reactor.lock );
+    if ( pClient->pReactor && ! pClient->pReactor->closing ) {
+        wake = workQueue ( &pClient->pReactor->eventWork );
+    }
+    epicsMutexUnlock ( reactor.lock );
+
+    if ( wake ) {
+        epicsEventSignal ( reactor.workAvail );
+    }
+}
+
+/*
+ *  casReactorTask()
+ */
+static void casReactorTask ( void *pParm )
+{
+    struct epoll_event events[CAS_REACTOR_EVENTS];
+
+    taskwdInsert ( epicsThreadGetIdSelf (), NULL, NULL );
+
+    while ( TRUE ) {
+        int i, n, wake = FALSE;
+
+        n = epoll_wait ( reactor.epfd, events, CAS_REACTOR_EVENTS, -1 );
+        if ( n < 0 ) {
+            if ( errno != EINTR ) {
+                char sockErrBuf[64];
+
+                epicsSocketConvertErrnoToString (
+                    sockErrBuf, sizeof ( sockErrBuf ) );
+                errlogPrintf ( "CAS: epoll_wait error: %s\n", sockErrBuf );
+                epicsThreadSleep ( 1.0 );
+            }
+            continue;
+        }
+
+        /* sockets are disarmed until their receive work re-arms them */
+        epicsMutexMustLock ( reactor.lock );
+        for ( i = 0; i < n; i++ ) {
+            casReactorClient *pRC = (casReactorClient *) events[i].data.ptr;
+
+            wake |= workQueue ( &pRC->recvWork );
+        }
+        epicsMutexUnlock ( reactor.lock );
+
+        if ( wake ) {
+            epicsEventSignal ( reactor.workAvail );
+        }
+    }
+}
+
+int casReactorInit ( unsigned nThreads )
+{
+    unsigned i;
+
+    if ( reactor.lock ) {
+        return RSRV_OK;
+    }
+
+    reactor.epfd = epoll_create ( CAS_REACTOR_EVENTS );
+    if ( reactor.epfd < 0 ) {
+        char sockErrBuf[64];
+
+        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+        errlogPrintf ( "CAS: epoll_create error: %s\n", sockErrBuf );
+        return RSRV_ERROR;
+    }
+
+    ellInit ( &reactor.workQ );
+    reactor.workAvail = epicsEventMustCreate ( epicsEventEmpty );
+    reactor.workDone = epicsEventMustCreate ( epicsEventEmpty );
+    reactor.nThreads = nThreads ? nThreads : 1;
+    reactor.lock = epicsMutexMustCreate ();
+
+    epicsThreadMustCreate ( "CAS-reactor", epicsThreadPriorityCAServerLow,
+        epicsThreadGetStackSize ( epicsThreadStackSmall ),
+        casReactorTask, NULL );
+
+    epicsMutexMustLock ( reactor.lock );
+    for ( i = 0; i < reactor.nThreads; i++ ) {
+        if ( ! startWorker () ) {
+            cantProceed ( "CAS: unable to start reactor worker threads\n" );
+        }
+        reactor.nWorkers++;
+    }
+    epicsMutexUnlock ( reactor.lock );
+
+    return RSRV_OK;
+}
+
+/*
+ *  casReactorAttach()
+ *
+ *  Have the workers run the event queue of a new client, fails
+ *  if the reactor isn't in use
+ */
+int casReactorAttach ( struct client *pClient )
+{
+    casReactorClient *pRC;
+
+    if ( ! reactor.lock ) {
+        return RSRV_ERROR;
+    }
+
+    pRC = calloc ( 1, sizeof ( casReactorClient ) );
+    if ( ! pRC ) {
+        return RSRV_ERROR;
+    }
+    pRC->client = pClient;
+    pRC->recvWork.pRC = pRC;
+    pRC->recvWork.run = casRecvRun;
+    pRC->eventWork.pRC = pRC;
+    pRC->eventWork.run = casEventRun;
+    pClient->pReactor = pRC;
+
+    if ( db_start_events_polled ( pClient->evuser,
+            casEventWakeup, pClient ) != DB_EVENT_OK ) {
+        pClient->pReactor = NULL;
+        free ( pRC );
+        return RSRV_ERROR;
+    }
+    return RSRV_OK;
+}
+
+/*
+ *  casReactorAdd()
+ *
+ *  Start serving requests from an attached client. Once this
+ *  returns RSRV_OK the client belongs to the workers.
+ */
+int casReactorAdd ( struct client *pClient )
+{
+    struct epoll_event ev;
+    struct timeval tmo;
+
+    /* bound the time casReactorSend() waits for a client */
+    tmo.tv_sec = CAS_REACTOR_SEND_TMO;
+    tmo.tv_usec = 0;
+    if ( setsockopt ( pClient->sock, SOL_SOCKET, SO_SNDTIMEO,
+            (char *) &tmo, sizeof ( tmo ) ) < 0 ) {
+        char sockErrBuf[64];
+
+        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+        errlogPrintf ( "CAS: SO_SNDTIMEO set failed: %s\n", sockErrBuf );
+        return RSRV_ERROR;
+    }
+
+    /* the version reply queued by create_tcp_client() */
+    cas_send_bs_msg ( pClient, TRUE );
+
+    memset ( &ev, 0, sizeof ( ev ) );
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = pClient->pReactor;
+    if ( epoll_ctl ( reactor.epfd, EPOLL_CTL_ADD, pClient->sock, &ev ) < 0 ) {
+        char sockErrBuf[64];
+
+        epicsSocketConvertErrnoToString ( sockErrBuf, sizeof ( sockErrBuf ) );
+        errlogPrintf ( "CAS: epoll_ctl error: %s\n", sockErrBuf );
+        return RSRV_ERROR;
+    }
+    return RSRV_OK;
+}
+
+/*
+ *  casReactorDetach()
+ *
+ *  Stop running the client's event queue, called by
+ *  destroy_tcp_client()
+ */
+void casReactorDetach ( struct client *pClient )
+{
+    casReactorClient *pRC = pClient->pReactor;
+
+    if ( ! pRC ) {
+        return;
+    }
+
+    epicsMutexMustLock ( reactor.lock );
+    pRC->closing = TRUE;
+    if ( pRC->eventWork.queued ) {
+        ellDelete ( &reactor.workQ, &pRC->eventWork.node );
+        pRC->eventWork.queued = FALSE;
+    }
+    while ( pRC->eventWork.running ) {
+        epicsMutexUnlock ( reactor.lock );
+        epicsEventWaitWithTimeout ( reactor.workDone, 0.1 );
+        epicsMutexMustLock ( reactor.lock );
+    }
+    pClient->pReactor = NULL;
+    epicsMutexUnlock ( reactor.lock );
+
+    free ( pRC );
+}
+
+/*
+ *  casReactorSend()
+ *
+ *  send() for cas_send_bs_msg(). When the socket buffer is full the
+ *  worker waits, for at most the send timeout, as a blocked worker.
+ *  A timeout fails with SOCK_EWOULDBLOCK.
+ */
+int casReactorSend ( struct client *pClient, const char *pBuf, unsigned len )
+{
+    casReactorClient *pRC = pClient->pReactor;
+    int status = send ( pClient->sock, pBuf, len, MSG_DONTWAIT );
+    int anerrno, wake;
+
+    if ( status >= 0 || SOCKERRNO != SOCK_EWOULDBLOCK ) {
+        return status;
+    }
+
+    epicsMutexMustLock ( reactor.lock );
+    pRC->stalled = TRUE;
+    epicsMutexUnlock ( reactor.lock );
+
+    casReactorBlocking ( pClient, TRUE );
+    status = send ( pClient->sock, pBuf, len, 0 );
+    anerrno = SOCKERRNO;
+    casReactorBlocking ( pClient, FALSE );
+
+    epicsMutexMustLock ( reactor.lock );
+    pRC->stalled = FALSE;
+    wake = workResume ( &pRC->recvWork );
+    wake |= workResume ( &pRC->eventWork );
+    epicsMutexUnlock ( reactor.lock );
+
+    if ( wake ) {
+        epicsEventSignal ( reactor.workAvail );
+    }
+    errno = anerrno;
+    return status;
+}
+
+/*
+ *  casReactorBlocking()
+ *
+ *  Called around waits by a worker for another thread. Starts an
+ *  extra worker while too many are blocked, so the work that will
+ *  end the wait can still run.
+ */
+void casReactorBlocking ( struct client *pClient, int blocking )
+{
+    int start = FALSE;
+
+    if ( ! pClient->pReactor ) {
+        return;
+    }
+
+    epicsMutexMustLock ( reactor.lock );
+    if ( blocking ) {
+        reactor.nBlocked++;
+        if ( reactor.nWorkers < reactor.nThreads + reactor.nBlocked ) {
+            reactor.nWorkers++;
+            start = TRUE;
+        }
+    }
+    else {
+        reactor.nBlocked--;
+    }
+    epicsMutexUnlock ( reactor.lock );
+
+    if ( start && ! startWorker () ) {
+        epicsMutexMustLock ( reactor.lock );
+        reactor.nWorkers--;
+        epicsMutexUnlock ( reactor.lock );
+    }
+}
+
+void casReactorShow ( unsigned level )
+{
+    if ( ! reactor.lock ) {
+        return;
+    }
+
+    epicsMutexMustLock ( reactor.lock );
+    printf ( "Reactor with %u worker threads, %u idle, %u blocked, "
+        "%d clients waiting\n", reactor.nWorkers, reactor.nIdle,
+        reactor.nBlocked, ellCount ( &reactor.workQ ) );
+    epicsMutexUnlock ( reactor.lock );
+}
+
+#else /* __linux__ */
+
+int casReactorInit ( unsigned nThreads )
+{
+    errlogPrintf ( "CAS: rsrvReactorThreads is not supported on this target\n" );
+    return RSRV_ERROR;
+}
+
+int casReactorAttach ( struct client *pClient )
+{
+    return RSRV_ERROR;
+}
+
+int casReactorAdd ( struct client *pClient )
+{
+    return RSRV_ERROR;
+}
+
+void casReactorDetach ( struct client *pClient ) {}
+
+int casReactorSend ( struct client *pClient, const char *pBuf, unsigned len )
+{
+    return send ( pClient->sock, pBuf, len, 0 );
+}
+
+void casReactorBlocking ( struct client *pClient, int blocking ) {}
+
+void casReactorShow ( unsigned level ) {}
+
+#endif /* __linux__ */
@@ -65,7 +65,14 @@ void cas_send_bs_msg ( struct client *pclient, int lock_needed )
     }
 
     while ( pclient->send.stk && ! pclient->disconnect ) {
-        status = send ( pclient->sock, pclient->send.buf, pclient->send.stk, 0 );
+        if ( pclient->pReactor ) {
+            status = casReactorSend ( pclient, pclient->send.buf,
+                pclient->send.stk );
+        }
+        else {
+            status = send ( pclient->sock, pclient->send.buf,
+                pclient->send.stk, 0 );
+        }
         if ( status >= 0 ) {
             unsigned transferSize = (unsigned) status;
             if ( transferSize >= pclient->send.stk ) {
@@ -110,6 +117,10 @@ void cas_send_bs_msg ( struct client *pclient, int lock_needed )
                 anerrno == SOCK_ETIMEDOUT ) {
                 causeWasSocketHangup = 1;
             }
+            else if ( anerrno == SOCK_EWOULDBLOCK ) {
+                /* casReactorSend() timed out */
+                errlogPrintf ( "CAS: TCP send to %s timed out\n", buf );
+            }
             else {
                 char sockErrBuf[64];
                 epicsSocketConvertErrnoToString ( 
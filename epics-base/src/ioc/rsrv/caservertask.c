@@ -113,15 +113,26 @@ static void req_server (void *pParm)
             ellAdd ( &clientQ, &pClient->node );
             UNLOCK_CLIENTQ;
 
-            id = epicsThreadCreate ( "CAS-client", epicsThreadPriorityCAServerLow,
-                    epicsThreadGetStackSize ( epicsThreadStackBig ),
-                    camsgtask, pClient );
+            if ( pClient->pReactor ) {
+                /* the client belongs to the reactor once added */
+                if ( casReactorAdd ( pClient ) == RSRV_OK ) {
+                    continue;
+                }
+                id = 0;
+            }
+            else {
+                id = epicsThreadCreate ( "CAS-client", epicsThreadPriorityCAServerLow,
+                        epicsThreadGetStackSize ( epicsThreadStackBig ),
+                        camsgtask, pClient );
+                if ( id == 0 ) {
+                    errlogPrintf ( "CAS: task creation for new client failed\n" );
+                }
+            }
             if ( id == 0 ) {
                 LOCK_CLIENTQ;
                 ellDelete ( &clientQ, &pClient->node );
                 UNLOCK_CLIENTQ;
                 destroy_tcp_client ( pClient );
-                errlogPrintf ( "CAS: task creation for new client failed\n" );
                 epicsThreadSleep ( 15.0 );
                 continue;
             }
@@ -481,6 +492,11 @@ int rsrv_init (void)
 
     rsrvCurrentClient = epicsThreadPrivateCreate ();
 
+    /* clients fall back to their own threads if this fails */
+    if ( rsrvReactorThreads > 0 ) {
+        casReactorInit ( (unsigned) rsrvReactorThreads );
+    }
+
     dbRegisterServer(&rsrv_server);
 
     if ( envGetConfigParamPtr ( &EPICS_CAS_SERVER_PORT ) ) {
@@ -923,6 +939,10 @@ void casr (unsigned level)
     }
     UNLOCK_CLIENTQ
 
+    if (level>=1) {
+        casReactorShow (level);
+    }
+
     if (level>=1) {
         rsrv_iface_config *iface = (rsrv_iface_config *) ellFirst ( &servers );
         while (iface) {
@@ -1184,6 +1204,11 @@ void destroy_tcp_client ( struct client *client )
         errlogPrintf ( "CAS: Connection %d Terminated\n", client->sock );
     }
 
+    /*
+     * wait for any reactor worker running the event queue
+     */
+    casReactorDetach ( client );
+
     if ( client->evuser ) {
         /*
          * turn off extra labor callbacks from the event thread
@@ -1440,8 +1465,16 @@ struct client *create_tcp_client ( SOCKET sock )
         }
     }
 
-    status = db_start_events ( client->evuser, "CAS-event",
-                NULL, NULL, priorityOfEvents );
+    /*
+     * under the reactor the worker threads run the event queue
+     */
+    if ( casReactorAttach ( client ) == RSRV_OK ) {
+        status = DB_EVENT_OK;
+    }
+    else {
+        status = db_start_events ( client->evuser, "CAS-event",
+                    NULL, NULL, priorityOfEvents );
+    }
     if ( status != DB_EVENT_OK ) {
         errlogPrintf ( "CAS: unable to start the event facility\n" );
         destroy_tcp_client ( client );
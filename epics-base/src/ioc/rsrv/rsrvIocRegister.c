@@ -32,3 +32,4 @@ void rsrvIocRegister(void)
 }
 
 epicsExportAddress(int, CASDEBUG);
+epicsExportAddress(int, rsrvReactorThreads);
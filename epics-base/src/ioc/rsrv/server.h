@@ -100,6 +100,7 @@ typedef struct client {
   ca_uint32_t           seqNoOfReq; /* for udp  */
   unsigned              recvBytesToDrain;
   unsigned              priority;
+  struct casReactorClient *pReactor; /* NULL unless served by the reactor */
   char                  disconnect; /* disconnect detected */
 } client;
 
@@ -188,6 +189,7 @@ enum ctl {ctlInit, ctlRun, ctlPause, ctlExit};
 #endif
 
 GLBLTYPE int                CASDEBUG;
+GLBLTYPE int                rsrvReactorThreads; /* 0 for a thread per client */
 GLBLTYPE unsigned short     ca_server_port, ca_udp_port, ca_beacon_port;
 GLBLTYPE ELLLIST            clientQ             GLBLTYPE_INIT(ELLLIST_INIT);
 GLBLTYPE ELLLIST            servers; /* rsrv_iface_config::node, read-only after rsrv_init() */
@@ -224,6 +226,8 @@ GLBLTYPE unsigned int       threadPrios[5];
 #define UNLOCK_CLIENTQ  epicsMutexUnlock (clientQlock);
 
 void camsgtask (void *client);
+int casProcessRecv ( struct client *client, long nchars );
+void casLogRecvError ( int anerrno );
 void cas_send_bs_msg ( struct client *pclient, int lock_needed );
 void cas_send_dg_msg ( struct client *pclient );
 void rsrv_online_notify_task (void *);
@@ -242,6 +246,17 @@ void rsrvFreePutNotify ( struct client *pClient,
 void initializePutNotifyFreeList (void);
 unsigned rsrvSizeOfPutNotify ( struct rsrv_put_notify *pNotify );
 
+/*
+ * event loop serving TCP clients from a pool of threads
+ */
+int casReactorInit ( unsigned nThreads );
+int casReactorAttach ( struct client *pClient );
+int casReactorAdd ( struct client *pClient );
+void casReactorDetach ( struct client *pClient );
+int casReactorSend ( struct client *pClient, const char *pBuf, unsigned len );
+void casReactorBlocking ( struct client *pClient, int blocking );
+void casReactorShow ( unsigned level );
+
 /*
  * inclming protocol maintetnance
  */
@@ -0,0 +1,307 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ *   EPICS device support for periodic scan list statistics
+ *
+ *   The INP/OUT link is "@<item> <scan>", where <scan> is one of the
+ *   periodic menuScan choices, e.g. "@MAX 1 second".
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "alarm.h"
+#include "dbDefs.h"
+#include "dbAccess.h"
+#include "dbScan.h"
+#include "dbStaticLib.h"
+#include "recGbl.h"
+#include "devSup.h"
+#include "epicsString.h"
+
+#include "aiRecord.h"
+#include "boRecord.h"
+#include "longinRecord.h"
+#include "stringinRecord.h"
+#include "waveformRecord.h"
+#include "epicsExport.h"
+
+struct channel {
+    char *name;
+    size_t offset;
+};
+
+typedef struct devPvt {
+    int scan;
+    size_t offset;
+} devPvt;
+
+static long init_common(dbCommon *prec, struct link *plink,
+    struct channel *channels, int nchannels, const char *func)
+{
+    dbMenu *pmenu = dbFindMenu(pdbbase, "menuScan");
+    const char *parm;
+    size_t len;
+    int i, scan;
+
+    if (plink->type != INST_IO) {
+        recGblRecordError(S_db_badField, (void *)prec,
+                          "devScanStats: Illegal INP/OUT field");
+        goto bad;
+    }
+    parm = plink->value.instio.string;
+    while (*parm == ' ') parm++;
+
+    for (i = 0; i < nchannels; i++) {
+        len = strlen(channels[i].name);
+        if (!epicsStrnCaseCmp(parm, channels[i].name, len) &&
+            parm[len] == ' ')
+            break;
+    }
+    if (i == nchannels) {
+        recGblRecordError(S_db_badField, (void *)prec, func);
+        goto bad;
+    }
+    parm += len;
+    while (*parm == ' ') parm++;
+
+    for (scan = SCAN_1ST_PERIODIC; pmenu && scan < pmenu->nChoice; scan++) {
+        if (!epicsStrCaseCmp(parm, pmenu->papChoiceValue[scan])) {
+            devPvt *pdevPvt = calloc(1, sizeof(devPvt));
+
+            if (!pdevPvt) break;
+            pdevPvt->scan = scan;
+            pdevPvt->offset = channels[i].offset;
+            prec->dpvt = pdevPvt;
+            /* The slowest record is only found on demand */
+            if (pdevPvt->offset == offsetof(scanStats, slowest) ||
+                pdevPvt->offset == offsetof(scanStats, slowestTime))
+                scanStatsSlowest = 1;
+            return 0;
+        }
+    }
+
+    recGblRecordError(S_db_badField, (void *)prec,
+                      "devScanStats: Unknown periodic scan rate");
+bad:
+    prec->pact = TRUE;
+    prec->dpvt = NULL;
+    return S_db_badField;
+}
+
+static long get_ioint_info(int cmd, dbCommon *prec, IOSCANPVT *ppvt)
+{
+    devPvt *pdevPvt = (devPvt *)prec->dpvt;
+
+    if (!pdevPvt) return -1;
+
+    *ppvt = scanStatsIoScan(pdevPvt->scan);
+    return 0;
+}
+
+static const scanStats * get_stats(dbCommon *prec, scanStats *pstats)
+{
+    devPvt *pdevPvt = (devPvt *)prec->dpvt;
+
+    if (!pdevPvt || scanStatsGet(pdevPvt->scan, pstats)) {
+        recGblSetSevr(prec, READ_ALARM, INVALID_ALARM);
+        return NULL;
+    }
+    return pstats;
+}
+
+
+/********* ai record **********/
+static struct channel ai_channels[] = {
+    {"PERIOD", offsetof(scanStats, period)},
+    {"LAST", offsetof(scanStats, last)},
+    {"MEAN", offsetof(scanStats, mean)},
+    {"MAX", offsetof(scanStats, max)},
+    {"SLOWTIME", offsetof(scanStats, slowestTime)},
+};
+
+static long init_ai(aiRecord *prec)
+{
+    return init_common((dbCommon *)prec, &prec->inp,
+        ai_channels, NELEMENTS(ai_channels),
+        "devAiScanStats::init_ai: Bad parm");
+}
+
+static long read_ai(aiRecord *prec)
+{
+    scanStats stats;
+    const scanStats *pstats = get_stats((dbCommon *)prec, &stats);
+
+    if (!pstats) return -1;
+
+    prec->val = *(const double *)
+        ((const char *)pstats + ((devPvt *)prec->dpvt)->offset);
+    prec->udf = FALSE;
+    return 2;
+}
+
+struct {
+    dset common;
+    DEVSUPFUN read_write;
+    DEVSUPFUN special_linconv;
+} devAiScanStats = {
+    {6, NULL, NULL, init_ai, get_ioint_info}, read_ai,  NULL
+};
+epicsExportAddress(dset, devAiScanStats);
+
+
+/********* bo record **********/
+static struct channel bo_channels[] = {
+    {"RESET", 0},
+};
+
+static long init_bo(boRecord *prec)
+{
+    long status = init_common((dbCommon *)prec, &prec->out,
+        bo_channels, NELEMENTS(bo_channels),
+        "devBoScanStats::init_bo: Bad parm");
+
+    if (status) return status;
+    prec->mask = 0;
+    return 2;
+}
+
+static long write_bo(boRecord *prec)
+{
+    devPvt *pdevPvt = (devPvt *)prec->dpvt;
+
+    if (!pdevPvt) return -1;
+
+    scanStatsReset(pdevPvt->scan);
+    return 0;
+}
+
+struct {
+    dset common;
+    DEVSUPFUN read_write;
+} devBoScanStats = {
+    {5, NULL, NULL, init_bo, NULL}, write_bo
+};
+epicsExportAddress(dset, devBoScanStats);
+
+
+/******* longin record *************/
+static struct channel li_channels[] = {
+    {"PASSES", offsetof(scanStats, passes)},
+    {"OVERRUNS", offsetof(scanStats, overruns)},
+};
+
+static long init_li(longinRecord *prec)
+{
+    return init_common((dbCommon *)prec, &prec->inp,
+        li_channels, NELEMENTS(li_channels),
+        "devLiScanStats::init_li: Bad parm");
+}
+
+static long read_li(longinRecord *prec)
+{
+    scanStats stats;
+    const scanStats *pstats = get_stats((dbCommon *)prec, &stats);
+
+    if (!pstats) return -1;
+
+    prec->val = *(const unsigned long *)
+        ((const char *)pstats + ((devPvt *)prec->dpvt)->offset);
+    return 0;
+}
+
+struct {
+    dset common;
+    DEVSUPFUN read_write;
+} devLiScanStats = {
+    {5, NULL, NULL, init_li, get_ioint_info}, read_li
+};
+epicsExportAddress(dset, devLiScanStats);
+
+
+/********** stringin record **********/
+static struct channel si_channels[] = {
+    {"SLOWEST", offsetof(scanStats, slowest)},
+};
+
+static long init_si(stringinRecord *prec)
+{
+    return init_common((dbCommon *)prec, &prec->inp,
+        si_channels, NELEMENTS(si_channels),
+        "devSiScanStats::init_si: Bad parm");
+}
+
+static long read_si(stringinRecord *prec)
+{
+    scanStats stats;
+    const scanStats *pstats = get_stats((dbCommon *)prec, &stats);
+
+    if (!pstats) return -1;
+
+    strncpy(prec->val, pstats->slowest, sizeof(prec->val));
+    prec->val[sizeof(prec->val) - 1] = '\0';
+    prec->udf = FALSE;
+    return 0;
+}
+
+struct {
+    dset common;
+    DEVSUPFUN read_write;
+} devSiScanStats = {
+    {5, NULL, NULL, init_si, get_ioint_info}, read_si
+};
+epicsExportAddress(dset, devSiScanStats);
+
+
+/********** waveform record **********/
+static struct channel wf_channels[] = {
+    {"HIST", offsetof(scanStats, histogram)},
+};
+
+static long init_wf(waveformRecord *prec)
+{
+    if (prec->ftvl != DBF_LONG && prec->ftvl != DBF_ULONG &&
+        prec->ftvl != DBF_DOUBLE) {
+        recGblRecordError(S_db_badField, (void *)prec,
+                          "devWfScanStats::init_wf: Illegal FTVL field");
+        prec->pact = TRUE;
+        return S_db_badField;
+    }
+    return init_common((dbCommon *)prec, &prec->inp,
+        wf_channels, NELEMENTS(wf_channels),
+        "devWfScanStats::init_wf: Bad parm");
+}
+
+static long read_wf(waveformRecord *prec)
+{
+    scanStats stats;
+    const scanStats *pstats = get_stats((dbCommon *)prec, &stats);
+    epicsUInt32 n = prec->nelm;
+    epicsUInt32 i;
+
+    if (!pstats) return -1;
+
+    if (n > SCAN_STATS_BINS) n = SCAN_STATS_BINS;
+    for (i = 0; i < n; i++) {
+        if (prec->ftvl == DBF_DOUBLE)
+            ((epicsFloat64 *)prec->bptr)[i] = pstats->histogram[i];
+        else
+            ((epicsUInt32 *)prec->bptr)[i] = pstats->histogram[i];
+    }
+    prec->nord = n;
+    prec->udf = FALSE;
+    return 0;
+}
+
+struct {
+    dset common;
+    DEVSUPFUN read_write;
+} devWfScanStats = {
+    {5, NULL, NULL, init_wf, get_ioint_info}, read_wf
+};
+epicsExportAddress(dset, devWfScanStats);
@@ -0,0 +1,216 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests the CA server with its clients served by a reactor worker,
+ * using a CA client in the same process. The CA server can't be
+ * stopped again, so this test doesn't shut its IOC down.
+ */
+
+#include <string.h>
+
+#include "cadef.h"
+#include "db_access_routines.h"
+#include "dbUnitTest.h"
+#include "envDefs.h"
+#include "epicsAtomic.h"
+#include "epicsEvent.h"
+#include "epicsThread.h"
+#include "epicsTime.h"
+#include "errlog.h"
+#include "iocInit.h"
+#include "rsrv.h"
+#include "shareLib.h"
+
+#include "testMain.h"
+
+epicsShareExtern int rsrvReactorThreads;
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+#if defined(__linux__)
+
+static int nMonitors;
+static int lastMonitor;
+static int nPuts;
+static int putStatus[2];
+static epicsEventId putDone;
+
+static void monitorCB(struct event_handler_args args)
+{
+    if (args.status == ECA_NORMAL)
+        epicsAtomicSetIntT(&lastMonitor, (int) *(const double *) args.dbr);
+    epicsAtomicIncrIntT(&nMonitors);
+}
+
+/* A client that is slow to take its monitors */
+static void slowMonitorCB(struct event_handler_args args)
+{
+    epicsThreadSleep(0.01);
+}
+
+static void putCB(struct event_handler_args args)
+{
+    int *pstatus = (int *) args.usr;
+
+    *pstatus = args.status;
+    epicsAtomicIncrIntT(&nPuts);
+    epicsEventMustTrigger(putDone);
+}
+
+/* Wait up to 5 seconds for *pvalue to reach value */
+static int waitFor(int *pvalue, int value)
+{
+    int i;
+
+    for (i = 0; i < 500 && epicsAtomicGetIntT(pvalue) != value; i++)
+        epicsThreadSleep(0.01);
+    return epicsAtomicGetIntT(pvalue) == value;
+}
+
+static unsigned clientCount(void)
+{
+    unsigned channels, clients;
+
+    casStatsFetch(&channels, &clients);
+    return clients;
+}
+
+MAIN(caReactorTest)
+{
+    struct ca_client_context *context, *gone;
+    chid chVal, chSlow, chPrio, chGone;
+    evid subscription;
+    epicsTimeStamp start, now;
+    double value, got;
+    unsigned clients;
+    int i, status;
+
+    testPlan(11);
+
+    epicsEnvSet("EPICS_CA_ADDR_LIST", "127.0.0.1");
+    epicsEnvSet("EPICS_CA_AUTO_ADDR_LIST", "NO");
+    epicsEnvSet("EPICS_CAS_INTF_ADDR_LIST", "127.0.0.1");
+    rsrvReactorThreads = 1;
+
+    /* Contexts created after iocInit() would bypass the server */
+    ca_context_create(ca_enable_preemptive_callback);
+    gone = ca_current_context();
+    ca_detach_context();
+    ca_context_create(ca_enable_preemptive_callback);
+    context = ca_current_context();
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("caReactorTest.db", NULL, NULL);
+
+    eltc(0);
+    if (iocInit())
+        testAbort("Failed to start up test database");
+    eltc(1);
+    putDone = epicsEventMustCreate(epicsEventEmpty);
+
+    ca_create_channel("val", NULL, NULL, CA_PRIORITY_DEFAULT, &chVal);
+    ca_create_channel("slow", NULL, NULL, CA_PRIORITY_DEFAULT, &chSlow);
+    /* A different priority gets its own circuit */
+    ca_create_channel("val", NULL, NULL, CA_PRIORITY_DEFAULT + 1, &chPrio);
+    testOk(ca_pend_io(5.0) == ECA_NORMAL, "Channels connected");
+
+    testDiag("Get and put");
+    value = 1.5;
+    ca_put(DBR_DOUBLE, chVal, &value);
+    ca_get(DBR_DOUBLE, chVal, &got);
+    status = ca_pend_io(5.0);
+    testOk(status == ECA_NORMAL && got == value, "Got %g", got);
+
+    testDiag("Monitor");
+    ca_create_subscription(DBR_DOUBLE, 1, chVal, DBE_VALUE, monitorCB, NULL,
+        &subscription);
+    ca_flush_io();
+    testOk(waitFor(&nMonitors, 1), "Initial monitor");
+    for (i = 10; i < 20; i++) {
+        value = i;
+        ca_put(DBR_DOUBLE, chVal, &value);
+        ca_flush_io();
+        epicsThreadSleep(0.01);
+    }
+    testOk(waitFor(&lastMonitor, 19), "Monitors up to %d after %d updates",
+        lastMonitor, nMonitors);
+
+    testDiag("Put callbacks queued behind an asynchronous record");
+    value = 1;
+    ca_put_callback(DBR_DOUBLE, chSlow, &value, putCB, &putStatus[0]);
+    value = 2;
+    ca_put_callback(DBR_DOUBLE, chSlow, &value, putCB, &putStatus[1]);
+    ca_flush_io();
+    /* the only worker now waits for the first put to complete */
+    epicsThreadSleep(0.1);
+    epicsTimeGetCurrent(&start);
+    ca_get(DBR_DOUBLE, chPrio, &got);
+    status = ca_pend_io(5.0);
+    epicsTimeGetCurrent(&now);
+    testOk(status == ECA_NORMAL && epicsTimeDiffInSeconds(&now, &start) < 0.3,
+        "Other circuit served in %.3f sec",
+        epicsTimeDiffInSeconds(&now, &start));
+    for (i = 0; i < 10 && epicsAtomicGetIntT(&nPuts) < 2; i++)
+        epicsEventWaitWithTimeout(putDone, 1.0);
+    testOk(nPuts == 2 && putStatus[0] == ECA_NORMAL &&
+        putStatus[1] == ECA_NORMAL, "Both put callbacks completed");
+    ca_get(DBR_DOUBLE, chSlow, &got);
+    status = ca_pend_io(5.0);
+    testOk(status == ECA_NORMAL && got == 2, "Got %g", got);
+
+    testDiag("Disconnect a client with monitors queued");
+    clients = clientCount();
+    ca_detach_context();
+    ca_attach_context(gone);
+    ca_create_channel("val", NULL, NULL, CA_PRIORITY_DEFAULT, &chGone);
+    testOk(ca_pend_io(5.0) == ECA_NORMAL && clientCount() == clients + 1,
+        "Second client connected, %u clients", clientCount());
+    ca_create_subscription(DBR_DOUBLE, 1, chGone, DBE_VALUE, slowMonitorCB,
+        NULL, &subscription);
+    ca_flush_io();
+    epicsThreadSleep(0.1);
+    ca_detach_context();
+    ca_attach_context(context);
+    for (i = 100; i < 300; i++) {
+        value = i;
+        ca_put(DBR_DOUBLE, chVal, &value);
+    }
+    ca_flush_io();
+    epicsThreadSleep(0.1);
+    ca_detach_context();
+    ca_attach_context(gone);
+    ca_context_destroy();
+    ca_attach_context(context);
+
+    for (i = 0; i < 500 && clientCount() != clients; i++)
+        epicsThreadSleep(0.01);
+    testOk(clientCount() == clients, "Second client gone, %u clients",
+        clientCount());
+    testOk(waitFor(&lastMonitor, 299), "First client monitors up to %d",
+        lastMonitor);
+    value = 300;
+    ca_put(DBR_DOUBLE, chVal, &value);
+    ca_get(DBR_DOUBLE, chVal, &got);
+    status = ca_pend_io(5.0);
+    testOk(status == ECA_NORMAL && got == 300, "Got %g", got);
+
+    ca_context_destroy();
+    epicsEventDestroy(putDone);
+    return testDone();
+}
+
+#else /* __linux__ */
+
+MAIN(caReactorTest)
+{
+    testPlan(1);
+    testSkip(1, "rsrvReactorThreads needs epoll");
+    return testDone();
+}
+
+#endif /* __linux__ */
@@ -15,6 +15,7 @@
 int analogMonitorTest(void);
 int arrayOpTest(void);
 int scanEventTest(void);
+int scanStatsTest(void);
 
 void epicsRunRecordTests(void)
 {
@@ -26,5 +27,7 @@ void epicsRunRecordTests(void)
 
     runTest(scanEventTest);
 
+    runTest(scanStatsTest);
+
     epicsExit(0);   /* Trigger test harness */
 }
@@ -0,0 +1,77 @@
+/*************************************************************************\
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests the "Scan Stats" device support
+ */
+
+#include <string.h>
+
+#include "dbAccess.h"
+#include "dbScan.h"
+#include "dbUnitTest.h"
+#include "epicsThread.h"
+#include "errlog.h"
+#include "menuScan.h"
+
+#include "testMain.h"
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(scanStatsTest)
+{
+    epicsInt32 hist[SCAN_STATS_BINS + 1];
+    epicsInt32 passes;
+    long nreq, i, sum;
+    scanStats stats;
+    DBADDR addr;
+
+    testPlan(12);
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("scanStatsTest.db", NULL, NULL);
+
+    scanStatsSlowest = 0;
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testOk(scanStatsSlowest == 1, "Loading SLOWTIME enables scanStatsSlowest");
+    testdbGetFieldEqual("badItem.PACT", DBR_LONG, 1);
+    testdbGetFieldEqual("badScan.PACT", DBR_LONG, 1);
+
+    testDiag("I/O Intr records update after each pass");
+    epicsThreadSleep(0.5);
+    testdbGetFieldEqual("period", DBR_DOUBLE, 0.1);
+    testdbGetFieldEqual("period.UDF", DBR_LONG, 0);
+    if (dbNameToAddr("passes", &addr) ||
+        dbGetField(&addr, DBR_LONG, &passes, NULL, NULL, NULL))
+        testAbort("Can't read passes");
+    testOk(passes >= 3, "%d passes", passes);
+
+    testDiag("Passive records update when processed");
+    testdbPutFieldOk("slowest.PROC", DBR_LONG, 1);
+    testdbGetFieldEqual("slowest", DBR_STRING, "tick");
+    testdbPutFieldOk("hist.PROC", DBR_LONG, 1);
+    nreq = NELEMENTS(hist);
+    if (dbNameToAddr("hist", &addr) ||
+        dbGetField(&addr, DBR_LONG, hist, NULL, &nreq, NULL))
+        testAbort("Can't read hist");
+    for (sum = 0, i = 0; i < nreq; i++)
+        sum += hist[i];
+    testOk(nreq == SCAN_STATS_BINS && sum >= passes,
+        "Histogram has %ld bins holding %ld passes", nreq, sum);
+
+    testDiag("Reset the statistics");
+    testdbPutFieldOk("reset", DBR_LONG, 1);
+    scanStatsGet(menuScan_1_second, &stats);
+    testOk(stats.passes <= 1, "Reset leaves %lu passes", stats.passes);
+
+    testIocShutdownOk();
+    testdbCleanup();
+    return testDone();
+}